@@ -0,0 +1,152 @@
+/* pokertools - tools for poker related coding
+ * Copyright (C) 2016 Andriy Lysnevych
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+/**
+ * Card abstraction of flop or turn: every canonical (hole cards, board)
+ * situation is put to a bucket of situations with similar distributions of
+ * river hand strength against uniform opponent range. Building works in stages
+ * that can be run and checked separately:
+ *
+ *     StrengthDistributions distributions = calculateStrengthDistributions(4, 30);
+ *     std::vector<uint16_t> buckets = clusterStrengthDistributions(distributions, 200);
+ *     writeAbstractionFile("turn.bin", distributions, buckets, 200);
+ *
+ *     AbstractionTable table("turn.bin");
+ *     unsigned bucket = table.getBucket(holeCards, board);
+ *
+ * File is little-endian: AbstractionFileHeader, then uint16_t bucket of every
+ * situation indexed by getCanonicalSituationIndex (NoBucket for situations
+ * that aren't canonical or weren't clustered).
+ */
+
+#pragma once
+
+#include "poker.hpp"
+#include "mappedfile.hpp"
+
+#include <vector>
+#include <string>
+
+namespace pokertools
+{
+    static constexpr uint32_t AbstractionFileVersion = 1;
+    static constexpr uint16_t NoBucket = 0xFFFF;
+
+    struct AbstractionFileHeader {
+        char magic[8];            // "PTABSTRC"
+        uint32_t version;         // AbstractionFileVersion
+        uint32_t headerSize;      // sizeof(AbstractionFileHeader), payload starts after it
+        uint32_t boardCardsCount; // 3 for flop, 4 for turn
+        uint32_t bucketsCount;
+        uint32_t situationsCount; // Canonical boards count * HoleCardsCombinationsCount
+        uint32_t reserved;
+        uint64_t payloadSize;
+        uint64_t checksum;        // FNV-1a 64 of payload
+        uint8_t padding[16];      // Aligns payload to 64 bytes
+    };
+
+    static_assert(sizeof(AbstractionFileHeader) == 64, "AbstractionFileHeader should be exactly 64 bytes");
+
+    /**
+     * Histograms of river strength of canonical situations. Strength on every
+     * runout is share of opponent hole cards beaten (ties are counted as half),
+     * and histogram i has binsCount numbers of runouts starting at
+     * histograms[i * binsCount], runoutsCount in total.
+     */
+    struct StrengthDistributions {
+        unsigned boardCardsCount;
+        unsigned binsCount;
+        unsigned runoutsCount;
+        std::vector<uint32_t> situationIndexes; // getCanonicalSituationIndex of every situation
+        std::vector<uint32_t> weights;          // Number of situations isomorphic to every canonical one
+        std::vector<uint16_t> histograms;
+    };
+
+    /**
+     * Stage 1. Distributions of all canonical situations on canonical boards
+     * with given indexes (all boards of street when empty). Every runout of
+     * every board is evaluated once for all hole cards and strengths of all of
+     * them are found by one sweep over sorted values that accounts for card
+     * removal. Boards are split to threads (0 means number of hardware threads).
+     *
+     * Throws std::invalid_argument if number of board cards isn't 3 or 4, number
+     * of bins is 0 or board index is out of range.
+     */
+    extern StrengthDistributions calculateStrengthDistributions(unsigned boardCardsCount, unsigned binsCount, unsigned threadsCount = 0,
+                                                                const std::vector<unsigned>& boardIndexes = std::vector<unsigned>());
+
+    /**
+     * Stage 2. Weighted k-means of distributions with earth mover's distance,
+     * which is L1 distance of cumulative histograms in one dimension. Centers
+     * are initialized by k-means++ on sample of distributions chosen by seed and
+     * are means of their distributions, empty clusters are reseeded with
+     * distributions chosen by seed. Stops after iterationsCount iterations or when no
+     * assignment changes. Returns bucket of every distribution, result depends
+     * only on arguments and not on number of threads.
+     *
+     * Throws std::invalid_argument if number of buckets is 0, exceeds number of
+     * distributions or NoBucket.
+     */
+    extern std::vector<uint16_t> clusterStrengthDistributions(const StrengthDistributions& distributions, unsigned bucketsCount,
+                                                              unsigned iterationsCount = 50, uint64_t seed = 0, unsigned threadsCount = 0);
+
+    /**
+     * Stage 3. Writes buckets returned by clusterStrengthDistributions to
+     * file. Throws std::runtime_error on I/O errors.
+     */
+    extern void writeAbstractionFile(const std::string& fileName, const StrengthDistributions& distributions, const std::vector<uint16_t>& buckets,
+                                     unsigned bucketsCount);
+
+    /**
+     * Abstraction file mapped by MappedFile. Bucket lookup needs only
+     * canonicalization of situation and reads of the mapping.
+     */
+    class AbstractionTable
+    {
+    public:
+        explicit AbstractionTable(const std::string& fileName, bool verifyChecksum = true);
+        AbstractionTable(AbstractionTable&& other) noexcept = default;
+        AbstractionTable& operator=(AbstractionTable&& other) noexcept = default;
+
+        AbstractionTable(const AbstractionTable&) = delete;
+        AbstractionTable& operator=(const AbstractionTable&) = delete;
+
+        /**
+         * Bucket of any (not canonical) situation on board of the street, or
+         * NoBucket if its board wasn't clustered. Takes canonicalization and
+         * two table lookups.
+         */
+        unsigned getBucket(Hand holeCards, Hand board) const;
+
+        inline unsigned getBoardCardsCount() const noexcept
+        {
+            return boardCardsCount;
+        }
+
+        inline unsigned getBucketsCount() const noexcept
+        {
+            return bucketsCount;
+        }
+
+    private:
+        MappedFile file;
+        unsigned boardCardsCount;
+        unsigned bucketsCount;
+        const uint16_t* buckets;
+    };
+}
@@ -0,0 +1,226 @@
+/* pokertools - tools for poker related coding
+ * Copyright (C) 2016 Andriy Lysnevych
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+#pragma once
+
+#include "poker.hpp"
+
+#include <iterator>
+#include <cstddef>
+
+namespace pokertools
+{
+    // Binomial coefficient for n up to CardsCount, intermediate products fit in 64 bits
+    inline constexpr uint64_t getBinomial(unsigned n, unsigned k) noexcept
+    {
+        if (k > n) {
+            return 0;
+        }
+
+        uint64_t result = 1;
+
+        for (unsigned i = 0; i < k; i++) {
+            result = result * (n - i) / (i + 1);
+        }
+
+        return result;
+    }
+
+    /**
+     * Range of k cards combinations of arbitrary live cards (e.g. FullDeck
+     * without dead cards). Combinations are ordered colexicographically by
+     * positions of cards among live cards, so rank of combination doesn't
+     * depend on gaps between suits in Hand. Range holds no memory and may be
+     * used in constant expressions.
+     *
+     * Range is split to parts by ranks, so threads enumerating parts with the
+     * same index get the same combinations regardless of scheduling:
+     *
+     *     CardsCombinations boards(FullDeck & ~deadCards, 5);
+     *     for (Hand board : boards.getPart(threadIndex, threadsCount)) { ... }
+     */
+    class CardsCombinations
+    {
+    public:
+        class Iterator
+        {
+        public:
+            using iterator_category = std::input_iterator_tag;
+            using value_type = Hand;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const Hand*;
+            using reference = Hand;
+
+            constexpr Iterator(uint64_t liveCards, uint64_t combination, uint64_t remainingCount) noexcept
+                : liveCards(liveCards), combination(combination), remainingCount(remainingCount)
+            {
+            }
+
+            constexpr Hand operator*() const noexcept
+            {
+                return combination;
+            }
+
+            /**
+             * Gosper's hack over live cards: carry of adding the lowest card
+             * passes through run of selected cards and non-live bits, the
+             * remaining cards of the run move to the lowest live cards.
+             */
+            constexpr Iterator& operator++() noexcept
+            {
+                uint64_t lowest = combination & (~combination + 1);
+                uint64_t next = ((combination | ~liveCards) + lowest) & liveCards;
+                unsigned runCount = countCards(combination & ~next);
+                uint64_t rest = liveCards;
+
+                for (unsigned i = 1; i < runCount; i++) {
+                    rest &= rest - 1;
+                }
+
+                combination = next | (liveCards ^ rest);
+                remainingCount--;
+
+                return *this;
+            }
+
+            constexpr bool operator==(const Iterator& other) const noexcept
+            {
+                return remainingCount == other.remainingCount;
+            }
+
+            constexpr bool operator!=(const Iterator& other) const noexcept
+            {
+                return remainingCount != other.remainingCount;
+            }
+
+        private:
+            uint64_t liveCards;
+            uint64_t combination;
+            uint64_t remainingCount;
+        };
+
+        constexpr CardsCombinations(Hand liveCards, unsigned cardsCount) noexcept
+            : liveCards(liveCards), liveCardsCount(countCards(liveCards)), cardsCount(cardsCount), beginRank(0),
+              endRank(getBinomial(countCards(liveCards), cardsCount))
+        {
+        }
+
+        // Combinations with ranks from beginRank to endRank - 1
+        constexpr CardsCombinations(Hand liveCards, unsigned cardsCount, uint64_t beginRank, uint64_t endRank) noexcept
+            : liveCards(liveCards), liveCardsCount(countCards(liveCards)), cardsCount(cardsCount), beginRank(beginRank), endRank(endRank)
+        {
+            assert((beginRank <= endRank) && (endRank <= getBinomial(liveCardsCount, cardsCount)));
+        }
+
+        constexpr uint64_t size() const noexcept
+        {
+            return endRank - beginRank;
+        }
+
+        constexpr uint64_t getBeginRank() const noexcept
+        {
+            return beginRank;
+        }
+
+        constexpr uint64_t getEndRank() const noexcept
+        {
+            return endRank;
+        }
+
+        constexpr Iterator begin() const noexcept
+        {
+            return Iterator(liveCards, (size() != 0) ? static_cast<uint64_t>(unrank(beginRank)) : 0, size());
+        }
+
+        constexpr Iterator end() const noexcept
+        {
+            return Iterator(liveCards, 0, 0);
+        }
+
+        /**
+         * Part partIndex of partsCount parts of nearly equal sizes. Parts are
+         * consecutive, don't overlap and cover the whole range.
+         */
+        constexpr CardsCombinations getPart(unsigned partIndex, unsigned partsCount) const noexcept
+        {
+            assert(partIndex < partsCount);
+            return CardsCombinations(liveCards, cardsCount, getPartBeginRank(partIndex, partsCount), getPartBeginRank(partIndex + 1, partsCount));
+        }
+
+        // Keeps the first half of range and returns the second one
+        constexpr CardsCombinations split() noexcept
+        {
+            uint64_t middleRank = beginRank + size() / 2;
+            CardsCombinations secondHalf(liveCards, cardsCount, middleRank, endRank);
+            endRank = middleRank;
+
+            return secondHalf;
+        }
+
+        // Colexicographic rank of combination of cardsCount live cards
+        constexpr uint64_t rank(Hand combination) const noexcept
+        {
+            assert((countCards(combination) == cardsCount) && ((combination & ~liveCards) == 0));
+            uint64_t bits = combination;
+            uint64_t result = 0;
+
+            for (unsigned i = 1; bits != 0; i++, bits &= bits - 1) {
+                uint64_t card = bits & (~bits + 1);
+                result += getBinomial(countCards(liveCards & (card - 1)), i);
+            }
+
+            return result;
+        }
+
+        constexpr Hand unrank(uint64_t rank) const noexcept
+        {
+            assert(rank < getBinomial(liveCardsCount, cardsCount));
+            uint64_t result = 0;
+            uint64_t rest = liveCards;
+            unsigned position = liveCardsCount;
+
+            for (unsigned i = cardsCount; i > 0; i--) {
+                uint64_t card = 0;
+
+                do {
+                    position--;
+                    card = uint64_t(1) << (63 - __builtin_clzll(rest));
+                    rest ^= card;
+                } while (getBinomial(position, i) > rank);
+
+                result |= card;
+                rank -= getBinomial(position, i);
+            }
+
+            return result;
+        }
+
+    private:
+        uint64_t liveCards;
+        unsigned liveCardsCount;
+        unsigned cardsCount;
+        uint64_t beginRank;
+        uint64_t endRank;
+
+        // The first size() % partsCount parts have one more combination, bound has no product that could overflow
+        constexpr uint64_t getPartBeginRank(uint64_t partIndex, unsigned partsCount) const noexcept
+        {
+            return beginRank + size() / partsCount * partIndex + ((partIndex < size() % partsCount) ? partIndex : size() % partsCount);
+        }
+    };
+}
@@ -0,0 +1,90 @@
+/* pokertools - tools for poker related coding
+ * Copyright (C) 2016 Andriy Lysnevych
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+#pragma once
+
+#include "poker.hpp"
+
+#include <vector>
+
+namespace pokertools
+{
+    static constexpr unsigned MaxOpponentsCount = 9;
+    static constexpr Hand UnknownHoleCards = 0;
+
+    struct EquityResult {
+        uint64_t winCount;  // Number of deals where hero wins whole pot
+        uint64_t tieCount;  // Number of deals where hero splits pot
+        uint64_t loseCount; // Number of deals where hero loses
+        double equity;      // Average hero share of the pot in range [0, 1], ties are counted by share
+    };
+
+    struct MonteCarloOptions {
+        uint64_t maxTrialsCount = 1000000;
+        double targetStandardError = 0; // Stop when standard error of equity drops to this value, 0 disables early stop
+        unsigned threadsCount = 0;      // 0 means number of hardware threads
+        uint64_t seed = 0;
+    };
+
+    struct MonteCarloEquityResult : EquityResult {
+        uint64_t trialsCount;
+        double standardError;
+    };
+
+    struct WeightedHoleCards {
+        Hand holeCards;
+        double weight;
+    };
+
+    struct RangeEquityResult {
+        double equity;               // Hero range equity, every matchup is weighted by product of combinations weights
+        std::vector<double> equities; // Equity of every hero range combination, 0 if it can't be dealt
+    };
+
+    /**
+     * Exact hero equity against opponents on board with 0 to 5 cards. Every
+     * remaining board runout and every possible holding of opponents with
+     * UnknownHoleCards is enumerated, so cost grows fast with number of unknown
+     * opponents and missing board cards.
+     *
+     * Throws std::invalid_argument if cards overlap or have invalid count.
+     */
+    extern EquityResult enumerateEquity(Hand heroHoleCards, const Hand* opponentsHoleCards, unsigned opponentsCount, Hand board, Hand deadCards = 0);
+
+    /**
+     * Estimates hero equity with same arguments as enumerateEquity by dealing
+     * random runouts and unknown opponents hole cards. Trials are split into
+     * fixed size batches with own random streams derived from seed, so result
+     * depends only on options.seed and not on number of threads. Early stop is
+     * checked after fixed groups of batches.
+     */
+    extern MonteCarloEquityResult simulateEquity(Hand heroHoleCards, const Hand* opponentsHoleCards, unsigned opponentsCount, Hand board, Hand deadCards = 0,
+                                                 const MonteCarloOptions& options = MonteCarloOptions());
+
+    /**
+     * Exact equity of hero range against villain range on board with 0 to 5
+     * cards. For every runout each combination is evaluated once and matchups
+     * are resolved by sweep over combinations sorted by value that accounts for
+     * card removal. Runouts equivalent under suit permutations preserving board,
+     * dead cards and both ranges are evaluated once.
+     *
+     * Throws std::invalid_argument if combinations are invalid or repeated.
+     */
+    extern RangeEquityResult calculateRangeEquity(const std::vector<WeightedHoleCards>& heroRange, const std::vector<WeightedHoleCards>& villainRange,
+                                                  Hand board, Hand deadCards = 0, unsigned threadsCount = 0);
+}
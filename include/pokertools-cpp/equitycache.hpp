@@ -0,0 +1,105 @@
+/* pokertools - tools for poker related coding
+ * Copyright (C) 2016 Andriy Lysnevych
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+/**
+ * Cache of exact equities of hero hole cards against unknown opponents on
+ * flop, turn or river. Situations are keyed by suit isomorphism class, so all
+ * isomorphic queries share one entry. Lookups go through two tiers:
+ *
+ * - in-memory LRU split to independently locked shards,
+ * - optional append-only file of results memory mapped read-only, so worker
+ *   processes share results computed by any of them. Records are appended
+ *   by single write calls with O_APPEND and verified by checksums, so torn
+ *   records of crashed writers are skipped.
+ *
+ * Misses are computed by enumerateEquity and stored in both tiers.
+ */
+
+#pragma once
+
+#include "equity.hpp"
+
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace pokertools
+{
+    struct EquityCacheStatistics {
+        uint64_t memoryHits;
+        uint64_t fileHits;
+        uint64_t misses;
+    };
+
+    class EquityCache
+    {
+    public:
+        /**
+         * memoryCapacity is maximum number of results in memory tier. Empty
+         * fileName disables file tier. Throws std::runtime_error if file
+         * can't be opened or isn't equity cache file.
+         */
+        explicit EquityCache(size_t memoryCapacity = 1 << 20, const std::string& fileName = std::string(), unsigned shardsCount = 16);
+        ~EquityCache();
+
+        EquityCache(const EquityCache&) = delete;
+        EquityCache& operator=(const EquityCache&) = delete;
+
+        /**
+         * Same as enumerateEquity(heroHoleCards, opponents, opponentsCount, board)
+         * with UnknownHoleCards opponents and board of 3 to 5 cards. Thread safe.
+         */
+        EquityResult getEquity(Hand heroHoleCards, unsigned opponentsCount, Hand board);
+
+        EquityCacheStatistics getStatistics() const noexcept;
+
+    private:
+        struct Shard {
+            std::mutex mutex;
+            std::list<std::pair<uint64_t, EquityResult>> entries; // Most recently used first
+            std::unordered_map<uint64_t, std::list<std::pair<uint64_t, EquityResult>>::iterator> positions;
+        };
+
+        bool findInMemory(uint64_t key, EquityResult& result);
+        void addToMemory(uint64_t key, const EquityResult& result);
+        bool findInFile(uint64_t key, EquityResult& result);
+        void addToFile(uint64_t key, const EquityResult& result);
+        bool findFileRecord(uint64_t key, EquityResult& result) const;
+        void indexFileRecords(size_t fileSize);
+
+        size_t shardCapacity;
+        std::vector<std::unique_ptr<Shard>> shards;
+
+        std::mutex fileMutex; // Serializes appends of this process
+        std::shared_timed_mutex fileIndexMutex; // Guards mapping and index, lookups share it
+        int fileDescriptor;
+        const uint8_t* fileMapping;
+        std::atomic<size_t> fileMappingSize; // Compared without lock before mapping file again
+        size_t fileIndexedSize; // Records before this offset are in fileRecordsOffsets
+        std::unordered_map<uint64_t, size_t> fileRecordsOffsets;
+
+        std::atomic<uint64_t> memoryHits;
+        std::atomic<uint64_t> fileHits;
+        std::atomic<uint64_t> misses;
+    };
+}
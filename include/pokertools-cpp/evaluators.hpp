@@ -22,30 +22,260 @@
 
 #include <memory>
 #include <functional>
+#include <cstddef>
 
 namespace pokertools
 {
     static constexpr unsigned BitsArraySize = 0b1111111000000 + 1;
     static constexpr unsigned HigUpTo3BitsArraySize = 0b1111100000000 + 1;
-    static constexpr unsigned InternalTablesBufferSize = sizeof(uint8_t) * BitsArraySize + sizeof(uint16_t) * (HigUpTo3BitsArraySize + 3 * BitsArraySize);
+    static constexpr unsigned GatherPaddingSize = sizeof(uint16_t); // SIMD gathers read 32 bits from 16-bit tables
+    static constexpr unsigned InternalTablesBufferSize = sizeof(uint8_t) * BitsArraySize + sizeof(uint16_t) * (HigUpTo3BitsArraySize + 4 * BitsArraySize) + GatherPaddingSize;
 
-    extern void initializeEvaluator(std::unique_ptr<uint8_t, std::function<void(uint8_t*)>> internalTablesBuffer) noexcept;
+    enum class InstructionSet : unsigned {
+        Scalar,
+        Avx2,
+        Avx512
+    };
 
+    using InternalTablesBuffer = std::unique_ptr<uint8_t, std::function<void(uint8_t*)>>;
+
+    /**
+     * Allocates InternalTablesBufferSize bytes buffer for evaluator tables
+     * by allocator (e.g. NUMA local or huge pages one).
+     */
     template<typename Allocator = std::allocator<uint8_t>>
-    extern void initializeEvaluator(const Allocator& allocatorForInternalTables = Allocator())
+    InternalTablesBuffer createInternalTablesBuffer(const Allocator& allocatorForInternalTables = Allocator())
     {
         Allocator allocator(allocatorForInternalTables);
 
-        initializeEvaluator(std::unique_ptr<uint8_t, std::function<void(uint8_t*)>>(
+        return InternalTablesBuffer(
             allocator.allocate(InternalTablesBufferSize),
             [allocator] (uint8_t* pointer) mutable {
                 allocator.deallocate(pointer, InternalTablesBufferSize);
-            }));
+            });
+    }
+
+    /**
+     * Evaluators use lookup tables generated at compile time and need no
+     * initialization. Functions below optionally copy tables to custom buffer
+     * (e.g. allocated in NUMA local or huge pages memory) and use that copy
+     * until deinitializeEvaluator is called. They change the default Evaluator
+     * used by free evaluation functions, so they must not run concurrently with
+     * evaluations. Use own Evaluator objects to change tables safely.
+     *
+     * Omaha, BoardContext and ace-to-five low evaluators (also low part of
+     * evaluateHiLoHand) and generation of PerfectHash tables always read
+     * compile time generated tables, neither copied tables nor own Evaluator
+     * objects affect them.
+     */
+    extern void initializeEvaluator(InternalTablesBuffer internalTablesBuffer) noexcept;
+
+    template<typename Allocator = std::allocator<uint8_t>>
+    extern void initializeEvaluator(const Allocator& allocatorForInternalTables = Allocator())
+    {
+        initializeEvaluator(createInternalTablesBuffer(allocatorForInternalTables));
     }
 
     extern void deinitializeEvaluator();
 
+    enum class EvaluatorEngine : unsigned {
+        Branching,   // Compact tables with branches depending on hand type
+        PerfectHash, // About 420KB of tables indexed by perfect hash of hand
+        Packed       // Branching with one 16KB table of 4-bit fields per ranks mask
+    };
+
+    /**
+     * Selects engine of evaluateHoldem7CardsHand. All engines return the same
+     * values. PerfectHash engine builds its tables here and keeps them until
+     * other engine is selected or deinitializeEvaluator is called.
+     */
+    extern void initializeEvaluatorEngine(EvaluatorEngine engine);
+    extern EvaluatorEngine getEvaluatorEngine() noexcept;
+
     extern uint32_t evaluateHoldem7CardsHand(Hand hand) noexcept;
+    extern uint32_t evaluateHoldem6CardsHand(Hand hand) noexcept;
     extern uint32_t evaluateHoldem5CardsHand(Hand hand) noexcept;
     extern uint32_t evaluateHoldemHand(Hand hand, unsigned cardsCount) noexcept;
+
+    /**
+     * Short Deck (6+) Hold'em evaluators. Hands must not have cards of ranks 2 to 5.
+     * A-6-7-8-9 is the lowest straight and Flush beats Full House, so hand type
+     * of returned values is ShortDeckHandType. Values are comparable only with
+     * values of other Short Deck evaluators.
+     */
+    extern uint32_t evaluateShortDeck7CardsHand(Hand hand) noexcept;
+    extern uint32_t evaluateShortDeck5CardsHand(Hand hand) noexcept;
+    extern uint32_t evaluateShortDeckHand(Hand hand, unsigned cardsCount) noexcept;
+
+    /**
+     * Hold'em 5 cards board preprocessed once to evaluate many hole cards
+     * against it with less work than evaluateHoldem7CardsHand.
+     */
+    struct BoardContext {
+        Hand board;
+        uint16_t ranksByCount[4]; // ranksByCount[i] has ranks present on board at least i + 1 times
+        uint8_t suitsCounts[SuitsCount];
+        uint8_t flushSuit; // Suit with at least 3 board cards or SuitsCount if flush is impossible
+        uint16_t flushSuitRanks;
+        bool isStraightPossible; // Some straight has at least 3 ranks on board
+    };
+
+    extern BoardContext createBoardContext(Hand board) noexcept;
+
+    /**
+     * Values are the same as of evaluateHoldem7CardsHand(board | holeCards).
+     */
+    extern uint32_t evaluateWithBoard(const BoardContext& context, Hand holeCards) noexcept;
+
+    /**
+     * Fills HoleCardsCombinationsCount values indexed by getHoleCardsIndex.
+     * Values of hole cards intersecting with board are 0.
+     */
+    extern void evaluateAllWithBoard(const BoardContext& context, uint32_t* values) noexcept;
+
+    /**
+     * Evaluates Omaha hand that must use exactly 2 of holeCardsCount (4 to 6)
+     * hole cards and exactly 3 of 3 to 5 board cards. Returns value with the same
+     * encoding as Hold'em evaluators.
+     */
+    extern uint32_t evaluateOmahaHand(Hand holeCards, Hand board, unsigned holeCardsCount) noexcept;
+
+    /**
+     * Lowball evaluators. Values are comparable like ones of high evaluators:
+     * greater value is better low hand. Hand type field of low value is
+     * HandType::StraightFulsh minus hand type of the low, e.g. High Card low
+     * beats any paired low.
+     *
+     * Ace to Five: Ace is low, straights and flushes don't count. 5 to 7 cards.
+     * Deuce to Seven: Ace is high, straights and flushes count. 5 cards.
+     * Eight or Better: Ace to Five low of five distinct ranks from Ace to Eight,
+     * 0 when hand doesn't qualify. 5 to 7 cards.
+     */
+    extern uint32_t evaluateAceToFiveLowHand(Hand hand, unsigned cardsCount) noexcept;
+    extern uint32_t evaluateDeuceToSevenLowHand(Hand hand) noexcept;
+    extern uint32_t evaluateEightOrBetterLowHand(Hand hand) noexcept;
+
+    /**
+     * Omaha Eight or Better low made of exactly 2 hole cards and 3 board cards,
+     * 0 when hand doesn't qualify.
+     */
+    extern uint32_t evaluateOmahaEightOrBetterLowHand(Hand holeCards, Hand board, unsigned holeCardsCount) noexcept;
+
+    struct HiLoValues {
+        uint32_t high;
+        uint32_t low; // Eight or Better low, 0 when there is no low
+    };
+
+    /**
+     * Hi-Lo split evaluators (Stud/Hold'em and Omaha Eight or Better) that
+     * evaluate high and low in one pass over the cards.
+     */
+    extern HiLoValues evaluateHiLoHand(Hand hand, unsigned cardsCount) noexcept;
+    extern HiLoValues evaluateOmahaHiLoHand(Hand holeCards, Hand board, unsigned holeCardsCount) noexcept;
+
+    static constexpr unsigned HandValuesCount = 7462; // Distinct values of Hold'em evaluators
+
+    /**
+     * Dense ordinal of Hold'em evaluator value from 0 (7-5-4-3-2 high card) to
+     * HandValuesCount - 1 (royal flush). Ordinals compare like values, so they
+     * index small arrays (e.g. strength histograms) instead of maps of values.
+     * Value must be returned by Hold'em or Omaha high evaluator.
+     */
+    extern unsigned convertValueToOrdinal(uint32_t value) noexcept;
+    extern uint32_t convertOrdinalToValue(unsigned ordinal) noexcept;
+    extern void convertValuesToOrdinals(const uint32_t* values, uint16_t* ordinals, size_t count) noexcept;
+
+    /**
+     * Best instruction set supported by current CPU that batch evaluators can use.
+     */
+    extern InstructionSet getSupportedInstructionSet() noexcept;
+
+    /**
+     * Evaluates count 7 cards hands and stores their values (same as returned by
+     * evaluateHoldem7CardsHand) to values. Uses best supported instruction set.
+     */
+    extern void evaluateHoldem7CardsHands(const Hand* hands, uint32_t* values, size_t count) noexcept;
+
+    /**
+     * Same as above but uses specified instruction set. It must be supported by current CPU.
+     */
+    extern void evaluateHoldem7CardsHands(const Hand* hands, uint32_t* values, size_t count, InstructionSet instructionSet) noexcept;
+
+    /**
+     * Same as above for 6 cards hands (values as returned by evaluateHoldem6CardsHand).
+     */
+    extern void evaluateHoldem6CardsHands(const Hand* hands, uint32_t* values, size_t count) noexcept;
+    extern void evaluateHoldem6CardsHands(const Hand* hands, uint32_t* values, size_t count, InstructionSet instructionSet) noexcept;
+
+    namespace perfecthash
+    {
+        struct Tables;
+    }
+
+    /**
+     * Evaluator that owns its tables. Methods are the same as free evaluation
+     * functions with the same names, which use the default Evaluator. Each
+     * NUMA node or thread pool may hold its own Evaluator with tables in local
+     * memory, and destroying one Evaluator doesn't affect evaluations by others.
+     * Evaluation methods are thread safe, other methods are not. Evaluators
+     * without methods here read compile time generated tables (see above).
+     */
+    class Evaluator
+    {
+    public:
+        Evaluator() noexcept; // Uses compile time generated tables
+        explicit Evaluator(InternalTablesBuffer internalTablesBuffer) noexcept; // Copies tables to buffer
+        Evaluator(Evaluator&& other) noexcept;
+        Evaluator& operator=(Evaluator&& other) noexcept;
+        ~Evaluator();
+
+        Evaluator(const Evaluator&) = delete;
+        Evaluator& operator=(const Evaluator&) = delete;
+
+        void initializeEngine(EvaluatorEngine engine);
+        EvaluatorEngine getEngine() const noexcept;
+
+        uint32_t evaluateHoldem7CardsHand(Hand hand) const noexcept;
+        uint32_t evaluateHoldem6CardsHand(Hand hand) const noexcept;
+        uint32_t evaluateHoldem5CardsHand(Hand hand) const noexcept;
+        uint32_t evaluateHoldemHand(Hand hand, unsigned cardsCount) const noexcept;
+
+        uint32_t evaluateShortDeck7CardsHand(Hand hand) const noexcept;
+        uint32_t evaluateShortDeck5CardsHand(Hand hand) const noexcept;
+        uint32_t evaluateShortDeckHand(Hand hand, unsigned cardsCount) const noexcept;
+
+        uint32_t evaluateDeuceToSevenLowHand(Hand hand) const noexcept;
+        HiLoValues evaluateHiLoHand(Hand hand, unsigned cardsCount) const noexcept;
+
+        void evaluateHoldem7CardsHands(const Hand* hands, uint32_t* values, size_t count) const noexcept;
+        void evaluateHoldem7CardsHands(const Hand* hands, uint32_t* values, size_t count, InstructionSet instructionSet) const noexcept;
+        void evaluateHoldem6CardsHands(const Hand* hands, uint32_t* values, size_t count) const noexcept;
+        void evaluateHoldem6CardsHands(const Hand* hands, uint32_t* values, size_t count, InstructionSet instructionSet) const noexcept;
+
+    private:
+        friend void initializeEvaluator(InternalTablesBuffer internalTablesBuffer) noexcept;
+
+        uint32_t evaluate7CardsHand(Hand hand, const uint16_t* straights) const noexcept;
+        uint32_t evaluate7CardsHandPacked(Hand hand) const noexcept;
+        uint32_t evaluate6CardsHand(Hand hand, const uint16_t* straights) const noexcept;
+        uint32_t evaluateFlush(uint16_t flushRanks, const uint16_t* straights) const noexcept;
+        uint32_t evaluate5CardsHand(Hand hand, const uint16_t* straights) const noexcept;
+        uint32_t evaluateHand(Hand hand, unsigned cardsCount, const uint16_t* straights) const noexcept;
+
+        // SIMD kernels are the same for 5 to 7 cards, evaluateHand handles hands left after the last vector
+        void evaluateHoldemHands(uint32_t (Evaluator::*evaluateHand)(Hand hand) const, const Hand* hands, uint32_t* values, size_t count,
+                                 InstructionSet instructionSet) const noexcept;
+
+        void useBuiltinTables() noexcept;
+
+        const uint8_t* numberOfBits;
+        const uint16_t* rankOfStraights;
+        const uint16_t* highUpTo5Bits;
+        const uint16_t* highBit;
+        const uint16_t* highUpTo3Bits;
+        const uint16_t* packedRanks;
+        EvaluatorEngine engine;
+        InternalTablesBuffer buffer; // Null when compile time generated tables are used
+        std::unique_ptr<perfecthash::Tables> perfectHashTables; // Not null when PerfectHash engine is selected
+    };
 }
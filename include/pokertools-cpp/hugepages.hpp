@@ -0,0 +1,76 @@
+/* pokertools - tools for poker related coding
+ * Copyright (C) 2016 Andriy Lysnevych
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+/**
+ * Allocator of memory backed by 2MB huge pages to reduce TLB misses of
+ * lookup tables, e.g. initializeEvaluator<HugePagesAllocator<uint8_t>>().
+ *
+ * On Linux it maps reserved huge pages (MAP_HUGETLB) and falls back to 2MB
+ * aligned mapping advised for transparent huge pages (MADV_HUGEPAGE) when none
+ * are reserved. Every allocation takes whole huge pages, so it is intended for
+ * few large long living buffers. Other systems use regular allocation.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+namespace pokertools
+{
+    static constexpr size_t HugePageSize = 2 * 1024 * 1024;
+
+    // Throws std::bad_alloc when memory can't be mapped
+    extern void* allocateHugePages(size_t size);
+    extern void deallocateHugePages(void* pointer, size_t size) noexcept;
+
+    template<typename T>
+    class HugePagesAllocator
+    {
+    public:
+        using value_type = T;
+
+        HugePagesAllocator() noexcept = default;
+
+        template<typename U>
+        HugePagesAllocator(const HugePagesAllocator<U>&) noexcept
+        {
+        }
+
+        T* allocate(size_t count)
+        {
+            return static_cast<T*>(allocateHugePages(count * sizeof(T)));
+        }
+
+        void deallocate(T* pointer, size_t count) noexcept
+        {
+            deallocateHugePages(pointer, count * sizeof(T));
+        }
+    };
+
+    template<typename T, typename U>
+    inline bool operator==(const HugePagesAllocator<T>&, const HugePagesAllocator<U>&) noexcept
+    {
+        return true;
+    }
+
+    template<typename T, typename U>
+    inline bool operator!=(const HugePagesAllocator<T>&, const HugePagesAllocator<U>&) noexcept
+    {
+        return false;
+    }
+}
@@ -0,0 +1,135 @@
+/* pokertools - tools for poker related coding
+ * Copyright (C) 2016 Andriy Lysnevych
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+/**
+ * Card by card Hold'em evaluator for nested enumeration loops. State of
+ * partial hand is an offset in transition table, so adding a card costs one
+ * lookup and outer loops reuse states of their cards:
+ *
+ *     uint32_t holeState = evaluator.addCards(IncrementalEvaluator::InitialState, holeCards);
+ *     for (...) { uint32_t flopState = evaluator.addCard(holeState, card1) ... }
+ *
+ * States keep number of cards of every rank and ranks of suits that can still
+ * make a flush, so they don't depend on order of cards. Adding the 7th card
+ * gives value equal to evaluateHoldem7CardsHand of the hand.
+ *
+ * File is little-endian: IncrementalEvaluatorFileHeader, then IncrementalStatesCount
+ * states of IncrementalStateSize uint32_t entries. Entry 0 of state is value of
+ * 5 or 6 cards hand (0 for less cards), entry 1 + card number is state with
+ * added card (value of hand for 6 cards states, 0 if card can't be added).
+ */
+
+#pragma once
+
+#include "poker.hpp"
+#include "mappedfile.hpp"
+
+#include <vector>
+#include <string>
+
+namespace pokertools
+{
+    static constexpr uint32_t IncrementalEvaluatorFileVersion = 1;
+    static constexpr uint32_t IncrementalStateSize = CardsCount + 1;
+    static constexpr uint32_t IncrementalStatesCount = 612977; // Of 0 to 6 cards, about 130MB of transitions
+
+    struct IncrementalEvaluatorFileHeader {
+        char magic[8];       // "PTINCREV"
+        uint32_t version;    // IncrementalEvaluatorFileVersion
+        uint32_t headerSize; // sizeof(IncrementalEvaluatorFileHeader), payload starts after it
+        uint32_t statesCount; // IncrementalStatesCount
+        uint32_t stateSize;  // IncrementalStateSize
+        uint64_t payloadSize;
+        uint64_t checksum;   // FNV-1a 64 of payload
+        uint8_t padding[24]; // Aligns payload to 64 bytes
+    };
+
+    static_assert(sizeof(IncrementalEvaluatorFileHeader) == 64, "IncrementalEvaluatorFileHeader should be exactly 64 bytes");
+
+    /**
+     * Generates transition table of IncrementalStatesCount * IncrementalStateSize
+     * entries. Takes seconds and about 130MB of memory.
+     */
+    extern std::vector<uint32_t> generateIncrementalEvaluatorTable();
+
+    /**
+     * Writes table returned by generateIncrementalEvaluatorTable to file.
+     * Throws std::runtime_error on I/O errors.
+     */
+    extern void writeIncrementalEvaluatorFile(const std::string& fileName, const std::vector<uint32_t>& table);
+
+    class IncrementalEvaluator
+    {
+    public:
+        static constexpr uint32_t InitialState = 0;
+
+        // Maps file written by writeIncrementalEvaluatorFile by MappedFile
+        explicit IncrementalEvaluator(const std::string& fileName, bool verifyChecksum = true);
+
+        // Uses table returned by generateIncrementalEvaluatorTable without file
+        explicit IncrementalEvaluator(std::vector<uint32_t> table);
+
+        IncrementalEvaluator(IncrementalEvaluator&& other) noexcept = default;
+        IncrementalEvaluator& operator=(IncrementalEvaluator&& other) noexcept = default;
+
+        IncrementalEvaluator(const IncrementalEvaluator&) = delete;
+        IncrementalEvaluator& operator=(const IncrementalEvaluator&) = delete;
+
+        // Card must not be in state. Returns value when state has 6 cards.
+        inline uint32_t addCard(uint32_t state, unsigned cardNumber) const noexcept
+        {
+            assert(cardNumber < CardsCount);
+            return entries[state + 1 + cardNumber];
+        }
+
+        inline uint32_t addCard(uint32_t state, Card card) const noexcept
+        {
+            return addCard(state, getCardNumber(card));
+        }
+
+        // Cards must not be in state and total number of cards must be at most 7
+        inline uint32_t addCards(uint32_t state, Hand cards) const noexcept
+        {
+            for (uint64_t bits = cards; bits != 0; bits &= bits - 1) {
+                state = addCard(state, static_cast<Card>(bits & (~bits + 1)));
+            }
+
+            return state;
+        }
+
+        // Value of state with 5 or 6 cards
+        inline uint32_t getValue(uint32_t state) const noexcept
+        {
+            return entries[state];
+        }
+
+        // Same as evaluateHoldemHand(hand, cardsCount) for 5 to 7 cards
+        inline uint32_t evaluateHand(Hand hand, unsigned cardsCount) const noexcept
+        {
+            assert((cardsCount >= 5) && (cardsCount <= 7) && (countCards(hand) == cardsCount));
+            uint32_t state = addCards(InitialState, hand);
+
+            return (cardsCount == 7) ? state : getValue(state);
+        }
+
+    private:
+        MappedFile file; // Maps nothing when table is held in memory
+        std::vector<uint32_t> table;
+        const uint32_t* entries;
+    };
+}
@@ -0,0 +1,115 @@
+/* pokertools - tools for poker related coding
+ * Copyright (C) 2016 Andriy Lysnevych
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+/**
+ * Suit isomorphism: situations that differ only by renaming of suits have the
+ * same strategy and equity, so jobs can work on canonical representatives
+ * (e.g. 1755 flops instead of 22100) and weight results by class sizes.
+ *
+ * Canonical form sorts the four 16-bit suit lanes of Hand in descending order
+ * of (board ranks, hole cards ranks), so the suit with most significant board
+ * cards becomes Clubs.
+ */
+
+#pragma once
+
+#include "poker.hpp"
+
+namespace pokertools
+{
+    static constexpr unsigned SuitsPermutationsCount = 24;
+    static constexpr unsigned CanonicalFlopsCount = 1755;
+    static constexpr unsigned CanonicalTurnsCount = 16432;   // Boards of 4 cards, order of cards doesn't matter
+    static constexpr unsigned CanonicalRiversCount = 134459; // Boards of 5 cards
+
+    struct CanonicalForm {
+        Hand holeCards;
+        Hand board;
+        Suit permutation[SuitsCount]; // Canonical suit of every original suit, as accepted by permuteSuits
+        unsigned weight;              // Number of different situations isomorphic to canonical one, from 1 to 24
+    };
+
+    inline CanonicalForm canonicalize(Hand holeCards, Hand board) noexcept
+    {
+        assert((holeCards & board) == 0);
+
+        // Board ranks, hole cards ranks and original suit of every lane
+        uint64_t keys[SuitsCount];
+
+        for (unsigned suit = 0; suit < SuitsCount; suit++) {
+            keys[suit] = (static_cast<uint64_t>(board.suit(static_cast<Suit>(suit))) << 32) |
+                         (static_cast<uint64_t>(holeCards.suit(static_cast<Suit>(suit))) << 16) | suit;
+        }
+
+        // Sorting network of 4 lanes in descending order
+        auto compareAndSwap = [&keys] (unsigned first, unsigned second) {
+            if (keys[first] < keys[second]) {
+                std::swap(keys[first], keys[second]);
+            }
+        };
+
+        compareAndSwap(0, 1);
+        compareAndSwap(2, 3);
+        compareAndSwap(0, 2);
+        compareAndSwap(1, 3);
+        compareAndSwap(1, 2);
+
+        CanonicalForm result;
+        uint64_t canonicalHoleCards = 0;
+        uint64_t canonicalBoard = 0;
+        unsigned stabilizerSize = 1; // Number of permutations that keep canonical form
+        unsigned equalLanesCount = 1;
+
+        for (unsigned i = 0; i < SuitsCount; i++) {
+            canonicalBoard |= (keys[i] >> 32) << SuitSizeInBits * i;
+            canonicalHoleCards |= ((keys[i] >> 16) & 0xFFFF) << SuitSizeInBits * i;
+            result.permutation[keys[i] & 0xFFFF] = static_cast<Suit>(i);
+
+            equalLanesCount = ((i > 0) && ((keys[i] >> 16) == (keys[i - 1] >> 16))) ? (equalLanesCount + 1) : 1;
+            stabilizerSize *= equalLanesCount;
+        }
+
+        result.holeCards = canonicalHoleCards;
+        result.board = canonicalBoard;
+        result.weight = SuitsPermutationsCount / stabilizerSize;
+
+        return result;
+    }
+
+    // Canonical form of one set of cards is returned as board
+    inline CanonicalForm canonicalize(Hand cards) noexcept
+    {
+        return canonicalize(0, cards);
+    }
+
+    /**
+     * Dense index of canonical form of board with 3 to 5 cards, from 0 to
+     * CanonicalFlopsCount, CanonicalTurnsCount or CanonicalRiversCount - 1.
+     * Index tables of every street are built on first use (about 10MB for river).
+     */
+    extern unsigned getCanonicalBoardIndex(Hand board);
+    extern Hand getCanonicalBoard(unsigned index, unsigned cardsCount);
+
+    /**
+     * Index of isomorphism class of (hole cards, board) pair usable as cache key:
+     * getCanonicalBoardIndex * HoleCardsCombinationsCount + getHoleCardsIndex of
+     * canonical hole cards. Unique for every class, but not dense because not
+     * every hole cards are canonical.
+     */
+    extern uint32_t getCanonicalSituationIndex(Hand holeCards, Hand board);
+}
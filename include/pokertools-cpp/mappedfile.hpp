@@ -0,0 +1,76 @@
+/* pokertools - tools for poker related coding
+ * Copyright (C) 2016 Andriy Lysnevych
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+/**
+ * Read-only memory mapping of whole data file, shared by tables precomputed
+ * to files (PreflopEquityTable, IncrementalEvaluator, AbstractionTable), so
+ * processes share pages of the file and loading needs no parsing.
+ *
+ * Such file starts with 64 bytes header (magic, version, header size, counts
+ * specific to table, payload size and FNV-1a checksum of payload) followed by
+ * payload, all little-endian. Mapping isn't converted, so library doesn't
+ * compile for big-endian targets. Tables constructed from file name throw
+ * std::runtime_error if file can't be mapped or has other size, format,
+ * version or checksum. Checksum verification reads whole file and may be
+ * skipped for trusted files.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace pokertools
+{
+    // 64-bit FNV-1a hash of payloads of data files and of equity cache file records
+    extern uint64_t calculateFileChecksum(const uint8_t* data, size_t size) noexcept;
+
+    class MappedFile
+    {
+    public:
+        MappedFile() noexcept;
+
+        /**
+         * Maps file of size from minimumSize to maximumSize bytes. Throws
+         * std::runtime_error mentioning fileDescription (e.g. "preflop equity")
+         * if file can't be opened or mapped or has other size.
+         */
+        MappedFile(const std::string& fileName, const char* fileDescription, uint64_t minimumSize, uint64_t maximumSize = UINT64_MAX);
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        inline const uint8_t* getData() const noexcept
+        {
+            return static_cast<const uint8_t*>(mapping);
+        }
+
+        inline size_t getSize() const noexcept
+        {
+            return mappingSize;
+        }
+
+    private:
+        void* mapping; // Null when nothing is mapped
+        size_t mappingSize;
+    };
+}
@@ -0,0 +1,82 @@
+/* pokertools - tools for poker related coding
+ * Copyright (C) 2016 Andriy Lysnevych
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+/**
+ * Optional hardware performance counters of the calling thread (Linux
+ * perf_event_open) to find why some evaluator or hand type is slow: cycles,
+ * instructions, branch misses, L1 data cache and data TLB read misses.
+ *
+ * Counters are compiled in only when POKERTOOLS_PERF_COUNTERS is defined for
+ * both the library and its users (CMake option POKERTOOLS_PERF_COUNTERS).
+ * Otherwise PerfCounters is an empty class with inline no-op functions.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace pokertools
+{
+    struct PerfCountersValues {
+        uint64_t cycles = 0;
+        uint64_t instructions = 0;
+        uint64_t branchMisses = 0;
+        uint64_t l1dReadMisses = 0;
+        uint64_t dtlbReadMisses = 0;
+    };
+
+#ifdef POKERTOOLS_PERF_COUNTERS
+    class PerfCounters {
+    public:
+        PerfCounters() noexcept;
+        ~PerfCounters();
+
+        PerfCounters(const PerfCounters&) = delete;
+        PerfCounters& operator=(const PerfCounters&) = delete;
+
+        // False when kernel doesn't allow counters (see /proc/sys/kernel/perf_event_paranoid) or CPU has none.
+        // Single counters unsupported by CPU are reported as 0.
+        bool isAvailable() const noexcept;
+
+        void start() noexcept;
+        PerfCountersValues stop() noexcept;
+
+    private:
+        static constexpr unsigned CountersCount = 5;
+
+        int fileDescriptors[CountersCount];
+    };
+#else
+    class PerfCounters {
+    public:
+        bool isAvailable() const noexcept
+        {
+            return false;
+        }
+
+        void start() noexcept
+        {
+        }
+
+        PerfCountersValues stop() noexcept
+        {
+            return PerfCountersValues();
+        }
+    };
+#endif
+}
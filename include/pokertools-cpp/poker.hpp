@@ -21,6 +21,8 @@
 #include <cstdint>
 #include <cassert>
 #include <stdexcept>
+#include <utility>
+#include <algorithm>
 
 namespace pokertools
 {
@@ -121,12 +123,12 @@ namespace pokertools
 
         constexpr Hand(uint64_t value) noexcept : _bits(value)
         {
-            assert((bits & 0b1110000000000000111000000000000011100000000000001110000000000000) == 0);
+            assert((_bits & 0b1110000000000000111000000000000011100000000000001110000000000000) == 0);
         }
 
         constexpr Hand(Card card) noexcept : _bits(static_cast<uint64_t>(card))
         {
-            assert((bits & 0b1110000000000000111000000000000011100000000000001110000000000000) == 0);
+            assert((_bits & 0b1110000000000000111000000000000011100000000000001110000000000000) == 0);
         }
 
         inline constexpr operator uint64_t() const noexcept
@@ -152,6 +154,19 @@ namespace pokertools
         StraightFulsh
     };
 
+    // Hand types order of Short Deck (6+) Hold'em where Flush beats Full House
+    enum class ShortDeckHandType : unsigned {
+        HighCard,
+        Pair,
+        TwoPair,
+        ThreeOfAKind,
+        Straight,
+        FullHouse,
+        Flush,
+        FourOfAKind,
+        StraightFulsh
+    };
+
     union EvaluateResult {
         uint32_t value;
 
@@ -260,6 +275,94 @@ namespace pokertools
     constexpr Card queen_spades = 12_spades;
     constexpr Card jack_spades = 11_spades;
 
+    constexpr Hand FullDeck = 0b0001111111111111000111111111111100011111111111110001111111111111;
+
+    inline constexpr unsigned countCards(Hand hand) noexcept
+    {
+        uint64_t bits = hand;
+        unsigned count = 0;
+
+        for (; bits != 0; bits &= bits - 1) {
+            count++;
+        }
+
+        return count;
+    }
+
+    // Number of card as accepted by createCard(unsigned)
+    inline unsigned getCardNumber(Card card) noexcept
+    {
+        unsigned bitIndex = __builtin_ctzll(static_cast<uint64_t>(card));
+        return (bitIndex / SuitSizeInBits) * RanksCount + bitIndex % SuitSizeInBits;
+    }
+
+    constexpr unsigned HoleCardsCombinationsCount = CardsCount * (CardsCount - 1) / 2;
+
+    /**
+     * Dense index of 2 hole cards from 0 to HoleCardsCombinationsCount - 1.
+     * Combinations are ordered colexicographically by card numbers, so index
+     * of cards first < second is second * (second - 1) / 2 + first.
+     */
+    inline unsigned getHoleCardsIndex(Hand holeCards) noexcept
+    {
+        assert(countCards(holeCards) == 2);
+        uint64_t bits = holeCards;
+        unsigned first = getCardNumber(static_cast<Card>(bits & (~bits + 1)));
+        unsigned second = getCardNumber(static_cast<Card>(bits & (bits - 1)));
+
+        if (first > second) {
+            std::swap(first, second);
+        }
+
+        return second * (second - 1) / 2 + first;
+    }
+
+    inline Hand getHoleCardsByIndex(unsigned index) noexcept
+    {
+        assert(index < HoleCardsCombinationsCount);
+        unsigned second = 1;
+
+        while ((second + 1) * second / 2 <= index) {
+            second++;
+        }
+
+        return createCard(index - second * (second - 1) / 2) | createCard(second);
+    }
+
+    constexpr unsigned StartingHandsCount = RanksCount * RanksCount;
+
+    /**
+     * Index of 169 starting hands (hole cards up to suits) from 0 to
+     * StartingHandsCount - 1. For ranks numbers high >= low (0 is deuce)
+     * pairs are high * 13 + high, suited hands high * 13 + low and offsuit
+     * hands low * 13 + high.
+     */
+    inline unsigned getStartingHandIndex(Hand holeCards) noexcept
+    {
+        assert(countCards(holeCards) == 2);
+        uint64_t bits = holeCards;
+        unsigned first = getCardNumber(static_cast<Card>(bits & (~bits + 1)));
+        unsigned second = getCardNumber(static_cast<Card>(bits & (bits - 1)));
+        unsigned highRank = std::max(first % RanksCount, second % RanksCount);
+        unsigned lowRank = std::min(first % RanksCount, second % RanksCount);
+
+        return (first / RanksCount == second / RanksCount) ? (highRank * RanksCount + lowRank) : (lowRank * RanksCount + highRank);
+    }
+
+    /**
+     * Moves cards of every suit s to suit permutation[s].
+     */
+    inline Hand permuteSuits(Hand hand, const Suit* permutation) noexcept
+    {
+        uint64_t result = 0;
+
+        for (unsigned suit = 0; suit < SuitsCount; suit++) {
+            result |= static_cast<uint64_t>(hand.suit(static_cast<Suit>(suit))) << SuitSizeInBits * static_cast<unsigned>(permutation[suit]);
+        }
+
+        return result;
+    }
+
     static_assert(sizeof(Hand) == 8, "Hand should be exactly 64 bits");
     static_assert(sizeof(EvaluateResult) == 4, "EvaluateResult should be exactly 32 bits");
 }
@@ -0,0 +1,117 @@
+/* pokertools - tools for poker related coding
+ * Copyright (C) 2016 Andriy Lysnevych
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+/**
+ * Exact heads-up preflop all-in equities of all 1326 x 1326 hole cards
+ * matchups and 169 x 169 starting hands, precomputed to a file once and
+ * memory mapped by services, so lookups need no computation or parsing.
+ *
+ * File is little-endian: PreflopEquityFileHeader, then HoleCardsCombinationsCount^2
+ * uint32_t hero shares indexed by getHoleCardsIndex of hero * 1326 + villain,
+ * then StartingHandsCount^2 double equities indexed by getStartingHandIndex
+ * the same way. Share is 2 for every won board and 1 for every split board.
+ */
+
+#pragma once
+
+#include "poker.hpp"
+#include "mappedfile.hpp"
+
+#include <vector>
+#include <string>
+#include <utility>
+
+namespace pokertools
+{
+    static constexpr uint32_t PreflopEquityFileVersion = 1;
+    static constexpr uint32_t PreflopBoardsCount = 1712304; // 5 cards boards of 48 cards
+    static constexpr uint32_t PreflopMaxShare = 2 * PreflopBoardsCount;
+
+    struct PreflopEquityFileHeader {
+        char magic[8];               // "PTPREFLP"
+        uint32_t version;            // PreflopEquityFileVersion
+        uint32_t headerSize;         // sizeof(PreflopEquityFileHeader), payload starts after it
+        uint32_t combinationsCount;  // HoleCardsCombinationsCount
+        uint32_t startingHandsCount; // StartingHandsCount
+        uint32_t maxShare;           // PreflopMaxShare
+        uint32_t reserved;
+        uint64_t payloadSize;
+        uint64_t checksum;           // FNV-1a 64 of payload
+        uint8_t padding[16];         // Aligns payload to 64 bytes
+    };
+
+    static_assert(sizeof(PreflopEquityFileHeader) == 64, "PreflopEquityFileHeader should be exactly 64 bytes");
+
+    /**
+     * Enumerates all boards of every matchup that differs up to suits
+     * permutation and returns HoleCardsCombinationsCount^2 hero shares
+     * (0 for overlapping hole cards). Takes tens of CPU minutes, threadsCount
+     * 0 means number of hardware threads.
+     *
+     * Non-empty matchups (pairs of hero and villain hole cards) restrict
+     * enumeration to classes of these matchups, shares of other matchups are 0.
+     * Throws std::invalid_argument if hole cards of matchup overlap.
+     */
+    extern std::vector<uint32_t> calculatePreflopEquityShares(unsigned threadsCount = 0,
+                                                              const std::vector<std::pair<Hand, Hand>>& matchups = std::vector<std::pair<Hand, Hand>>());
+
+    /**
+     * Writes shares returned by calculatePreflopEquityShares and starting hands
+     * equities derived from them to file. Throws std::runtime_error on I/O errors.
+     */
+    extern void writePreflopEquityFile(const std::string& fileName, const std::vector<uint32_t>& shares);
+
+    /**
+     * Preflop equity file mapped by MappedFile. Every lookup is one read of
+     * share or equity from the mapping.
+     */
+    class PreflopEquityTable
+    {
+    public:
+        explicit PreflopEquityTable(const std::string& fileName, bool verifyChecksum = true);
+        PreflopEquityTable(PreflopEquityTable&& other) noexcept = default;
+        PreflopEquityTable& operator=(PreflopEquityTable&& other) noexcept = default;
+
+        PreflopEquityTable(const PreflopEquityTable&) = delete;
+        PreflopEquityTable& operator=(const PreflopEquityTable&) = delete;
+
+        // Hole cards must not overlap
+        inline uint32_t getShare(Hand heroHoleCards, Hand villainHoleCards) const noexcept
+        {
+            assert((heroHoleCards & villainHoleCards) == 0);
+            return shares[getHoleCardsIndex(heroHoleCards) * HoleCardsCombinationsCount + getHoleCardsIndex(villainHoleCards)];
+        }
+
+        inline double getEquity(Hand heroHoleCards, Hand villainHoleCards) const noexcept
+        {
+            return static_cast<double>(getShare(heroHoleCards, villainHoleCards)) / PreflopMaxShare;
+        }
+
+        // Average equity of all not overlapping combinations of starting hands
+        inline double getStartingHandsEquity(unsigned heroStartingHandIndex, unsigned villainStartingHandIndex) const noexcept
+        {
+            assert((heroStartingHandIndex < StartingHandsCount) && (villainStartingHandIndex < StartingHandsCount));
+            return startingHandsEquities[heroStartingHandIndex * StartingHandsCount + villainStartingHandIndex];
+        }
+
+    private:
+        MappedFile file;
+        const uint32_t* shares;
+        const double* startingHandsEquities;
+    };
+}
@@ -0,0 +1,186 @@
+/* pokertools - tools for poker related coding
+ * Copyright (C) 2016 Andriy Lysnevych
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+/**
+ * Heads-up river subgame solver. Tree has bets and raises of given pot
+ * fractions, and CFR+ (regret matching+, alternating updates and linearly
+ * weighted average strategy) updates all hole cards of acting player at once
+ * with loops over contiguous arrays of hands. Showdowns take O(N + M) per
+ * node: both ranges are sorted by evaluateHoldem7CardsHand values once and
+ * swept with per card sums of opponent reach to exclude hands sharing cards.
+ *
+ *     RiverSubgame subgame;
+ *     subgame.board = ...;
+ *     subgame.ranges[0] = ...;
+ *     subgame.ranges[1] = ...;
+ *     subgame.pot = 100;
+ *     subgame.stack = 400;
+ *     subgame.betSizes = { 0.5, 1 };
+ *
+ *     RiverSolver solver(subgame);
+ *     RiverSolverResult result = solver.solve(1000, 0.005 * subgame.pot, 0.05);
+ *     std::vector<double> strategy = solver.getStrategy(solver.getRootNode(), holeCards);
+ */
+
+#pragma once
+
+#include "poker.hpp"
+#include "equity.hpp"
+
+#include <vector>
+
+namespace pokertools
+{
+    enum class RiverActionType {
+        Fold,
+        Check,
+        Call,
+        Bet,
+        Raise
+    };
+
+    struct RiverAction {
+        RiverActionType type;
+        double amount; // Chips put on river by acting player in total after action
+    };
+
+    struct RiverSubgame {
+        Hand board;
+        std::vector<WeightedHoleCards> ranges[2]; // Player 0 acts first
+        double pot;                               // Chips in pot before river
+        double stack;                             // Effective stack at start of river
+        std::vector<double> betSizes;             // Fractions of pot
+        std::vector<double> raiseSizes;           // Fractions of pot after call
+        unsigned maxRaisesCount = 1;
+        bool allowAllIn = true;                   // All-in is added to bets and raises
+    };
+
+    struct RiverSolverResult {
+        unsigned iterationsCount; // Total of all solve calls
+        double exploitability;    // Chips
+        double seconds;           // Time of last solve call
+    };
+
+    class RiverSolver
+    {
+    public:
+        /**
+         * Builds tree and sorts ranges. Hands sharing cards with board or with
+         * zero weight are dropped. Throws std::invalid_argument if board doesn't
+         * have 5 cards, hands aren't 2 cards or repeat, weights or sizes are
+         * negative, pot isn't positive or no hands of ranges can meet.
+         */
+        explicit RiverSolver(const RiverSubgame& subgame);
+
+        /**
+         * Runs CFR+ iterations until maxIterationsCount iterations of this call,
+         * exploitability at most targetExploitability chips (checked every few
+         * iterations when positive) or secondsBudget seconds (when positive).
+         * Can be called again to continue solving.
+         */
+        RiverSolverResult solve(unsigned maxIterationsCount, double targetExploitability = 0, double secondsBudget = 0);
+
+        /**
+         * Mean of what best responses of both players to average strategy
+         * gain over value of the game in chips, 0 for Nash equilibrium.
+         */
+        double calculateExploitability() const;
+
+        // Chips player wins on average from pot and river bets when both play average strategy
+        double calculateExpectedValue(unsigned player) const;
+
+        inline unsigned getIterationsCount() const noexcept
+        {
+            return iterationsCount;
+        }
+
+        inline unsigned getRootNode() const noexcept
+        {
+            return 0;
+        }
+
+        inline size_t getNodesCount() const noexcept
+        {
+            return nodes.size();
+        }
+
+        // Acting player of node, actions are empty for terminal nodes
+        unsigned getPlayer(unsigned node) const;
+        const std::vector<RiverAction>& getActions(unsigned node) const;
+        unsigned getChild(unsigned node, unsigned action) const;
+
+        /**
+         * Average strategy of acting player holding hole cards, probabilities
+         * of actions of node. Throws std::invalid_argument for terminal nodes
+         * and hole cards that aren't in range of player.
+         */
+        std::vector<double> getStrategy(unsigned node, Hand holeCards) const;
+
+    private:
+        enum class NodeType {
+            Action,
+            Fold,
+            Showdown
+        };
+
+        struct Node {
+            NodeType type;
+            unsigned player;           // Acting player or player who folded
+            double contributions[2];   // Chips put on river by players
+            std::vector<RiverAction> actions;
+            std::vector<unsigned> children;
+            size_t strategyOffset;     // Regrets and cumulative strategy of actions of all hands of player
+        };
+
+        struct Range {
+            std::vector<Hand> holeCards;
+            std::vector<double> weights;
+            std::vector<uint8_t> cardsBits;    // Bit indexes of both cards of every hand
+            std::vector<uint32_t> sortedHands; // Hands by increasing values
+            std::vector<uint32_t> values;
+            std::vector<int> sameHands;        // Index of same hole cards in range of other player or -1
+            std::vector<int> handsIndexes;     // Index of hand by getHoleCardsIndex or -1
+        };
+
+        void initializeRange(unsigned player);
+        unsigned buildNode(unsigned player, const double* contributions, unsigned raisesCount, bool isChecked, unsigned depth);
+        unsigned addTerminalNode(NodeType type, unsigned player, const double* contributions);
+        void addBetActions(std::vector<RiverAction>& actions, const std::vector<double>& sizes, double callContribution, double potAfterCall,
+                           RiverActionType type) const;
+        std::vector<std::vector<double>> createBuffers() const;
+
+        void calculateTerminalValues(const Node& node, unsigned player, const double* reach, double* values) const noexcept;
+        void calculateCurrentStrategy(const Node& node, double* strategy, double* sums) const noexcept;
+        void calculateAverageStrategy(const Node& node, double* strategy, double* sums) const noexcept;
+        void updateRegrets(unsigned nodeIndex, unsigned player, const double* reach, double* values, unsigned depth);
+        void calculateValues(unsigned nodeIndex, unsigned player, const double* reach, double* values, unsigned depth, bool isBestResponse,
+                             std::vector<std::vector<double>>& depthsBuffers) const;
+        double calculateGameValue(unsigned player, bool isBestResponse) const;
+
+        RiverSubgame subgame;
+        Range ranges[2];
+        std::vector<Node> nodes;
+        std::vector<double> regrets;
+        std::vector<double> cumulativeStrategy;
+        double pairsWeight;     // Total weight of pairs of hands not sharing cards
+        unsigned iterationsCount;
+        unsigned actionsDepth;  // Maximum depth of action nodes
+        size_t maxActionsCount;
+        std::vector<std::vector<double>> buffers; // Strategies, values and reaches of every depth of tree
+    };
+}
@@ -0,0 +1,62 @@
+/* pokertools - tools for poker related coding
+ * Copyright (C) 2016 Andriy Lysnevych
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+#pragma once
+
+#include "poker.hpp"
+#include "evaluators.hpp"
+
+namespace pokertools
+{
+    static constexpr unsigned MaxShowdownPlayersCount = 10;
+    static constexpr Hand FoldedHoleCards = 0; // Player contributed to pots but can't win them
+
+    enum class OddChipRule : unsigned {
+        PlayersOrder, // Odd chips go to winners in players order, so first player should be first seat left of button
+        HighestCard   // Odd chips go to winners with highest hole card by rank, then by suit (spades, hearts, diamonds, clubs)
+    };
+
+    /**
+     * Settles Hold'em showdown on 5 cards board. Every player has 2 hole cards
+     * or FoldedHoleCards and total amount of chips contributed to pot in
+     * contributions. Pot is split to main and side pots by contributions of
+     * players that didn't fold, and chips of folded players above the highest
+     * of them go to the last side pot. Every pot is split equally between its
+     * best hands and odd chips are given one per winner by oddChipRule. Stores
+     * total amount won by every player (including returned uncalled chips) to
+     * payouts, sum of payouts is equal to sum of contributions.
+     *
+     * Throws std::invalid_argument if cards overlap or have invalid count, or
+     * every player folded.
+     */
+    extern void resolveShowdown(Hand board, const Hand* holeCards, const uint64_t* contributions, unsigned playersCount, uint64_t* payouts,
+                                OddChipRule oddChipRule = OddChipRule::PlayersOrder);
+
+    /**
+     * Settles dealsCount showdowns with the same number of players like
+     * resolveShowdown. Hole cards, contributions and payouts of deal i are at
+     * i * playersCount. Hands of all players of many deals are evaluated by
+     * batch evaluator and winners of every pot are found by vector comparison
+     * of their values with specified or best supported instruction set.
+     * All deals are checked before any payout is written.
+     */
+    extern void resolveShowdowns(const Hand* boards, const Hand* holeCards, const uint64_t* contributions, unsigned playersCount, size_t dealsCount,
+                                 uint64_t* payouts, OddChipRule oddChipRule = OddChipRule::PlayersOrder);
+    extern void resolveShowdowns(const Hand* boards, const Hand* holeCards, const uint64_t* contributions, unsigned playersCount, size_t dealsCount,
+                                 uint64_t* payouts, OddChipRule oddChipRule, InstructionSet instructionSet);
+}
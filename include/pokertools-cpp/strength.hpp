@@ -0,0 +1,58 @@
+/* pokertools - tools for poker related coding
+ * Copyright (C) 2016 Andriy Lysnevych
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+#pragma once
+
+#include "poker.hpp"
+#include "equity.hpp"
+
+#include <vector>
+
+namespace pokertools
+{
+    /**
+     * Hand strength of hero against one opponent holding any combination of a
+     * range. Strength is share of opponent range weight that hero beats, ties
+     * are counted as half. Every runout to the river is weighted equally.
+     */
+    struct HandStrengthResult {
+        double handStrength;                // Strength on current board
+        double expectedHandStrength;        // EHS: mean river strength over runouts
+        double expectedHandStrengthSquared; // EHS²: mean of squared river strength, rewards draws
+        double positivePotential;           // Chance to get ahead of opponent who is ahead or tied now, ties are counted as half
+        double negativePotential;           // Chance to fall behind opponent who is behind or tied now, ties are counted as half
+        std::vector<double> histogram;      // Share of runouts with river strength in every of equal bins of [0, 1]
+    };
+
+    /**
+     * Exact hand strength distribution of hero on board with 3 to 5 cards
+     * against uniform or weighted opponent range. Opponent combinations sharing
+     * cards with hero, board or runout are skipped, and runouts where opponent
+     * can't hold any combination are excluded. Every runout evaluates opponent
+     * combinations with one board context, runouts equivalent under suit
+     * permutations preserving hero, board and range are evaluated once, and
+     * runouts are split to threads (0 means number of hardware threads).
+     * Results don't depend on number of threads.
+     *
+     * Throws std::invalid_argument if cards overlap or have invalid count, or
+     * number of bins is 0.
+     */
+    extern HandStrengthResult calculateHandStrength(Hand holeCards, Hand board, unsigned binsCount = 50, unsigned threadsCount = 0);
+    extern HandStrengthResult calculateHandStrength(Hand holeCards, Hand board, const std::vector<WeightedHoleCards>& opponentRange,
+                                                    unsigned binsCount = 50, unsigned threadsCount = 0);
+}
@@ -0,0 +1,578 @@
+/* pokertools - tools for poker related coding
+ * Copyright (C) 2016 Andriy Lysnevych
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+#include <pokertools-cpp/abstraction.hpp>
+#include <pokertools-cpp/evaluators.hpp>
+#include <pokertools-cpp/isomorphism.hpp>
+#include <pokertools-cpp/combinations.hpp>
+#include "parallel.hpp"
+#include "random.hpp"
+
+#include <stdexcept>
+#include <algorithm>
+#include <fstream>
+#include <cstring>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+namespace pokertools
+{
+    static constexpr char AbstractionFileMagic[8] = { 'P', 'T', 'A', 'B', 'S', 'T', 'R', 'C' };
+    static constexpr unsigned BoardSize = 5;
+    static constexpr unsigned OpponentsHoleCardsCount = (CardsCount - BoardSize - 2) * (CardsCount - BoardSize - 3) / 2;
+    static constexpr unsigned ClusterTaskPointsCount = 4096;
+    static constexpr unsigned SamplePointsPerBucket = 64; // k-means++ runs on sample of this many distributions per bucket
+
+    static unsigned getCanonicalBoardsCount(unsigned boardCardsCount)
+    {
+        if ((boardCardsCount != 3) && (boardCardsCount != 4)) {
+            throw std::invalid_argument("Abstraction board must have 3 or 4 cards");
+        }
+
+        return (boardCardsCount == 3) ? CanonicalFlopsCount : CanonicalTurnsCount;
+    }
+
+    struct BoardDistributions {
+        std::vector<uint32_t> situationIndexes;
+        std::vector<uint32_t> weights;
+        std::vector<uint16_t> histograms;
+    };
+
+    struct DistributionsBuffers {
+        uint32_t values[HoleCardsCombinationsCount];
+        uint16_t ordinals[HoleCardsCombinationsCount];
+        uint16_t sortedIndexes[HoleCardsCombinationsCount]; // Hole cards not overlapping board by ordinals
+        uint16_t ordinalsStarts[HandValuesCount];           // Counting sort positions
+        uint8_t cardsBits[HoleCardsCombinationsCount][2];   // Bit indexes of cards of every hole cards
+        uint16_t bins[2 * OpponentsHoleCardsCount + 1];     // Bin of every doubled number of wins plus ties
+        unsigned lowerCardsCounts[64];                      // Hole cards with lower values by bit index of their cards
+        unsigned equalCardsCounts[64];                      // Hole cards with current value
+        std::vector<uint16_t> histograms;                   // Of all hole cards indexed by getHoleCardsIndex
+    };
+
+    static void calculateBoardDistributions(unsigned boardIndex, unsigned boardCardsCount, unsigned binsCount, DistributionsBuffers& buffers,
+                                            BoardDistributions& distributions)
+    {
+        Hand board = getCanonicalBoard(boardIndex, boardCardsCount);
+
+        for (unsigned i = 0; i < HoleCardsCombinationsCount; i++) {
+            uint64_t bits = getHoleCardsByIndex(i);
+            buffers.cardsBits[i][0] = static_cast<uint8_t>(__builtin_ctzll(bits));
+            buffers.cardsBits[i][1] = static_cast<uint8_t>(__builtin_ctzll(bits & (bits - 1)));
+        }
+
+        for (unsigned i = 0; i <= 2 * OpponentsHoleCardsCount; i++) {
+            double strength = i / (2.0 * OpponentsHoleCardsCount);
+            buffers.bins[i] = static_cast<uint16_t>(std::min(static_cast<unsigned>(strength * binsCount), binsCount - 1));
+        }
+
+        buffers.histograms.assign(HoleCardsCombinationsCount * binsCount, 0);
+        std::fill_n(buffers.equalCardsCounts, 64, 0); // Every group clears its counts
+
+        for (Hand runout : CardsCombinations(FullDeck ^ board, BoardSize - boardCardsCount)) {
+            evaluateAllWithBoard(createBoardContext(board | runout), buffers.values);
+            std::fill_n(buffers.ordinalsStarts, HandValuesCount, 0);
+            unsigned sortedCount = 0;
+
+            // Counting sort by ordinals is much faster than comparison sort of about thousand values
+            for (unsigned i = 0; i < HoleCardsCombinationsCount; i++) {
+                if (buffers.values[i] != 0) {
+                    buffers.ordinals[i] = static_cast<uint16_t>(convertValueToOrdinal(buffers.values[i]));
+                    buffers.ordinalsStarts[buffers.ordinals[i]]++;
+                }
+            }
+
+            for (unsigned ordinal = 0; ordinal < HandValuesCount; ordinal++) {
+                unsigned count = buffers.ordinalsStarts[ordinal];
+                buffers.ordinalsStarts[ordinal] = static_cast<uint16_t>(sortedCount);
+                sortedCount += count;
+            }
+
+            for (unsigned i = 0; i < HoleCardsCombinationsCount; i++) {
+                if (buffers.values[i] != 0) {
+                    buffers.sortedIndexes[buffers.ordinalsStarts[buffers.ordinals[i]]++] = static_cast<uint16_t>(i);
+                }
+            }
+
+            std::fill_n(buffers.lowerCardsCounts, 64, 0);
+            unsigned lowerCount = 0;
+
+            // Groups of equal values, opponents sharing cards with hole cards are subtracted by counts of cards
+            for (unsigned first = 0, end = 0; first < sortedCount; first = end) {
+                uint16_t ordinal = buffers.ordinals[buffers.sortedIndexes[first]];
+
+                for (end = first; (end < sortedCount) && (buffers.ordinals[buffers.sortedIndexes[end]] == ordinal); end++) {
+                    const uint8_t* cardsBits = buffers.cardsBits[buffers.sortedIndexes[end]];
+                    buffers.equalCardsCounts[cardsBits[0]]++;
+                    buffers.equalCardsCounts[cardsBits[1]]++;
+                }
+
+                unsigned equalCount = end - first;
+
+                for (unsigned i = first; i < end; i++) {
+                    unsigned index = buffers.sortedIndexes[i];
+                    const uint8_t* cardsBits = buffers.cardsBits[index];
+                    unsigned winCount = lowerCount - buffers.lowerCardsCounts[cardsBits[0]] - buffers.lowerCardsCounts[cardsBits[1]];
+                    // Hole cards themselves are subtracted twice
+                    unsigned tieCount = equalCount - buffers.equalCardsCounts[cardsBits[0]] - buffers.equalCardsCounts[cardsBits[1]] + 1;
+                    buffers.histograms[index * binsCount + buffers.bins[2 * winCount + tieCount]]++;
+                }
+
+                for (unsigned i = first; i < end; i++) {
+                    const uint8_t* cardsBits = buffers.cardsBits[buffers.sortedIndexes[i]];
+                    buffers.lowerCardsCounts[cardsBits[0]]++;
+                    buffers.lowerCardsCounts[cardsBits[1]]++;
+                    buffers.equalCardsCounts[cardsBits[0]]--;
+                    buffers.equalCardsCounts[cardsBits[1]]--;
+                }
+
+                lowerCount += equalCount;
+            }
+        }
+
+        for (unsigned i = 0; i < HoleCardsCombinationsCount; i++) {
+            Hand holeCards = getHoleCardsByIndex(i);
+
+            if ((holeCards & board) == 0) {
+                CanonicalForm canonicalForm = canonicalize(holeCards, board);
+
+                if (canonicalForm.holeCards == holeCards) {
+                    distributions.situationIndexes.push_back(boardIndex * HoleCardsCombinationsCount + i);
+                    distributions.weights.push_back(canonicalForm.weight);
+                    distributions.histograms.insert(distributions.histograms.end(), buffers.histograms.begin() + i * binsCount,
+                                                    buffers.histograms.begin() + (i + 1) * binsCount);
+                }
+            }
+        }
+    }
+
+    StrengthDistributions calculateStrengthDistributions(unsigned boardCardsCount, unsigned binsCount, unsigned threadsCount,
+                                                         const std::vector<unsigned>& boardIndexes)
+    {
+        unsigned canonicalBoardsCount = getCanonicalBoardsCount(boardCardsCount);
+
+        if (binsCount == 0) {
+            throw std::invalid_argument("Number of bins must be positive");
+        }
+
+        std::vector<unsigned> indexes = boardIndexes;
+
+        if (indexes.empty()) {
+            for (unsigned i = 0; i < canonicalBoardsCount; i++) {
+                indexes.push_back(i);
+            }
+        } else if (*std::max_element(indexes.begin(), indexes.end()) >= canonicalBoardsCount) {
+            throw std::invalid_argument("Invalid canonical board index");
+        }
+
+        // Builds canonical boards index before threads use it
+        getCanonicalBoard(0, boardCardsCount);
+
+        threadsCount = resolveThreadsCount(threadsCount);
+        std::vector<DistributionsBuffers> buffers(threadsCount);
+        std::vector<BoardDistributions> boardsDistributions(indexes.size());
+
+        parallelFor(threadsCount, indexes.size(), [&] (size_t task, unsigned threadIndex) {
+            calculateBoardDistributions(indexes[task], boardCardsCount, binsCount, buffers[threadIndex], boardsDistributions[task]);
+        });
+
+        StrengthDistributions distributions;
+        distributions.boardCardsCount = boardCardsCount;
+        distributions.binsCount = binsCount;
+        distributions.runoutsCount = static_cast<unsigned>(getBinomial(CardsCount - boardCardsCount - 2, BoardSize - boardCardsCount));
+
+        for (const BoardDistributions& boardDistributions : boardsDistributions) {
+            distributions.situationIndexes.insert(distributions.situationIndexes.end(), boardDistributions.situationIndexes.begin(),
+                                                  boardDistributions.situationIndexes.end());
+            distributions.weights.insert(distributions.weights.end(), boardDistributions.weights.begin(), boardDistributions.weights.end());
+            distributions.histograms.insert(distributions.histograms.end(), boardDistributions.histograms.begin(), boardDistributions.histograms.end());
+        }
+
+        return distributions;
+    }
+
+    // Cumulative histogram without the last bin that is always 1
+    static inline void getCumulativeHistogram(const uint16_t* histogram, unsigned binsCount, float scale, float* cumulative) noexcept
+    {
+        unsigned sum = 0;
+
+        for (unsigned bin = 0; bin + 1 < binsCount; bin++) {
+            sum += histogram[bin];
+            cumulative[bin] = sum * scale;
+        }
+    }
+
+    static inline float getDistance(const float* first, const float* second, unsigned count) noexcept
+    {
+        float distance = 0;
+
+        for (unsigned i = 0; i < count; i++) {
+            distance += std::fabs(first[i] - second[i]);
+        }
+
+        return distance;
+    }
+
+    struct ClusterSums {
+        std::vector<int64_t> cumulativeCounts; // Weighted sums of cumulative histograms of every bucket
+        std::vector<int64_t> weights;
+        size_t changesCount;
+    };
+
+    /**
+     * Hamerly's k-means: every distribution keeps upper bound of distance to its
+     * center and lower bound of distance to other centers, so it is compared to
+     * all centers only when bounds don't prove that assignment stays. Bucket sums
+     * are integers updated by moved distributions, so they don't depend on order.
+     */
+    class StrengthClustering
+    {
+    public:
+        StrengthClustering(const StrengthDistributions& distributions, unsigned bucketsCount, unsigned threadsCount)
+            : distributions(distributions), bucketsCount(bucketsCount), dimensionsCount(distributions.binsCount - 1),
+              pointsCount(distributions.weights.size()), scale(1.0f / distributions.runoutsCount), threadsCount(resolveThreadsCount(threadsCount)),
+              centers(bucketsCount * dimensionsCount), halfSeparations(bucketsCount), buckets(pointsCount, NoBucket),
+              upperBounds(pointsCount, std::numeric_limits<float>::infinity()), lowerBounds(pointsCount, 0), sums(this->threadsCount)
+        {
+            for (ClusterSums& threadSums : sums) {
+                threadSums.cumulativeCounts.assign(bucketsCount * dimensionsCount, 0);
+                threadSums.weights.assign(bucketsCount, 0);
+            }
+        }
+
+        void initializeCenters(uint64_t seed)
+        {
+            // k-means++ on sample, probability of distribution is its weight times squared distance to the nearest center
+            Xoshiro256StarStar random(seed);
+            size_t samplesCount = std::min<size_t>(pointsCount, static_cast<size_t>(SamplePointsPerBucket) * bucketsCount);
+            std::vector<float> samples(samplesCount * dimensionsCount);
+            std::vector<double> sampleWeights(samplesCount);
+            std::vector<double> nearestDistances(samplesCount, std::numeric_limits<double>::infinity());
+
+            for (size_t i = 0; i < samplesCount; i++) {
+                size_t point = (samplesCount == pointsCount) ? i : static_cast<size_t>(random() % pointsCount);
+                getPoint(point, &samples[i * dimensionsCount]);
+                sampleWeights[i] = distributions.weights[point];
+            }
+
+            for (unsigned bucket = 0; bucket < bucketsCount; bucket++) {
+                double total = 0;
+
+                for (size_t i = 0; i < samplesCount; i++) {
+                    total += sampleWeights[i] * ((bucket == 0) ? 1.0 : nearestDistances[i] * nearestDistances[i]);
+                }
+
+                double target = (random() >> 11) * (1.0 / (1ull << 53)) * total;
+                size_t chosen = 0;
+
+                for (double cumulative = 0; chosen + 1 < samplesCount; chosen++) {
+                    cumulative += sampleWeights[chosen] * ((bucket == 0) ? 1.0 : nearestDistances[chosen] * nearestDistances[chosen]);
+
+                    if (cumulative > target) {
+                        break;
+                    }
+                }
+
+                float* center = &centers[bucket * dimensionsCount];
+                std::copy_n(&samples[chosen * dimensionsCount], dimensionsCount, center);
+
+                for (size_t i = 0; i < samplesCount; i++) {
+                    nearestDistances[i] = std::min<double>(nearestDistances[i], getDistance(&samples[i * dimensionsCount], center, dimensionsCount));
+                }
+            }
+        }
+
+        // Returns number of distributions that changed bucket
+        size_t assign()
+        {
+            calculateHalfSeparations();
+
+            for (ClusterSums& threadSums : sums) {
+                threadSums.changesCount = 0;
+            }
+
+            size_t tasksCount = (pointsCount + ClusterTaskPointsCount - 1) / ClusterTaskPointsCount;
+
+            parallelFor(threadsCount, tasksCount, [&] (size_t task, unsigned threadIndex) {
+                std::vector<float> point(dimensionsCount);
+                size_t end = std::min(pointsCount, (task + 1) * ClusterTaskPointsCount);
+
+                for (size_t i = task * ClusterTaskPointsCount; i < end; i++) {
+                    assignPoint(i, point.data(), sums[threadIndex]);
+                }
+            });
+
+            size_t changesCount = 0;
+
+            for (const ClusterSums& threadSums : sums) {
+                changesCount += threadSums.changesCount;
+            }
+
+            return changesCount;
+        }
+
+        void updateCenters(Xoshiro256StarStar& random)
+        {
+            std::vector<float> previousCenters = centers;
+            std::vector<float> moves(bucketsCount);
+            ClusterSums& total = sums[0];
+
+            for (size_t thread = 1; thread < sums.size(); thread++) {
+                for (size_t i = 0; i < total.cumulativeCounts.size(); i++) {
+                    total.cumulativeCounts[i] += sums[thread].cumulativeCounts[i];
+                    sums[thread].cumulativeCounts[i] = 0;
+                }
+
+                for (unsigned bucket = 0; bucket < bucketsCount; bucket++) {
+                    total.weights[bucket] += sums[thread].weights[bucket];
+                    sums[thread].weights[bucket] = 0;
+                }
+            }
+
+            for (unsigned bucket = 0; bucket < bucketsCount; bucket++) {
+                float* center = &centers[bucket * dimensionsCount];
+
+                if (total.weights[bucket] > 0) {
+                    for (unsigned dimension = 0; dimension < dimensionsCount; dimension++) {
+                        center[dimension] = static_cast<float>(static_cast<double>(total.cumulativeCounts[bucket * dimensionsCount + dimension]) /
+                                                               total.weights[bucket] * scale);
+                    }
+                } else {
+                    // Empty bucket takes random distribution
+                    getPoint(static_cast<size_t>(random() % pointsCount), center);
+                }
+
+                moves[bucket] = getDistance(center, &previousCenters[bucket * dimensionsCount], dimensionsCount);
+            }
+
+            float maxMove = *std::max_element(moves.begin(), moves.end());
+
+            for (size_t i = 0; i < pointsCount; i++) {
+                upperBounds[i] += moves[buckets[i]];
+                lowerBounds[i] -= maxMove;
+            }
+        }
+
+        const std::vector<uint16_t>& getBuckets() const noexcept
+        {
+            return buckets;
+        }
+
+    private:
+        const StrengthDistributions& distributions;
+        unsigned bucketsCount;
+        unsigned dimensionsCount;
+        size_t pointsCount;
+        float scale;
+        unsigned threadsCount;
+        std::vector<float> centers;
+        std::vector<float> halfSeparations; // Half of distance from every center to the nearest other center
+        std::vector<uint16_t> buckets;
+        std::vector<float> upperBounds;
+        std::vector<float> lowerBounds;
+        std::vector<ClusterSums> sums; // Changes of bucket sums by every thread
+
+        inline void getPoint(size_t point, float* cumulative) const noexcept
+        {
+            getCumulativeHistogram(&distributions.histograms[point * distributions.binsCount], distributions.binsCount, scale, cumulative);
+        }
+
+        void calculateHalfSeparations() noexcept
+        {
+            for (unsigned bucket = 0; bucket < bucketsCount; bucket++) {
+                float separation = std::numeric_limits<float>::infinity();
+
+                for (unsigned other = 0; other < bucketsCount; other++) {
+                    if (other != bucket) {
+                        separation = std::min(separation, getDistance(&centers[bucket * dimensionsCount], &centers[other * dimensionsCount], dimensionsCount));
+                    }
+                }
+
+                halfSeparations[bucket] = separation / 2;
+            }
+        }
+
+        void assignPoint(size_t i, float* point, ClusterSums& threadSums) noexcept
+        {
+            uint16_t bucket = buckets[i];
+
+            if (bucket != NoBucket) {
+                float bound = std::max(halfSeparations[bucket], lowerBounds[i]);
+
+                if (upperBounds[i] <= bound) {
+                    return;
+                }
+
+                getPoint(i, point);
+                upperBounds[i] = getDistance(point, &centers[bucket * dimensionsCount], dimensionsCount);
+
+                if (upperBounds[i] <= bound) {
+                    return;
+                }
+            } else {
+                getPoint(i, point);
+            }
+
+            float nearestDistance = std::numeric_limits<float>::infinity();
+            float secondDistance = std::numeric_limits<float>::infinity();
+            uint16_t nearestBucket = 0;
+
+            for (unsigned other = 0; other < bucketsCount; other++) {
+                float distance = getDistance(point, &centers[other * dimensionsCount], dimensionsCount);
+
+                if (distance < nearestDistance) {
+                    secondDistance = nearestDistance;
+                    nearestDistance = distance;
+                    nearestBucket = static_cast<uint16_t>(other);
+                } else if (distance < secondDistance) {
+                    secondDistance = distance;
+                }
+            }
+
+            upperBounds[i] = nearestDistance;
+            lowerBounds[i] = secondDistance;
+
+            if (nearestBucket != bucket) {
+                const uint16_t* histogram = &distributions.histograms[i * distributions.binsCount];
+                int64_t weight = distributions.weights[i];
+                int64_t cumulativeCount = 0;
+
+                for (unsigned dimension = 0; dimension < dimensionsCount; dimension++) {
+                    cumulativeCount += histogram[dimension];
+
+                    if (bucket != NoBucket) {
+                        threadSums.cumulativeCounts[bucket * dimensionsCount + dimension] -= weight * cumulativeCount;
+                    }
+
+                    threadSums.cumulativeCounts[nearestBucket * dimensionsCount + dimension] += weight * cumulativeCount;
+                }
+
+                if (bucket != NoBucket) {
+                    threadSums.weights[bucket] -= weight;
+                }
+
+                threadSums.weights[nearestBucket] += weight;
+                threadSums.changesCount++;
+                buckets[i] = nearestBucket;
+            }
+        }
+    };
+
+    std::vector<uint16_t> clusterStrengthDistributions(const StrengthDistributions& distributions, unsigned bucketsCount, unsigned iterationsCount,
+                                                       uint64_t seed, unsigned threadsCount)
+    {
+        if ((bucketsCount == 0) || (bucketsCount > distributions.weights.size()) || (bucketsCount >= NoBucket)) {
+            throw std::invalid_argument("Number of buckets must be from 1 to number of distributions");
+        }
+
+        StrengthClustering clustering(distributions, bucketsCount, threadsCount);
+        Xoshiro256StarStar random(seed, 1);
+        clustering.initializeCenters(seed);
+
+        for (unsigned iteration = 0; iteration < iterationsCount; iteration++) {
+            if ((clustering.assign() == 0) && (iteration > 0)) {
+                break;
+            }
+
+            clustering.updateCenters(random);
+        }
+
+        return clustering.getBuckets();
+    }
+
+    void writeAbstractionFile(const std::string& fileName, const StrengthDistributions& distributions, const std::vector<uint16_t>& buckets,
+                              unsigned bucketsCount)
+    {
+        size_t situationsCount = static_cast<size_t>(getCanonicalBoardsCount(distributions.boardCardsCount)) * HoleCardsCombinationsCount;
+
+        if (buckets.size() != distributions.situationIndexes.size()) {
+            throw std::invalid_argument("Every distribution must have bucket");
+        } else if ((bucketsCount == 0) || (bucketsCount >= NoBucket) || std::any_of(buckets.begin(), buckets.end(), [bucketsCount] (uint16_t bucket) {
+            return bucket >= bucketsCount;
+        })) {
+            throw std::invalid_argument("Buckets must be less than number of buckets");
+        }
+
+        std::vector<uint16_t> payload(situationsCount, NoBucket);
+
+        for (size_t i = 0; i < buckets.size(); i++) {
+            payload[distributions.situationIndexes[i]] = buckets[i];
+        }
+
+        AbstractionFileHeader header{};
+        std::copy_n(AbstractionFileMagic, sizeof(header.magic), header.magic);
+        header.version = AbstractionFileVersion;
+        header.headerSize = sizeof(AbstractionFileHeader);
+        header.boardCardsCount = distributions.boardCardsCount;
+        header.bucketsCount = bucketsCount;
+        header.situationsCount = static_cast<uint32_t>(situationsCount);
+        header.payloadSize = sizeof(uint16_t) * situationsCount;
+        header.checksum = calculateFileChecksum(reinterpret_cast<const uint8_t*>(payload.data()), header.payloadSize);
+
+        std::ofstream file(fileName, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(payload.data()), header.payloadSize);
+        file.close();
+
+        if (!file) {
+            throw std::runtime_error("Can't write abstraction file " + fileName);
+        }
+    }
+
+    AbstractionTable::AbstractionTable(const std::string& fileName, bool verifyChecksum)
+        : file(fileName, "abstraction", sizeof(AbstractionFileHeader)), boardCardsCount(0), bucketsCount(0), buckets(nullptr)
+    {
+        const AbstractionFileHeader& header = *reinterpret_cast<const AbstractionFileHeader*>(file.getData());
+        const uint8_t* payload = file.getData() + sizeof(AbstractionFileHeader);
+        uint64_t canonicalBoardsCount = (header.boardCardsCount == 3) ? CanonicalFlopsCount : (header.boardCardsCount == 4) ? CanonicalTurnsCount : 0;
+
+        const char* error = nullptr;
+
+        if (!std::equal(header.magic, header.magic + sizeof(header.magic), AbstractionFileMagic)) {
+            error = "Not an abstraction file ";
+        } else if (header.version != AbstractionFileVersion) {
+            error = "Unsupported version of abstraction file ";
+        } else if ((header.headerSize != sizeof(AbstractionFileHeader)) || (canonicalBoardsCount == 0) || (header.bucketsCount == 0) ||
+                   (header.bucketsCount >= NoBucket) || (header.situationsCount != canonicalBoardsCount * HoleCardsCombinationsCount) ||
+                   (header.payloadSize != sizeof(uint16_t) * header.situationsCount) || (file.getSize() != sizeof(AbstractionFileHeader) + header.payloadSize)) {
+            error = "Invalid header of abstraction file ";
+        } else if (verifyChecksum && (header.checksum != calculateFileChecksum(payload, header.payloadSize))) {
+            error = "Invalid checksum of abstraction file ";
+        }
+
+        if (error) {
+            throw std::runtime_error(error + fileName);
+        }
+
+        boardCardsCount = header.boardCardsCount;
+        bucketsCount = header.bucketsCount;
+        buckets = reinterpret_cast<const uint16_t*>(payload);
+    }
+
+    unsigned AbstractionTable::getBucket(Hand holeCards, Hand board) const
+    {
+        assert((countCards(holeCards) == 2) && ((holeCards & board) == 0));
+
+        if (countCards(board) != boardCardsCount) {
+            throw std::invalid_argument("Board must have number of cards of abstraction street");
+        }
+
+        return buckets[getCanonicalSituationIndex(holeCards, board)];
+    }
+}
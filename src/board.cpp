@@ -0,0 +1,195 @@
+/* pokertools - tools for poker related coding
+ * Copyright (C) 2016 Andriy Lysnevych
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+#include <pokertools-cpp/evaluators.hpp>
+#include "tables.hpp"
+#include "values.hpp"
+
+namespace pokertools
+{
+    using tables::numberOfBits;
+    using tables::rankOfStraights;
+    using tables::highUpTo5Bits;
+    using tables::highBit;
+    using tables::highUpTo3Bits;
+
+    static constexpr unsigned BoardCardsCount = 5;
+
+    static inline void addRank(uint16_t* ranksByCount, uint16_t rank) noexcept
+    {
+        ranksByCount[3] |= ranksByCount[2] & rank;
+        ranksByCount[2] |= ranksByCount[1] & rank;
+        ranksByCount[1] |= ranksByCount[0] & rank;
+        ranksByCount[0] |= rank;
+    }
+
+    BoardContext createBoardContext(Hand board) noexcept
+    {
+        assert(countCards(board) == BoardCardsCount);
+
+        BoardContext context{};
+        context.board = board;
+        context.flushSuit = SuitsCount;
+
+        for (unsigned suit = 0; suit < SuitsCount; suit++) {
+            uint16_t suitRanks = board.suit(static_cast<Suit>(suit));
+
+            context.suitsCounts[suit] = numberOfBits[suitRanks];
+
+            for (uint16_t ranks = suitRanks; ranks != 0; ranks &= ranks - 1) {
+                addRank(context.ranksByCount, ranks & -ranks);
+            }
+
+            if (context.suitsCounts[suit] >= 3) {
+                context.flushSuit = suit;
+                context.flushSuitRanks = suitRanks;
+            }
+        }
+
+        // Five high straight first and then ones from six high
+        uint16_t straightMask = 0b1000000001111;
+        context.isStraightPossible = numberOfBits[context.ranksByCount[0] & straightMask] >= 3;
+
+        for (straightMask = 0b11111; straightMask <= 0b1111100000000; straightMask <<= 1) {
+            context.isStraightPossible |= numberOfBits[context.ranksByCount[0] & straightMask] >= 3;
+        }
+
+        return context;
+    }
+
+    // Same hand types precedence as in evaluateHoldem7CardsHand but from ranks multiplicity masks of all 7 cards
+    static inline uint32_t evaluateRanksByCount(const BoardContext& context, const uint16_t* ranksByCount, uint16_t flushRanks) noexcept
+    {
+        uint32_t flushOrStraightValue = 0;
+
+        if (numberOfBits[flushRanks] >= 5) {
+            uint16_t straightRank = rankOfStraights[flushRanks];
+
+            if (straightRank != 0) {
+                return calculateStraightFlushValue(straightRank);
+            }
+
+            flushOrStraightValue = calculateFlushValue(highUpTo5Bits[flushRanks]);
+        } else if (context.isStraightPossible) {
+            uint16_t straightRank = rankOfStraights[ranksByCount[0]];
+
+            if (straightRank != 0) {
+                flushOrStraightValue = calculateStraightValue(straightRank);
+            }
+        }
+
+        if (ranksByCount[3] != 0) {
+            return calculateFourOfAKindValue(ranksByCount[3], highBit[ranksByCount[0] ^ ranksByCount[3]]);
+        }
+
+        if ((ranksByCount[2] != 0) && (numberOfBits[ranksByCount[1]] >= 2)) {
+            uint16_t tripsRank = highBit[ranksByCount[2]];
+
+            return calculateFullHouseValue(tripsRank, highBit[ranksByCount[1] ^ tripsRank]);
+        }
+
+        if (flushOrStraightValue != 0) {
+            return flushOrStraightValue;
+        }
+
+        if (ranksByCount[2] != 0) {
+            uint16_t kickersRanks = ranksByCount[0] ^ ranksByCount[2];
+            uint16_t firstKickerRank = highBit[kickersRanks];
+
+            return calculateThreeOfAKindValue(ranksByCount[2], firstKickerRank | highBit[kickersRanks ^ firstKickerRank]);
+        }
+
+        switch (numberOfBits[ranksByCount[1]]) {
+            case 0:
+                return calculateHighCardValue(highUpTo5Bits[ranksByCount[0]]);
+
+            case 1:
+                return calculatePairValue(ranksByCount[1], highUpTo3Bits[ranksByCount[0] ^ ranksByCount[1]]);
+
+            default: {
+                uint16_t highPairRank = highBit[ranksByCount[1]];
+                uint16_t secondPairRank = highBit[ranksByCount[1] ^ highPairRank];
+
+                return calculateTwoPairValue(highPairRank | secondPairRank, highBit[ranksByCount[0] ^ highPairRank ^ secondPairRank]);
+            }
+        }
+    }
+
+    static inline uint16_t getFlushSuitRanks(const BoardContext& context, Hand cards) noexcept
+    {
+        return (context.flushSuit != SuitsCount) ? cards.suit(static_cast<Suit>(context.flushSuit)) : 0;
+    }
+
+    uint32_t evaluateWithBoard(const BoardContext& context, Hand holeCards) noexcept
+    {
+        assert(countCards(holeCards) == 2);
+        assert((holeCards & context.board) == 0);
+
+        uint16_t ranksByCount[4] = { context.ranksByCount[0], context.ranksByCount[1], context.ranksByCount[2], context.ranksByCount[3] };
+        uint64_t bits = holeCards;
+
+        for (unsigned i = 0; i < 2; i++) {
+            unsigned bitIndex = __builtin_ctzll(bits);
+            addRank(ranksByCount, 1 << (bitIndex % SuitSizeInBits));
+            bits &= bits - 1;
+        }
+
+        return evaluateRanksByCount(context, ranksByCount, context.flushSuitRanks | getFlushSuitRanks(context, holeCards));
+    }
+
+    void evaluateAllWithBoard(const BoardContext& context, uint32_t* values) noexcept
+    {
+        // Without flush suit cards value depends only on ranks of hole cards, so it is evaluated once per ranks pair
+        uint32_t ranksPairsValues[RanksCount][RanksCount];
+
+        for (unsigned secondRank = 0; secondRank < RanksCount; secondRank++) {
+            uint16_t secondRanksByCount[4] = { context.ranksByCount[0], context.ranksByCount[1], context.ranksByCount[2], context.ranksByCount[3] };
+            addRank(secondRanksByCount, 1 << secondRank);
+
+            for (unsigned firstRank = 0; firstRank <= secondRank; firstRank++) {
+                uint16_t ranksByCount[4] = { secondRanksByCount[0], secondRanksByCount[1], secondRanksByCount[2], secondRanksByCount[3] };
+                addRank(ranksByCount, 1 << firstRank);
+
+                // Ranks pairs impossible with the board (e.g. fifth card of a rank) get some value that is never used
+                ranksPairsValues[firstRank][secondRank] = ranksPairsValues[secondRank][firstRank] =
+                    evaluateRanksByCount(context, ranksByCount, context.flushSuitRanks);
+            }
+        }
+
+        unsigned index = 0;
+
+        for (unsigned second = 0; second < CardsCount; second++) {
+            Card secondCard = createCard(second);
+            unsigned secondRank = second % RanksCount;
+            bool isSecondOnBoard = (context.board | secondCard) == context.board;
+            bool isSecondInFlushSuit = (second / RanksCount) == context.flushSuit;
+
+            for (unsigned first = 0; first < second; first++, index++) {
+                Card firstCard = createCard(first);
+
+                if (isSecondOnBoard || ((context.board | firstCard) == context.board)) {
+                    values[index] = 0;
+                } else if (isSecondInFlushSuit || ((first / RanksCount) == context.flushSuit)) {
+                    values[index] = evaluateWithBoard(context, firstCard | secondCard);
+                } else {
+                    values[index] = ranksPairsValues[first % RanksCount][secondRank];
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,642 @@
+/* pokertools - tools for poker related coding
+ * Copyright (C) 2016 Andriy Lysnevych
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+#include <pokertools-cpp/equity.hpp>
+#include <pokertools-cpp/evaluators.hpp>
+#include "parallel.hpp"
+#include "random.hpp"
+
+#include <stdexcept>
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+
+namespace pokertools
+{
+    static constexpr unsigned BoardSize = 5;
+    static constexpr unsigned MaxHoleCardsCombinationsCount = (CardsCount - 2) * (CardsCount - 3) / 2;
+    static constexpr unsigned ShareUnitsCount = 2520; // Divisible by any number of players sharing pot
+    static constexpr unsigned BatchTrialsCount = 1024;
+    static constexpr unsigned RoundBatchesCount = 64; // Early stop is checked after every round
+
+    struct Deal {
+        Hand heroHoleCards;
+        Hand board;
+        Hand knownOpponentsHoleCards[MaxOpponentsCount];
+        unsigned knownOpponentsCount;
+        unsigned unknownOpponentsCount;
+        Hand usedCards;
+    };
+
+    struct HoleCardsCombinations {
+        unsigned count;
+        Hand hands[MaxHoleCardsCombinationsCount];
+        uint32_t values[MaxHoleCardsCombinationsCount];
+    };
+
+    struct EquityAccumulator {
+        uint32_t heroValue;
+        uint64_t winCount;
+        uint64_t tieCount;
+        uint64_t loseCount;
+        double share;
+
+        inline void add(uint32_t bestOpponentsValue, unsigned heroTiesCount) noexcept
+        {
+            if (heroValue > bestOpponentsValue) {
+                winCount++;
+                share += 1.0;
+            } else if (heroValue == bestOpponentsValue) {
+                tieCount++;
+                share += 1.0 / (heroTiesCount + 1);
+            } else {
+                loseCount++;
+            }
+        }
+    };
+
+    static unsigned splitToCards(Hand hand, Hand* cards) noexcept
+    {
+        uint64_t bits = hand;
+        unsigned count = 0;
+
+        for (; bits != 0; bits &= bits - 1) {
+            cards[count++] = bits & (~bits + 1);
+        }
+
+        return count;
+    }
+
+    /**
+     * Calls callback with every combination of count cards out of cards array.
+     */
+    template<typename Callback>
+    static void forEachCombination(const Hand* cards, unsigned cardsCount, unsigned count, Callback&& callback)
+    {
+        assert(count <= BoardSize);
+
+        if (count == 0) {
+            callback(Hand(0));
+            return;
+        } else if (count > cardsCount) {
+            return;
+        }
+
+        unsigned indexes[BoardSize];
+        Hand prefixes[BoardSize + 1]; // prefixes[i] is union of cards for first i indexes
+        unsigned level = 0;
+
+        indexes[0] = 0;
+        prefixes[0] = 0;
+
+        while (true) {
+            for (; level < count; level++) {
+                prefixes[level + 1] = prefixes[level] | cards[indexes[level]];
+
+                if (level + 1 < count) {
+                    indexes[level + 1] = indexes[level] + 1;
+                }
+            }
+
+            callback(prefixes[count]);
+
+            do {
+                if (level == 0) {
+                    return;
+                }
+
+                level--;
+                indexes[level]++;
+            } while (indexes[level] > cardsCount - count + level);
+        }
+    }
+
+    static void enumerateUnknownOpponents(const HoleCardsCombinations& combinations, unsigned first, unsigned unknownOpponentsCount, Hand usedCards,
+                                          uint32_t bestOpponentsValue, unsigned heroTiesCount, EquityAccumulator& accumulator) noexcept
+    {
+        if (unknownOpponentsCount == 0) {
+            accumulator.add(bestOpponentsValue, heroTiesCount);
+            return;
+        }
+
+        // Opponents are interchangeable for hero result, so only combinations in increasing order are visited
+        for (unsigned i = first; i < combinations.count; i++) {
+            if ((usedCards & combinations.hands[i]) != 0) {
+                continue;
+            }
+
+            uint32_t value = combinations.values[i];
+
+            enumerateUnknownOpponents(combinations, i + 1, unknownOpponentsCount - 1, usedCards | combinations.hands[i],
+                                      std::max(bestOpponentsValue, value), heroTiesCount + (value == accumulator.heroValue), accumulator);
+        }
+    }
+
+    static Deal createDeal(Hand heroHoleCards, const Hand* opponentsHoleCards, unsigned opponentsCount, Hand board, Hand deadCards)
+    {
+        if (countCards(heroHoleCards) != 2) {
+            throw std::invalid_argument("Hero must have exactly 2 hole cards");
+        } else if ((opponentsCount == 0) || (opponentsCount > MaxOpponentsCount)) {
+            throw std::invalid_argument("Number of opponents must be from 1 to 9");
+        } else if (countCards(board) > BoardSize) {
+            throw std::invalid_argument("Board must have from 0 to 5 cards");
+        }
+
+        Deal deal;
+        unsigned usedCardsCount = countCards(heroHoleCards) + countCards(board) + countCards(deadCards);
+        deal.heroHoleCards = heroHoleCards;
+        deal.board = board;
+        deal.knownOpponentsCount = 0;
+        deal.usedCards = heroHoleCards | board | deadCards;
+
+        for (unsigned i = 0; i < opponentsCount; i++) {
+            if (opponentsHoleCards[i] == UnknownHoleCards) {
+                continue;
+            } else if (countCards(opponentsHoleCards[i]) != 2) {
+                throw std::invalid_argument("Opponent must have exactly 2 hole cards or UnknownHoleCards");
+            }
+
+            deal.knownOpponentsHoleCards[deal.knownOpponentsCount++] = opponentsHoleCards[i];
+            deal.usedCards |= opponentsHoleCards[i];
+            usedCardsCount += 2;
+        }
+
+        deal.unknownOpponentsCount = opponentsCount - deal.knownOpponentsCount;
+
+        if (countCards(deal.usedCards) != usedCardsCount) {
+            throw std::invalid_argument("Cards must not overlap");
+        } else if (usedCardsCount + (BoardSize - countCards(board)) + 2 * deal.unknownOpponentsCount > CardsCount) {
+            throw std::invalid_argument("Not enough cards in deck");
+        }
+
+        return deal;
+    }
+
+    EquityResult enumerateEquity(Hand heroHoleCards, const Hand* opponentsHoleCards, unsigned opponentsCount, Hand board, Hand deadCards)
+    {
+        Deal deal = createDeal(heroHoleCards, opponentsHoleCards, opponentsCount, board, deadCards);
+
+        Hand liveCards[CardsCount];
+        unsigned liveCardsCount = splitToCards(FullDeck ^ deal.usedCards, liveCards);
+        EquityAccumulator accumulator{};
+        HoleCardsCombinations combinations;
+
+        forEachCombination(liveCards, liveCardsCount, BoardSize - countCards(board), [&] (Hand runout) {
+            Hand fullBoard = board | runout;
+            uint32_t bestOpponentsValue = 0;
+            unsigned heroTiesCount = 0;
+
+            accumulator.heroValue = evaluateHoldem7CardsHand(heroHoleCards | fullBoard);
+
+            for (unsigned i = 0; i < deal.knownOpponentsCount; i++) {
+                uint32_t value = evaluateHoldem7CardsHand(deal.knownOpponentsHoleCards[i] | fullBoard);
+
+                bestOpponentsValue = std::max(bestOpponentsValue, value);
+                heroTiesCount += (value == accumulator.heroValue);
+            }
+
+            if (deal.unknownOpponentsCount == 0) {
+                accumulator.add(bestOpponentsValue, heroTiesCount);
+                return;
+            }
+
+            // Every hole cards combination is evaluated once per runout and reused by all unknown opponents
+            Hand remainingCards[CardsCount];
+            unsigned remainingCardsCount = splitToCards((FullDeck ^ deal.usedCards) ^ runout, remainingCards);
+
+            combinations.count = 0;
+
+            for (unsigned i = 0; i < remainingCardsCount; i++) {
+                for (unsigned j = i + 1; j < remainingCardsCount; j++) {
+                    Hand holeCards = remainingCards[i] | remainingCards[j];
+
+                    combinations.hands[combinations.count] = holeCards;
+                    combinations.values[combinations.count] = evaluateHoldem7CardsHand(holeCards | fullBoard);
+                    combinations.count++;
+                }
+            }
+
+            enumerateUnknownOpponents(combinations, 0, deal.unknownOpponentsCount, 0, bestOpponentsValue, heroTiesCount, accumulator);
+        });
+
+        EquityResult result;
+        uint64_t totalCount = accumulator.winCount + accumulator.tieCount + accumulator.loseCount;
+
+        result.winCount = accumulator.winCount;
+        result.tieCount = accumulator.tieCount;
+        result.loseCount = accumulator.loseCount;
+        result.equity = (totalCount != 0) ? accumulator.share / totalCount : 0.0;
+
+        return result;
+    }
+
+    struct SimulationTotals {
+        uint64_t winCount;
+        uint64_t tieCount;
+        uint64_t loseCount;
+        uint64_t shareUnits;        // Sum of hero shares in 1 / ShareUnitsCount units
+        uint64_t shareUnitsSquares; // Sum of squared hero shares in same units
+
+        inline void add(const SimulationTotals& other) noexcept
+        {
+            winCount += other.winCount;
+            tieCount += other.tieCount;
+            loseCount += other.loseCount;
+            shareUnits += other.shareUnits;
+            shareUnitsSquares += other.shareUnitsSquares;
+        }
+    };
+
+    static SimulationTotals simulateBatch(const Deal& deal, const Hand* liveCards, unsigned liveCardsCount, uint64_t seed, uint64_t batchIndex,
+                                          unsigned trialsCount) noexcept
+    {
+        Xoshiro256StarStar random(seed, batchIndex);
+        SimulationTotals totals{};
+        Hand deck[CardsCount];
+        unsigned missingBoardCardsCount = BoardSize - countCards(deal.board);
+        unsigned dealtCardsCount = missingBoardCardsCount + 2 * deal.unknownOpponentsCount;
+
+        std::copy_n(liveCards, liveCardsCount, deck);
+
+        for (unsigned trial = 0; trial < trialsCount; trial++) {
+            // Partial Fisher-Yates shuffle: only first dealtCardsCount cards are randomized
+            for (unsigned i = 0; i < dealtCardsCount; i++) {
+                std::swap(deck[i], deck[i + random(liveCardsCount - i)]);
+            }
+
+            Hand fullBoard = deal.board;
+
+            for (unsigned i = 0; i < missingBoardCardsCount; i++) {
+                fullBoard |= deck[i];
+            }
+
+            uint32_t heroValue = evaluateHoldem7CardsHand(deal.heroHoleCards | fullBoard);
+            uint32_t bestOpponentsValue = 0;
+            unsigned heroTiesCount = 0;
+
+            for (unsigned i = 0; i < deal.knownOpponentsCount; i++) {
+                uint32_t value = evaluateHoldem7CardsHand(deal.knownOpponentsHoleCards[i] | fullBoard);
+
+                bestOpponentsValue = std::max(bestOpponentsValue, value);
+                heroTiesCount += (value == heroValue);
+            }
+
+            for (unsigned i = missingBoardCardsCount; i < dealtCardsCount; i += 2) {
+                uint32_t value = evaluateHoldem7CardsHand(deck[i] | deck[i + 1] | fullBoard);
+
+                bestOpponentsValue = std::max(bestOpponentsValue, value);
+                heroTiesCount += (value == heroValue);
+            }
+
+            if (heroValue > bestOpponentsValue) {
+                totals.winCount++;
+                totals.shareUnits += ShareUnitsCount;
+                totals.shareUnitsSquares += ShareUnitsCount * ShareUnitsCount;
+            } else if (heroValue == bestOpponentsValue) {
+                uint64_t shareUnits = ShareUnitsCount / (heroTiesCount + 1);
+
+                totals.tieCount++;
+                totals.shareUnits += shareUnits;
+                totals.shareUnitsSquares += shareUnits * shareUnits;
+            } else {
+                totals.loseCount++;
+            }
+        }
+
+        return totals;
+    }
+
+    static double calculateStandardError(const SimulationTotals& totals, uint64_t trialsCount) noexcept
+    {
+        if (trialsCount < 2) {
+            return 1.0;
+        }
+
+        double mean = static_cast<double>(totals.shareUnits) / ShareUnitsCount / trialsCount;
+        double meanOfSquares = static_cast<double>(totals.shareUnitsSquares) / ShareUnitsCount / ShareUnitsCount / trialsCount;
+        double variance = std::max(0.0, meanOfSquares - mean * mean) * trialsCount / (trialsCount - 1);
+
+        return std::sqrt(variance / trialsCount);
+    }
+
+    MonteCarloEquityResult simulateEquity(Hand heroHoleCards, const Hand* opponentsHoleCards, unsigned opponentsCount, Hand board, Hand deadCards,
+                                          const MonteCarloOptions& options)
+    {
+        Deal deal = createDeal(heroHoleCards, opponentsHoleCards, opponentsCount, board, deadCards);
+
+        Hand liveCards[CardsCount];
+        unsigned liveCardsCount = splitToCards(FullDeck ^ deal.usedCards, liveCards);
+        uint64_t batchesCount = (options.maxTrialsCount + BatchTrialsCount - 1) / BatchTrialsCount;
+        SimulationTotals totals{};
+        uint64_t trialsCount = 0;
+        double standardError = 1.0;
+
+        for (uint64_t firstBatchIndex = 0; firstBatchIndex < batchesCount; firstBatchIndex += RoundBatchesCount) {
+            unsigned roundBatchesCount = static_cast<unsigned>(std::min<uint64_t>(RoundBatchesCount, batchesCount - firstBatchIndex));
+            SimulationTotals roundTotals[RoundBatchesCount];
+
+            parallelFor(options.threadsCount, roundBatchesCount, [&] (size_t i, unsigned) {
+                uint64_t batchIndex = firstBatchIndex + i;
+                unsigned batchTrialsCount = static_cast<unsigned>(std::min<uint64_t>(BatchTrialsCount, options.maxTrialsCount - batchIndex * BatchTrialsCount));
+
+                roundTotals[i] = simulateBatch(deal, liveCards, liveCardsCount, options.seed, batchIndex, batchTrialsCount);
+            });
+
+            for (unsigned i = 0; i < roundBatchesCount; i++) {
+                totals.add(roundTotals[i]);
+            }
+
+            trialsCount = totals.winCount + totals.tieCount + totals.loseCount;
+            standardError = calculateStandardError(totals, trialsCount);
+
+            if ((options.targetStandardError > 0) && (standardError <= options.targetStandardError)) {
+                break;
+            }
+        }
+
+        MonteCarloEquityResult result;
+
+        result.winCount = totals.winCount;
+        result.tieCount = totals.tieCount;
+        result.loseCount = totals.loseCount;
+        result.equity = (trialsCount != 0) ? static_cast<double>(totals.shareUnits) / ShareUnitsCount / trialsCount : 0.0;
+        result.trialsCount = trialsCount;
+        result.standardError = standardError;
+
+        return result;
+    }
+
+    static constexpr unsigned SuitPermutationsCount = 24;
+    static constexpr unsigned RangeTaskRunoutsCount = 256;
+
+    struct RangeCombination {
+        Hand holeCards;
+        double weight;
+        unsigned firstCardIndex;  // Bit index of card in Hand
+        unsigned secondCardIndex;
+    };
+
+    struct RangeValue {
+        uint32_t value;
+        unsigned index;
+
+        inline bool operator<(const RangeValue& other) const noexcept
+        {
+            return value < other.value;
+        }
+    };
+
+    struct RangeRunout {
+        Hand cards;
+        unsigned stabilizerSize; // Number of board symmetries that map runout to itself
+    };
+
+    struct RangeAccumulator {
+        std::vector<double> winWeights;   // Per hero combination, ties are counted as half
+        std::vector<double> totalWeights; // Per hero combination
+        std::vector<RangeValue> heroValues;
+        std::vector<RangeValue> villainValues;
+        std::vector<double> runoutWinWeights;
+        std::vector<double> runoutTotalWeights;
+    };
+
+    struct CardWeights {
+        double total;
+        double cards[SuitsCount * SuitSizeInBits]; // Indexed by bit index of card in Hand
+
+        inline void add(const RangeCombination& combination) noexcept
+        {
+            total += combination.weight;
+            cards[combination.firstCardIndex] += combination.weight;
+            cards[combination.secondCardIndex] += combination.weight;
+        }
+
+        // Weight of combinations not sharing cards with given one, identicalWeight is weight of same combination if it was added
+        inline double getCompatible(const RangeCombination& combination, double identicalWeight) const noexcept
+        {
+            return total - cards[combination.firstCardIndex] - cards[combination.secondCardIndex] + identicalWeight;
+        }
+    };
+
+    static std::vector<RangeCombination> createRangeCombinations(const std::vector<WeightedHoleCards>& range, std::unordered_map<uint64_t, unsigned>& indexes)
+    {
+        std::vector<RangeCombination> combinations;
+        combinations.reserve(range.size());
+
+        for (const WeightedHoleCards& holeCards : range) {
+            if (countCards(holeCards.holeCards) != 2) {
+                throw std::invalid_argument("Range combination must have exactly 2 cards");
+            } else if (!indexes.emplace(holeCards.holeCards, static_cast<unsigned>(combinations.size())).second) {
+                throw std::invalid_argument("Range combinations must not repeat");
+            }
+
+            uint64_t bits = holeCards.holeCards;
+            unsigned firstCardIndex = __builtin_ctzll(bits);
+            unsigned secondCardIndex = __builtin_ctzll(bits & (bits - 1));
+
+            combinations.push_back(RangeCombination{ holeCards.holeCards, holeCards.weight, firstCardIndex, secondCardIndex });
+        }
+
+        return combinations;
+    }
+
+    // Fills permutedIndexes and returns true if permutation maps range to itself preserving weights
+    static bool getPermutedRangeIndexes(const std::vector<RangeCombination>& range, const std::unordered_map<uint64_t, unsigned>& indexes,
+                                        const Suit* permutation, std::vector<unsigned>& permutedIndexes)
+    {
+        permutedIndexes.resize(range.size());
+
+        for (unsigned i = 0; i < range.size(); i++) {
+            auto iterator = indexes.find(permuteSuits(range[i].holeCards, permutation));
+
+            if ((iterator == indexes.end()) || (range[iterator->second].weight != range[i].weight)) {
+                return false;
+            }
+
+            permutedIndexes[i] = iterator->second;
+        }
+
+        return true;
+    }
+
+    static void evaluateRangeRunout(const std::vector<RangeCombination>& heroRange, const std::vector<RangeCombination>& villainRange,
+                                    const std::vector<double>& identicalVillainWeights, Hand fullBoard, Hand deadCards,
+                                    RangeAccumulator& accumulator) noexcept
+    {
+        Hand usedCards = fullBoard | deadCards; // Combinations holding dead cards can't be dealt
+        accumulator.heroValues.clear();
+        accumulator.villainValues.clear();
+
+        for (unsigned i = 0; i < heroRange.size(); i++) {
+            if ((heroRange[i].holeCards & usedCards) == 0) {
+                accumulator.heroValues.push_back(RangeValue{ evaluateHoldem7CardsHand(heroRange[i].holeCards | fullBoard), i });
+            }
+        }
+
+        for (unsigned i = 0; i < villainRange.size(); i++) {
+            if ((villainRange[i].holeCards & usedCards) == 0) {
+                accumulator.villainValues.push_back(RangeValue{ evaluateHoldem7CardsHand(villainRange[i].holeCards | fullBoard), i });
+            }
+        }
+
+        std::sort(accumulator.heroValues.begin(), accumulator.heroValues.end());
+        std::sort(accumulator.villainValues.begin(), accumulator.villainValues.end());
+
+        CardWeights all{}, lower{}, lowerOrEqual{};
+        size_t lowerCount = 0, lowerOrEqualCount = 0;
+        size_t villainValuesCount = accumulator.villainValues.size();
+
+        for (const RangeValue& villainValue : accumulator.villainValues) {
+            all.add(villainRange[villainValue.index]);
+        }
+
+        // Both lists are sorted, so villain combinations with lower and equal values are only added
+        for (const RangeValue& heroValue : accumulator.heroValues) {
+            for (; (lowerCount < villainValuesCount) && (accumulator.villainValues[lowerCount].value < heroValue.value); lowerCount++) {
+                lower.add(villainRange[accumulator.villainValues[lowerCount].index]);
+            }
+
+            for (; (lowerOrEqualCount < villainValuesCount) && (accumulator.villainValues[lowerOrEqualCount].value <= heroValue.value); lowerOrEqualCount++) {
+                lowerOrEqual.add(villainRange[accumulator.villainValues[lowerOrEqualCount].index]);
+            }
+
+            const RangeCombination& combination = heroRange[heroValue.index];
+            double identicalWeight = identicalVillainWeights[heroValue.index]; // Same combination has same value
+            double winWeight = lower.getCompatible(combination, 0);
+            double tieWeight = lowerOrEqual.getCompatible(combination, identicalWeight) - winWeight;
+
+            accumulator.runoutWinWeights[heroValue.index] = winWeight + tieWeight / 2;
+            accumulator.runoutTotalWeights[heroValue.index] = all.getCompatible(combination, identicalWeight);
+        }
+    }
+
+    RangeEquityResult calculateRangeEquity(const std::vector<WeightedHoleCards>& heroRange, const std::vector<WeightedHoleCards>& villainRange,
+                                           Hand board, Hand deadCards, unsigned threadsCount)
+    {
+        if (countCards(board) > BoardSize) {
+            throw std::invalid_argument("Board must have from 0 to 5 cards");
+        } else if ((board & deadCards) != 0) {
+            throw std::invalid_argument("Cards must not overlap");
+        }
+
+        std::unordered_map<uint64_t, unsigned> heroIndexes, villainIndexes;
+        std::vector<RangeCombination> heroCombinations = createRangeCombinations(heroRange, heroIndexes);
+        std::vector<RangeCombination> villainCombinations = createRangeCombinations(villainRange, villainIndexes);
+        std::vector<double> identicalVillainWeights(heroCombinations.size(), 0.0);
+
+        for (unsigned i = 0; i < heroCombinations.size(); i++) {
+            auto iterator = villainIndexes.find(heroCombinations[i].holeCards);
+
+            if (iterator != villainIndexes.end()) {
+                identicalVillainWeights[i] = villainCombinations[iterator->second].weight;
+            }
+        }
+
+        // Suit permutations that keep board, dead cards and both ranges unchanged
+        std::vector<std::vector<unsigned>> symmetries;
+        Suit permutation[SuitsCount] = { Suit::Clubs, Suit::Diamonds, Suit::Hearts, Suit::Spades };
+        std::vector<unsigned> permutedHeroIndexes, permutedVillainIndexes;
+        std::vector<std::vector<Suit>> permutations;
+
+        do {
+            if ((permuteSuits(board, permutation) == board) && (permuteSuits(deadCards, permutation) == deadCards) &&
+                getPermutedRangeIndexes(heroCombinations, heroIndexes, permutation, permutedHeroIndexes) &&
+                getPermutedRangeIndexes(villainCombinations, villainIndexes, permutation, permutedVillainIndexes)) {
+                symmetries.push_back(permutedHeroIndexes);
+                permutations.emplace_back(permutation, permutation + SuitsCount);
+            }
+        } while (std::next_permutation(permutation, permutation + SuitsCount));
+
+        // Only runouts that are minimal in their symmetry orbit are evaluated
+        std::vector<RangeRunout> runouts;
+        Hand liveCards[CardsCount];
+        unsigned liveCardsCount = splitToCards(FullDeck ^ (board | deadCards), liveCards);
+
+        forEachCombination(liveCards, liveCardsCount, BoardSize - countCards(board), [&] (Hand runout) {
+            unsigned stabilizerSize = 0;
+
+            for (const std::vector<Suit>& suitPermutation : permutations) {
+                Hand permutedRunout = permuteSuits(runout, suitPermutation.data());
+
+                if (permutedRunout < runout) {
+                    return;
+                }
+
+                stabilizerSize += (permutedRunout == runout);
+            }
+
+            runouts.push_back(RangeRunout{ runout, stabilizerSize });
+        });
+
+        threadsCount = resolveThreadsCount(threadsCount);
+        std::vector<RangeAccumulator> accumulators(threadsCount);
+
+        for (RangeAccumulator& accumulator : accumulators) {
+            accumulator.winWeights.assign(heroCombinations.size(), 0.0);
+            accumulator.totalWeights.assign(heroCombinations.size(), 0.0);
+            accumulator.runoutWinWeights.assign(heroCombinations.size(), 0.0);
+            accumulator.runoutTotalWeights.assign(heroCombinations.size(), 0.0);
+        }
+
+        size_t tasksCount = (runouts.size() + RangeTaskRunoutsCount - 1) / RangeTaskRunoutsCount;
+
+        parallelFor(threadsCount, tasksCount, [&] (size_t task, unsigned threadIndex) {
+            RangeAccumulator& accumulator = accumulators[threadIndex];
+            size_t end = std::min(runouts.size(), (task + 1) * RangeTaskRunoutsCount);
+
+            for (size_t i = task * RangeTaskRunoutsCount; i < end; i++) {
+                evaluateRangeRunout(heroCombinations, villainCombinations, identicalVillainWeights, board | runouts[i].cards, deadCards, accumulator);
+
+                // Runout mapped by symmetry gives same results to mapped combinations
+                double multiplier = 1.0 / runouts[i].stabilizerSize;
+
+                for (const std::vector<unsigned>& symmetry : symmetries) {
+                    for (const RangeValue& heroValue : accumulator.heroValues) {
+                        accumulator.winWeights[symmetry[heroValue.index]] += accumulator.runoutWinWeights[heroValue.index] * multiplier;
+                        accumulator.totalWeights[symmetry[heroValue.index]] += accumulator.runoutTotalWeights[heroValue.index] * multiplier;
+                    }
+                }
+            }
+        });
+
+        RangeEquityResult result;
+        double winWeight = 0, totalWeight = 0;
+
+        result.equities.assign(heroCombinations.size(), 0.0);
+
+        for (unsigned i = 0; i < heroCombinations.size(); i++) {
+            double combinationWinWeight = 0, combinationTotalWeight = 0;
+
+            for (const RangeAccumulator& accumulator : accumulators) {
+                combinationWinWeight += accumulator.winWeights[i];
+                combinationTotalWeight += accumulator.totalWeights[i];
+            }
+
+            if (combinationTotalWeight > 0) {
+                result.equities[i] = combinationWinWeight / combinationTotalWeight;
+            }
+
+            winWeight += heroCombinations[i].weight * combinationWinWeight;
+            totalWeight += heroCombinations[i].weight * combinationTotalWeight;
+        }
+
+        result.equity = (totalWeight > 0) ? winWeight / totalWeight : 0.0;
+
+        return result;
+    }
+}
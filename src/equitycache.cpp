@@ -0,0 +1,335 @@
+/* pokertools - tools for poker related coding
+ * Copyright (C) 2016 Andriy Lysnevych
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+#include <pokertools-cpp/equitycache.hpp>
+#include <pokertools-cpp/isomorphism.hpp>
+#include <pokertools-cpp/mappedfile.hpp>
+
+#include <stdexcept>
+#include <algorithm>
+#include <cstring>
+#include <cstddef>
+
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace pokertools
+{
+    static constexpr char EquityCacheFileMagic[8] = { 'P', 'T', 'E', 'Q', 'C', 'A', 'C', 'H' };
+    static constexpr uint32_t EquityCacheFileVersion = 1;
+
+    struct EquityCacheFileHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t recordSize;
+    };
+
+    struct EquityCacheFileRecord {
+        uint64_t key;
+        uint64_t winCount;
+        uint64_t tieCount;
+        uint64_t loseCount;
+        double equity;
+        uint64_t checksum; // Of all fields above, detects torn and padding records
+    };
+
+    static_assert(sizeof(EquityCacheFileHeader) == 16, "Equity cache file header must have no padding");
+    static_assert(sizeof(EquityCacheFileRecord) == 48, "Equity cache file record must have no padding");
+
+    static uint64_t calculateChecksum(const EquityCacheFileRecord& record) noexcept
+    {
+        return calculateFileChecksum(reinterpret_cast<const uint8_t*>(&record), offsetof(EquityCacheFileRecord, checksum));
+    }
+
+    // Situation index is below 2^28, so key fits in 36 bits
+    static uint64_t getKey(Hand heroHoleCards, unsigned opponentsCount, Hand board)
+    {
+        return (static_cast<uint64_t>(getCanonicalSituationIndex(heroHoleCards, board)) << 8) | (countCards(board) << 4) | opponentsCount;
+    }
+
+    static uint64_t mixKey(uint64_t key) noexcept
+    {
+        key = (key ^ (key >> 30)) * 0xBF58476D1CE4E5B9ull;
+        key = (key ^ (key >> 27)) * 0x94D049BB133111EBull;
+
+        return key ^ (key >> 31);
+    }
+
+    static bool writeAll(int fileDescriptor, const void* data, size_t size) noexcept
+    {
+        return write(fileDescriptor, data, size) == static_cast<ssize_t>(size);
+    }
+
+    EquityCache::EquityCache(size_t memoryCapacity, const std::string& fileName, unsigned shardsCount)
+        : fileDescriptor(-1), fileMapping(nullptr), fileMappingSize(0), fileIndexedSize(sizeof(EquityCacheFileHeader)), memoryHits(0), fileHits(0), misses(0)
+    {
+        if (shardsCount == 0) {
+            throw std::invalid_argument("Equity cache must have at least one shard");
+        }
+
+        shardCapacity = std::max<size_t>(1, memoryCapacity / shardsCount);
+
+        for (unsigned i = 0; i < shardsCount; i++) {
+            shards.emplace_back(new Shard());
+        }
+
+        if (fileName.empty()) {
+            return;
+        }
+
+        fileDescriptor = open(fileName.c_str(), O_RDWR | O_CREAT | O_APPEND, 0644);
+
+        if (fileDescriptor == -1) {
+            throw std::runtime_error("Can't open equity cache file " + fileName);
+        }
+
+        // Lock makes sure that only one of processes creating file writes header
+        flock(fileDescriptor, LOCK_EX);
+
+        struct stat fileStatus;
+        EquityCacheFileHeader header{};
+        const char* error = nullptr;
+
+        if (fstat(fileDescriptor, &fileStatus) != 0) {
+            error = "Can't read equity cache file ";
+        } else if (fileStatus.st_size == 0) {
+            std::copy_n(EquityCacheFileMagic, sizeof(header.magic), header.magic);
+            header.version = EquityCacheFileVersion;
+            header.recordSize = sizeof(EquityCacheFileRecord);
+
+            if (!writeAll(fileDescriptor, &header, sizeof(header))) {
+                error = "Can't write equity cache file ";
+            }
+        } else if (pread(fileDescriptor, &header, sizeof(header), 0) != sizeof(header) ||
+                   !std::equal(header.magic, header.magic + sizeof(header.magic), EquityCacheFileMagic)) {
+            error = "Not an equity cache file ";
+        } else if ((header.version != EquityCacheFileVersion) || (header.recordSize != sizeof(EquityCacheFileRecord))) {
+            error = "Unsupported version of equity cache file ";
+        }
+
+        flock(fileDescriptor, LOCK_UN);
+
+        if (error) {
+            close(fileDescriptor);
+            throw std::runtime_error(error + fileName);
+        }
+
+        if (fstat(fileDescriptor, &fileStatus) == 0) {
+            indexFileRecords(fileStatus.st_size);
+        }
+    }
+
+    EquityCache::~EquityCache()
+    {
+        if (fileMapping) {
+            munmap(const_cast<uint8_t*>(fileMapping), fileMappingSize);
+        }
+
+        if (fileDescriptor != -1) {
+            close(fileDescriptor);
+        }
+    }
+
+    EquityResult EquityCache::getEquity(Hand heroHoleCards, unsigned opponentsCount, Hand board)
+    {
+        if (countCards(heroHoleCards) != 2) {
+            throw std::invalid_argument("Hero must have exactly 2 hole cards");
+        } else if ((opponentsCount == 0) || (opponentsCount > MaxOpponentsCount)) {
+            throw std::invalid_argument("Number of opponents must be from 1 to 9");
+        } else if ((countCards(board) < 3) || (countCards(board) > 5)) {
+            throw std::invalid_argument("Board must have from 3 to 5 cards");
+        } else if ((heroHoleCards & board) != 0) {
+            throw std::invalid_argument("Cards must not overlap");
+        }
+
+        uint64_t key = getKey(heroHoleCards, opponentsCount, board);
+        EquityResult result;
+
+        if (findInMemory(key, result)) {
+            memoryHits++;
+            return result;
+        }
+
+        if (findInFile(key, result)) {
+            fileHits++;
+            addToMemory(key, result);
+            return result;
+        }
+
+        misses++;
+
+        // Isomorphic situations have the same result, canonical one makes it independent of query
+        CanonicalForm canonicalForm = canonicalize(heroHoleCards, board);
+        Hand opponentsHoleCards[MaxOpponentsCount] = {};
+        result = enumerateEquity(canonicalForm.holeCards, opponentsHoleCards, opponentsCount, canonicalForm.board);
+
+        addToMemory(key, result);
+        addToFile(key, result);
+
+        return result;
+    }
+
+    EquityCacheStatistics EquityCache::getStatistics() const noexcept
+    {
+        return EquityCacheStatistics{ memoryHits.load(), fileHits.load(), misses.load() };
+    }
+
+    bool EquityCache::findInMemory(uint64_t key, EquityResult& result)
+    {
+        Shard& shard = *shards[mixKey(key) % shards.size()];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        auto position = shard.positions.find(key);
+
+        if (position == shard.positions.end()) {
+            return false;
+        }
+
+        shard.entries.splice(shard.entries.begin(), shard.entries, position->second);
+        result = position->second->second;
+
+        return true;
+    }
+
+    void EquityCache::addToMemory(uint64_t key, const EquityResult& result)
+    {
+        Shard& shard = *shards[mixKey(key) % shards.size()];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        if (shard.positions.count(key) != 0) {
+            return; // Other thread computed the same result
+        }
+
+        if (shard.entries.size() >= shardCapacity) {
+            shard.positions.erase(shard.entries.back().first);
+            shard.entries.pop_back();
+        }
+
+        shard.entries.emplace_front(key, result);
+        shard.positions[key] = shard.entries.begin();
+    }
+
+    bool EquityCache::findInFile(uint64_t key, EquityResult& result)
+    {
+        if (fileDescriptor == -1) {
+            return false;
+        }
+
+        {
+            std::shared_lock<std::shared_timed_mutex> lock(fileIndexMutex);
+
+            if (findFileRecord(key, result)) {
+                return true;
+            }
+        }
+
+        // Other processes may have appended it, but file is indexed again only when it grew
+        struct stat fileStatus;
+
+        if ((fstat(fileDescriptor, &fileStatus) != 0) || (static_cast<size_t>(fileStatus.st_size) <= fileMappingSize)) {
+            return false;
+        }
+
+        std::lock_guard<std::shared_timed_mutex> lock(fileIndexMutex);
+        indexFileRecords(fileStatus.st_size);
+
+        return findFileRecord(key, result);
+    }
+
+    // Caller holds fileIndexMutex
+    bool EquityCache::findFileRecord(uint64_t key, EquityResult& result) const
+    {
+        auto offset = fileRecordsOffsets.find(key);
+
+        if (offset == fileRecordsOffsets.end()) {
+            return false;
+        }
+
+        EquityCacheFileRecord record;
+        std::memcpy(&record, fileMapping + offset->second, sizeof(record));
+        result = EquityResult{ record.winCount, record.tieCount, record.loseCount, record.equity };
+
+        return true;
+    }
+
+    void EquityCache::addToFile(uint64_t key, const EquityResult& result)
+    {
+        if (fileDescriptor == -1) {
+            return;
+        }
+
+        EquityCacheFileRecord record{ key, result.winCount, result.tieCount, result.loseCount, result.equity, 0 };
+        record.checksum = calculateChecksum(record);
+
+        std::lock_guard<std::mutex> lock(fileMutex);
+        flock(fileDescriptor, LOCK_EX);
+
+        // Pads torn record of crashed writer, so records stay aligned
+        struct stat fileStatus;
+
+        if (fstat(fileDescriptor, &fileStatus) == 0) {
+            size_t tail = (fileStatus.st_size - sizeof(EquityCacheFileHeader)) % sizeof(EquityCacheFileRecord);
+
+            if (tail != 0) {
+                uint8_t padding[sizeof(EquityCacheFileRecord)] = {};
+                writeAll(fileDescriptor, padding, sizeof(record) - tail);
+            }
+
+            writeAll(fileDescriptor, &record, sizeof(record)); // File tier is best effort, result is in memory anyway
+        }
+
+        flock(fileDescriptor, LOCK_UN);
+    }
+
+    // Maps file again when it grew and indexes new records. Caller holds fileIndexMutex exclusively.
+    void EquityCache::indexFileRecords(size_t fileSize)
+    {
+        if (fileSize <= fileMappingSize) {
+            return; // Other thread has indexed it already
+        }
+
+        void* mapping = mmap(nullptr, fileSize, PROT_READ, MAP_SHARED, fileDescriptor, 0);
+
+        if (mapping == MAP_FAILED) {
+            return;
+        }
+
+        if (fileMapping) {
+            munmap(const_cast<uint8_t*>(fileMapping), fileMappingSize);
+        }
+
+        fileMapping = static_cast<const uint8_t*>(mapping);
+        fileMappingSize = fileSize;
+
+        size_t offset = fileIndexedSize;
+
+        for (; offset + sizeof(EquityCacheFileRecord) <= fileMappingSize; offset += sizeof(EquityCacheFileRecord)) {
+            EquityCacheFileRecord record;
+            std::memcpy(&record, fileMapping + offset, sizeof(record));
+
+            if (record.checksum == calculateChecksum(record)) {
+                fileRecordsOffsets.emplace(record.key, offset);
+            }
+        }
+
+        fileIndexedSize = offset; // Incomplete record at the end is indexed after it's padded
+    }
+}
@@ -17,66 +17,38 @@
  */
 
 #include <pokertools-cpp/evaluators.hpp>
+#include "tables.hpp"
+#include "values.hpp"
+#include "lowball.hpp"
+#include "perfecthash.hpp"
 
 #include <bitset>
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
 
 namespace pokertools
 {
-    static uint8_t* numberOfBits;
-    static uint16_t* rankOfStraights;
-    static uint16_t* highUpTo5Bits;
-    static uint16_t* highBit;
-    static uint16_t* highUpTo3Bits;
-    static std::unique_ptr<uint8_t, std::function<void(uint8_t*)>> buffer;
-
-    static constexpr unsigned HandTypeInValueShift = 28;
-
-    static inline uint32_t calculateStraightFlushValue(uint16_t highCardRank) noexcept
-    {
-        return (static_cast<uint32_t>(HandType::StraightFulsh) << HandTypeInValueShift) | highCardRank;
-    }
-
-    static inline uint32_t calculateFourOfAKindValue(uint16_t quadsRank, uint16_t kickerRank) noexcept
-    {
-        return (static_cast<uint32_t>(HandType::FourOfAKind) << HandTypeInValueShift) | (static_cast<uint32_t>(quadsRank) << RanksCount) | kickerRank;
-    }
-
-    static inline uint32_t calculateFullHouseValue(uint16_t tripsRank, uint16_t pairRank) noexcept
-    {
-        return (static_cast<uint32_t>(HandType::FullHouse) << HandTypeInValueShift) | (static_cast<uint32_t>(tripsRank) << RanksCount) | pairRank;
-    }
-
-    static inline uint32_t calculateFlushValue(uint16_t fiveCardsRanks) noexcept
-    {
-        return (static_cast<uint32_t>(HandType::Flush) << HandTypeInValueShift) | fiveCardsRanks;
-    }
-
-    static inline uint32_t calculateStraightValue(uint16_t highCardRank) noexcept
+    /**
+     * Used by free evaluation functions. Function local static is initialized
+     * on first use, so static initializers of other translation units can
+     * evaluate hands regardless of initialization order.
+     */
+    static Evaluator& getDefaultEvaluator() noexcept
     {
-        return (static_cast<uint32_t>(HandType::Straight) << HandTypeInValueShift) | highCardRank;
+        static Evaluator evaluator;
+        return evaluator;
     }
 
-    static inline uint32_t calculateThreeOfAKindValue(uint16_t tripsRank, uint16_t twoKickersRanks) noexcept
-    {
-        return (static_cast<uint32_t>(HandType::ThreeOfAKind) << HandTypeInValueShift) | (static_cast<uint32_t>(tripsRank) << RanksCount) | twoKickersRanks;
-    }
-
-    static inline uint32_t calculateTwoPairValue(uint16_t pairsRanks, uint16_t kickerRank) noexcept
-    {
-        return (static_cast<uint32_t>(HandType::TwoPair) << HandTypeInValueShift) | (static_cast<uint32_t>(pairsRanks) << RanksCount) | kickerRank;
-    }
-
-    static inline uint32_t calculatePairValue(uint16_t pairRank, uint16_t threeKickersRanks) noexcept
-    {
-        return (static_cast<uint32_t>(HandType::Pair) << HandTypeInValueShift) | (static_cast<uint32_t>(pairRank) << RanksCount) | threeKickersRanks;
-    }
+    using ScalarEvaluator = uint32_t (Evaluator::*)(Hand hand) const;
 
-    static inline uint32_t calculateHighCardValue(uint16_t fiveCardsRanks) noexcept
-    {
-        return (static_cast<uint32_t>(HandType::HighCard) << HandTypeInValueShift) | fiveCardsRanks;
-    }
+    // Evaluators below are shared by Hold'em and Short Deck that differ by straights table
+    // and order of Flush and Full House. With up to 7 cards Flush can't be combined with
+    // Full House or Four of a Kind, so order of hand types affects only encoding of values.
 
-    uint32_t evaluateHoldem7CardsHand(Hand hand) noexcept
+    inline uint32_t Evaluator::evaluate7CardsHand(Hand hand, const uint16_t* straights) const noexcept
     {
         assert(std::bitset<64>(hand).count() == 7);
 
@@ -90,35 +62,35 @@ namespace pokertools
 
         if (ranksCount >= 5) { // Straight, Fulsh or Straight Flush is possible
             if (numberOfBits[clubs] >= 5) {
-                uint16_t straightRank = rankOfStraights[clubs];
+                uint16_t straightRank = straights[clubs];
                 if (straightRank == 0) { // Flush
                     return calculateFlushValue(highUpTo5Bits[clubs]);
                 } else { // Straight Flush
                     return calculateStraightFlushValue(straightRank);
                 }
             } else if (numberOfBits[diamonds] >= 5) {
-                uint16_t straightRank = rankOfStraights[diamonds];
+                uint16_t straightRank = straights[diamonds];
                 if (straightRank == 0) { // Flush
                     return calculateFlushValue(highUpTo5Bits[diamonds]);
                 } else { // Straight Flush
                     return calculateStraightFlushValue(straightRank);
                 }
             } else if (numberOfBits[hearts] >= 5) {
-                uint16_t straightRank = rankOfStraights[hearts];
+                uint16_t straightRank = straights[hearts];
                 if (straightRank == 0) { // Flush
                     return calculateFlushValue(highUpTo5Bits[hearts]);
                 } else { // Straight Flush
                     return calculateStraightFlushValue(straightRank);
                 }
             } else if (numberOfBits[spades] >= 5) {
-                uint16_t straightRank = rankOfStraights[spades];
+                uint16_t straightRank = straights[spades];
                 if (straightRank == 0) { // Flush
                     return calculateFlushValue(highUpTo5Bits[spades]);
                 } else { // Straight Flush
                     return calculateStraightFlushValue(straightRank);
                 }
             } else {
-                uint16_t straightRank = rankOfStraights[ranks];
+                uint16_t straightRank = straights[ranks];
                 if (straightRank != 0) { // Straight
                     return calculateStraightValue(straightRank);
                 }
@@ -217,7 +189,136 @@ namespace pokertools
         }
     }
 
-    uint32_t evaluateHoldem5CardsHand(Hand hand) noexcept
+    // Same as evaluate7CardsHand with Hold'em straights, but all ranks masks fields come from one packed table
+    inline uint32_t Evaluator::evaluate7CardsHandPacked(Hand hand) const noexcept
+    {
+        assert(std::bitset<64>(hand).count() == 7);
+
+        uint16_t clubs = hand.suit(Suit::Clubs);
+        uint16_t diamonds = hand.suit(Suit::Diamonds);
+        uint16_t hearts = hand.suit(Suit::Hearts);
+        uint16_t spades = hand.suit(Suit::Spades);
+
+        uint16_t ranks = clubs | diamonds | hearts | spades;
+        uint16_t packedRanksFields = packedRanks[ranks];
+        unsigned ranksCount = tables::unpackNumberOfBits(packedRanksFields);
+
+        if (ranksCount >= 5) { // Straight, Fulsh or Straight Flush is possible
+            uint16_t flushRanks = 0;
+            uint16_t packedFlushFields = 0;
+
+            if (tables::unpackNumberOfBits(packedFlushFields = packedRanks[clubs]) >= 5) {
+                flushRanks = clubs;
+            } else if (tables::unpackNumberOfBits(packedFlushFields = packedRanks[diamonds]) >= 5) {
+                flushRanks = diamonds;
+            } else if (tables::unpackNumberOfBits(packedFlushFields = packedRanks[hearts]) >= 5) {
+                flushRanks = hearts;
+            } else if (tables::unpackNumberOfBits(packedFlushFields = packedRanks[spades]) >= 5) {
+                flushRanks = spades;
+            }
+
+            if (flushRanks != 0) {
+                uint16_t straightRank = tables::unpackRankOfStraight(packedFlushFields);
+                if (straightRank == 0) { // Flush
+                    return calculateFlushValue(tables::unpackHighUpTo5Bits(flushRanks, packedFlushFields));
+                } else { // Straight Flush
+                    return calculateStraightFlushValue(straightRank);
+                }
+            }
+
+            uint16_t straightRank = tables::unpackRankOfStraight(packedRanksFields);
+            if (straightRank != 0) { // Straight
+                return calculateStraightValue(straightRank);
+            }
+        }
+
+        // Masks of exactly one rank are detected by clearing the lowest bit instead of numberOfBits lookups
+        switch (ranksCount) {
+        case 2: { // 2 ranks = [4, 3]
+            uint16_t quadsRank = clubs & diamonds & hearts & spades;
+            uint16_t tripsRank = ranks ^ quadsRank;
+
+            return calculateFourOfAKindValue(quadsRank, tripsRank);
+        }
+
+        case 3: { // 3 ranks = [3, 3, 1] or [3, 2, 2] or [4, 2, 1]
+            uint16_t singletonAndTripsRanks = clubs ^ diamonds ^ hearts ^ spades;
+
+            if ((singletonAndTripsRanks & (singletonAndTripsRanks - 1)) == 0) { // [4, 2, 1] or [3, 2, 2]
+                uint16_t quadsRank = clubs & diamonds & hearts & spades;
+                if (quadsRank == 0) { // Full House = [3, 2, 2]
+                    uint16_t pairsRanks = ranks ^ singletonAndTripsRanks;
+
+                    return calculateFullHouseValue(singletonAndTripsRanks, tables::getHighBit(pairsRanks));
+                } else { // Four of a Kind = [4, 2, 1]
+                    uint16_t otherRanks = ranks ^ quadsRank;
+
+                    return calculateFourOfAKindValue(quadsRank, tables::getHighBit(otherRanks));
+                }
+            } else { // Full House = [3, 3, 1]
+                uint16_t tripsRanks = ((clubs & diamonds) | (hearts & spades));
+                uint16_t highTripsRank = tables::getHighBit(tripsRanks);
+
+                return calculateFullHouseValue(highTripsRank, tripsRanks ^ highTripsRank);
+            }
+        }
+
+        case 4: { // 4 ranks = [2, 2, 2, 1] or [3, 2, 1, 1] or [4, 1, 1, 1]
+            uint16_t singletonsAndTripsRanks = clubs ^ diamonds ^ hearts ^ spades;
+
+            if ((singletonsAndTripsRanks & (singletonsAndTripsRanks - 1)) == 0) { // Two Pair = [2, 2, 2, 1]
+                uint16_t threePairsRanks = ranks ^ singletonsAndTripsRanks;
+                uint16_t highPairRank = tables::getHighBit(threePairsRanks);
+                uint16_t secondPairRank = tables::getHighBit(threePairsRanks ^ highPairRank);
+                uint16_t kickerRank = tables::getHighBit(ranks ^ highPairRank ^ secondPairRank);
+
+                return calculateTwoPairValue(highPairRank | secondPairRank, kickerRank);
+            } else {
+                uint16_t quadsRank = clubs & diamonds & hearts & spades;
+                if (quadsRank == 0) { // Full House = [3, 2, 1, 1]
+                    uint16_t pairRank = ranks ^ singletonsAndTripsRanks;
+                    uint16_t tripsRank = ((clubs & diamonds) | (hearts & spades)) & (~pairRank);
+
+                    return calculateFullHouseValue(tripsRank, pairRank);
+                } else { // Four of a Kind = [4, 1, 1, 1]
+                    return calculateFourOfAKindValue(quadsRank, tables::getHighBit(singletonsAndTripsRanks));
+                }
+            }
+        }
+
+        case 5: { // 5 ranks = [3, 1, 1, 1, 1] or [2, 2, 1, 1, 1]
+            uint16_t singletonsAndTripsRanks = clubs ^ diamonds ^ hearts ^ spades;
+            uint16_t pairsRanks = ranks ^ singletonsAndTripsRanks;
+
+            if (pairsRanks != 0) { // Two Pairs = [2, 2, 1, 1, 1]
+                return calculateTwoPairValue(pairsRanks, tables::getHighBit(singletonsAndTripsRanks));
+            } else { // Three of a Kind = [3, 1, 1, 1, 1]
+                uint16_t tripsRank = (clubs & diamonds) | (hearts & spades);
+                uint16_t kickersRanks = ranks ^ tripsRank;
+                uint16_t firstKickerRank = tables::getHighBit(kickersRanks);
+                uint16_t secondKickerRank = tables::getHighBit(kickersRanks ^ firstKickerRank);
+
+                return calculateThreeOfAKindValue(tripsRank, firstKickerRank | secondKickerRank);
+            }
+        }
+
+        case 6: { // 6 ranks = [2, 1, 1, 1, 1, 1] = Pair
+            uint16_t singletonsRanks = clubs ^ diamonds ^ hearts ^ spades;
+            uint16_t pairRank = ranks ^ singletonsRanks;
+
+            return calculatePairValue(pairRank, tables::unpackHighUpTo3Bits(singletonsRanks, packedRanks[singletonsRanks]));
+        }
+
+        case 7: // 7 ranks = [1, 1, 1, 1, 1, 1, 1] = High Card
+            return calculateHighCardValue(tables::unpackHighUpTo5Bits(ranks, packedRanksFields));
+
+        default:
+            assert(0); // Impossible if hand is valid
+            return 0;
+        }
+    }
+
+    inline uint32_t Evaluator::evaluate5CardsHand(Hand hand, const uint16_t* straights) const noexcept
     {
         assert(std::bitset<64>(hand).count() == 5);
 
@@ -232,35 +333,35 @@ namespace pokertools
         switch (ranksCount) {
             case 5: { // Straight, Fulsh, Straight Flush or High Card
                 if (numberOfBits[clubs] == 5) {
-                    uint16_t straightRank = rankOfStraights[clubs];
+                    uint16_t straightRank = straights[clubs];
                     if (straightRank == 0) { // Flush
                         return calculateFlushValue(clubs);
                     } else { // Straight Flush
                         return calculateStraightFlushValue(straightRank);
                     }
                 } else if (numberOfBits[diamonds] == 5) {
-                    uint16_t straightRank = rankOfStraights[diamonds];
+                    uint16_t straightRank = straights[diamonds];
                     if (straightRank == 0) { // Flush
                         return calculateFlushValue(diamonds);
                     } else { // Straight Flush
                         return calculateStraightFlushValue(straightRank);
                     }
                 } else if (numberOfBits[hearts] == 5) {
-                    uint16_t straightRank = rankOfStraights[hearts];
+                    uint16_t straightRank = straights[hearts];
                     if (straightRank == 0) { // Flush
                         return calculateFlushValue(hearts);
                     } else { // Straight Flush
                         return calculateStraightFlushValue(straightRank);
                     }
                 } else if (numberOfBits[spades] == 5) {
-                    uint16_t straightRank = rankOfStraights[spades];
+                    uint16_t straightRank = straights[spades];
                     if (straightRank == 0) { // Flush
                         return calculateFlushValue(spades);
                     } else { // Straight Flush
                         return calculateStraightFlushValue(straightRank);
                     }
                 } else {
-                    uint16_t straightRank = rankOfStraights[ranks];
+                    uint16_t straightRank = straights[ranks];
                     if (straightRank == 0) { // High Card
                         return calculateHighCardValue(ranks);
                     } else { // Straight
@@ -310,7 +411,101 @@ namespace pokertools
         }
     }
 
-    uint32_t evaluateHoldemHand(Hand hand, unsigned cardsCount) noexcept
+    inline uint32_t Evaluator::evaluateFlush(uint16_t flushRanks, const uint16_t* straights) const noexcept
+    {
+        uint16_t straightRank = straights[flushRanks];
+        if (straightRank == 0) { // Flush
+            return calculateFlushValue(highUpTo5Bits[flushRanks]);
+        } else { // Straight Flush
+            return calculateStraightFlushValue(straightRank);
+        }
+    }
+
+    // With 6 cards Flush or Straight leaves at most a pair, so hands of 5 or 6 ranks are resolved
+    // right after Flush and Straight checks. Branches go in order of hand types frequency.
+    inline uint32_t Evaluator::evaluate6CardsHand(Hand hand, const uint16_t* straights) const noexcept
+    {
+        assert(std::bitset<64>(hand).count() == 6);
+
+        uint16_t clubs = hand.suit(Suit::Clubs);
+        uint16_t diamonds = hand.suit(Suit::Diamonds);
+        uint16_t hearts = hand.suit(Suit::Hearts);
+        uint16_t spades = hand.suit(Suit::Spades);
+
+        uint16_t ranks = clubs | diamonds | hearts | spades;
+        uint8_t ranksCount = numberOfBits[ranks];
+        uint16_t singletonsAndTripsRanks = clubs ^ diamonds ^ hearts ^ spades;
+
+        if (ranksCount >= 5) { // 6 ranks = [1, 1, 1, 1, 1, 1] or 5 ranks = [2, 1, 1, 1, 1]
+            if (numberOfBits[clubs] >= 5) {
+                return evaluateFlush(clubs, straights);
+            } else if (numberOfBits[diamonds] >= 5) {
+                return evaluateFlush(diamonds, straights);
+            } else if (numberOfBits[hearts] >= 5) {
+                return evaluateFlush(hearts, straights);
+            } else if (numberOfBits[spades] >= 5) {
+                return evaluateFlush(spades, straights);
+            }
+
+            uint16_t straightRank = straights[ranks];
+            if (straightRank != 0) { // Straight
+                return calculateStraightValue(straightRank);
+            }
+
+            if (ranksCount == 6) { // High Card
+                return calculateHighCardValue(highUpTo5Bits[ranks]);
+            }
+
+            // Pair
+            return calculatePairValue(ranks ^ singletonsAndTripsRanks, highUpTo3Bits[singletonsAndTripsRanks]);
+        }
+
+        if (ranksCount == 4) { // 4 ranks = [2, 2, 1, 1] or [3, 1, 1, 1]
+            uint16_t pairsRanks = ranks ^ singletonsAndTripsRanks;
+
+            if (pairsRanks != 0) { // Two Pair = [2, 2, 1, 1]
+                return calculateTwoPairValue(pairsRanks, highBit[singletonsAndTripsRanks]);
+            } else { // Three of a Kind = [3, 1, 1, 1]
+                uint16_t tripsRank = (clubs & diamonds) | (hearts & spades);
+                uint16_t kickersRanks = ranks ^ tripsRank;
+                uint16_t firstKickerRank = highBit[kickersRanks];
+                uint16_t secondKickerRank = highBit[kickersRanks ^ firstKickerRank];
+
+                return calculateThreeOfAKindValue(tripsRank, firstKickerRank | secondKickerRank);
+            }
+        }
+
+        uint16_t quadsRank = clubs & diamonds & hearts & spades;
+
+        if (ranksCount == 3) { // 3 ranks = [2, 2, 2] or [3, 2, 1] or [4, 1, 1]
+            if (singletonsAndTripsRanks == 0) { // Two Pair = [2, 2, 2]
+                uint16_t highPairRank = highBit[ranks];
+                uint16_t secondPairRank = highBit[ranks ^ highPairRank];
+                uint16_t kickerRank = ranks ^ highPairRank ^ secondPairRank;
+
+                return calculateTwoPairValue(highPairRank | secondPairRank, kickerRank);
+            } else if (quadsRank == 0) { // Full House = [3, 2, 1]
+                uint16_t pairRank = ranks ^ singletonsAndTripsRanks;
+                uint16_t tripsRank = ((clubs & diamonds) | (hearts & spades)) & (~pairRank);
+
+                return calculateFullHouseValue(tripsRank, pairRank);
+            } else { // Four of a Kind = [4, 1, 1]
+                return calculateFourOfAKindValue(quadsRank, highBit[ranks ^ quadsRank]);
+            }
+        }
+
+        assert(ranksCount == 2); // Impossible otherwise if hand is valid
+
+        if (quadsRank == 0) { // Full House = [3, 3]
+            uint16_t highTripsRank = highBit[ranks];
+
+            return calculateFullHouseValue(highTripsRank, ranks ^ highTripsRank);
+        } else { // Four of a Kind = [4, 2]
+            return calculateFourOfAKindValue(quadsRank, ranks ^ quadsRank);
+        }
+    }
+
+    inline uint32_t Evaluator::evaluateHand(Hand hand, unsigned cardsCount, const uint16_t* straights) const noexcept
     {
         assert((cardsCount >= 5) && (cardsCount <= 7));
         assert(std::bitset<64>(hand).count() == cardsCount);
@@ -327,35 +522,35 @@ namespace pokertools
 
         if (ranksCount >= 5) { // Straight, Fulsh or Straight Flush is possible
             if (numberOfBits[clubs] >= 5) {
-                uint16_t straightRank = rankOfStraights[clubs];
+                uint16_t straightRank = straights[clubs];
                 if (straightRank == 0) {
                     flushOrStraightValue = calculateFlushValue(highUpTo5Bits[clubs]);
                 } else {
                     return calculateStraightFlushValue(straightRank);
                 }
             } else if (numberOfBits[diamonds] >= 5) {
-                uint16_t straightRank = rankOfStraights[diamonds];
+                uint16_t straightRank = straights[diamonds];
                 if (straightRank == 0) {
                     flushOrStraightValue = calculateFlushValue(highUpTo5Bits[diamonds]);
                 } else {
                     return calculateStraightFlushValue(straightRank);
                 }
             } else if (numberOfBits[hearts] >= 5) {
-                uint16_t straightRank = rankOfStraights[hearts];
+                uint16_t straightRank = straights[hearts];
                 if (straightRank == 0) {
                     flushOrStraightValue = calculateFlushValue(highUpTo5Bits[hearts]);
                 } else {
                     return calculateStraightFlushValue(straightRank);
                 }
             } else if (numberOfBits[spades] >= 5) {
-                uint16_t straightRank = rankOfStraights[spades];
+                uint16_t straightRank = straights[spades];
                 if (straightRank == 0) {
                     flushOrStraightValue = calculateFlushValue(highUpTo5Bits[spades]);
                 } else {
                     return calculateStraightFlushValue(straightRank);
                 }
             } else {
-                uint16_t straightRank = rankOfStraights[ranks];
+                uint16_t straightRank = straights[ranks];
                 if (straightRank) {
                     flushOrStraightValue = calculateStraightValue(straightRank);
                 }
@@ -429,74 +624,574 @@ namespace pokertools
         }
     }
 
-    static uint16_t getRankOfStraight(uint16_t ranks) noexcept
+    uint32_t Evaluator::evaluateHoldem7CardsHand(Hand hand) const noexcept
     {
-        uint16_t straightMask = 0b1111100000000;
+        if (perfectHashTables) {
+            return perfecthash::evaluate7CardsHand(*perfectHashTables, hand);
+        } else if (engine == EvaluatorEngine::Packed) {
+            return evaluate7CardsHandPacked(hand);
+        }
 
-        for (int i = 8; i >= 0; i--) {
-            if ((ranks & straightMask) == straightMask) {
-                return 1 << (i + 4);
-            }
-            straightMask >>= 1;
+        return evaluate7CardsHand(hand, rankOfStraights);
+    }
+
+    uint32_t Evaluator::evaluateHoldem6CardsHand(Hand hand) const noexcept
+    {
+        return evaluate6CardsHand(hand, rankOfStraights);
+    }
+
+    uint32_t Evaluator::evaluateHoldem5CardsHand(Hand hand) const noexcept
+    {
+        return evaluate5CardsHand(hand, rankOfStraights);
+    }
+
+    uint32_t Evaluator::evaluateHoldemHand(Hand hand, unsigned cardsCount) const noexcept
+    {
+        return evaluateHand(hand, cardsCount, rankOfStraights);
+    }
+
+    static inline bool isShortDeckHand(Hand hand) noexcept
+    {
+        return (hand & 0b0000000000001111000000000000111100000000000011110000000000001111) == 0;
+    }
+
+    uint32_t Evaluator::evaluateShortDeck7CardsHand(Hand hand) const noexcept
+    {
+        assert(isShortDeckHand(hand));
+        return toShortDeckValue(evaluate7CardsHand(hand, tables::shortDeckRankOfStraights.values));
+    }
+
+    uint32_t Evaluator::evaluateShortDeck5CardsHand(Hand hand) const noexcept
+    {
+        assert(isShortDeckHand(hand));
+        return toShortDeckValue(evaluate5CardsHand(hand, tables::shortDeckRankOfStraights.values));
+    }
+
+    uint32_t Evaluator::evaluateShortDeckHand(Hand hand, unsigned cardsCount) const noexcept
+    {
+        assert(isShortDeckHand(hand));
+        return toShortDeckValue(evaluateHand(hand, cardsCount, tables::shortDeckRankOfStraights.values));
+    }
+
+    uint32_t Evaluator::evaluateDeuceToSevenLowHand(Hand hand) const noexcept
+    {
+        return toLowValue(evaluate5CardsHand(hand, tables::deuceToSevenRankOfStraights.values));
+    }
+
+    HiLoValues Evaluator::evaluateHiLoHand(Hand hand, unsigned cardsCount) const noexcept
+    {
+        // Both inlined evaluators share suits loads and ranks mask
+        uint16_t ranks = hand.suit(Suit::Clubs) | hand.suit(Suit::Diamonds) | hand.suit(Suit::Hearts) | hand.suit(Suit::Spades);
+
+        return HiLoValues{evaluateHand(hand, cardsCount, rankOfStraights), evaluateEightOrBetterLow(ranks)};
+    }
+
+    uint32_t evaluateAceToFiveLowHand(Hand hand, unsigned cardsCount) noexcept
+    {
+        assert((cardsCount >= 5) && (cardsCount <= 7));
+        assert(countCards(hand) == cardsCount);
+
+        return evaluateAceToFiveLow(hand.suit(Suit::Clubs), hand.suit(Suit::Diamonds), hand.suit(Suit::Hearts), hand.suit(Suit::Spades));
+    }
+
+    uint32_t evaluateEightOrBetterLowHand(Hand hand) noexcept
+    {
+        assert((countCards(hand) >= 5) && (countCards(hand) <= 7));
+
+        return evaluateEightOrBetterLow(hand.suit(Suit::Clubs) | hand.suit(Suit::Diamonds) | hand.suit(Suit::Hearts) | hand.suit(Suit::Spades));
+    }
+
+#if defined(__x86_64__) || defined(__i386__)
+    // Batch evaluators below compute value of every hand category in all lanes and
+    // pick the maximum one. Category of invalid candidates is zeroed, so result is
+    // the same as evaluateHoldem7CardsHand returns, but without data dependent branches.
+    // Nothing depends on number of cards, so they also evaluate 5 and 6 cards hands,
+    // and hands left after the last full vector go to scalar evaluateTail.
+
+    __attribute__((target("avx2")))
+    static inline __m256i gatherAvx2(const uint16_t* table, __m256i indexes) noexcept
+    {
+        return _mm256_and_si256(_mm256_i32gather_epi32(reinterpret_cast<const int*>(table), indexes, sizeof(uint16_t)), _mm256_set1_epi32(0xFFFF));
+    }
+
+    __attribute__((target("avx2")))
+    static inline __m256i highBitAvx2(__m256i ranks) noexcept
+    {
+        // Exponent of float representation is index of the highest bit, zero gives shift out of range
+        __m256i exponent = _mm256_srli_epi32(_mm256_castps_si256(_mm256_cvtepi32_ps(ranks)), 23);
+        return _mm256_sllv_epi32(_mm256_set1_epi32(1), _mm256_sub_epi32(exponent, _mm256_set1_epi32(127)));
+    }
+
+    __attribute__((target("avx2")))
+    static inline __m256i numberOfBitsInSuitsAvx2(__m256i suits) noexcept
+    {
+        suits = _mm256_sub_epi16(suits, _mm256_and_si256(_mm256_srli_epi16(suits, 1), _mm256_set1_epi16(0x5555)));
+        suits = _mm256_add_epi16(_mm256_and_si256(suits, _mm256_set1_epi16(0x3333)), _mm256_and_si256(_mm256_srli_epi16(suits, 2), _mm256_set1_epi16(0x3333)));
+        suits = _mm256_and_si256(_mm256_add_epi16(suits, _mm256_srli_epi16(suits, 4)), _mm256_set1_epi16(0x0F0F));
+        return _mm256_and_si256(_mm256_add_epi16(suits, _mm256_srli_epi16(suits, 8)), _mm256_set1_epi16(0x001F));
+    }
+
+    __attribute__((target("avx2")))
+    static inline __m256i ifNotZeroAvx2(__m256i condition, __m256i value) noexcept
+    {
+        return _mm256_andnot_si256(_mm256_cmpeq_epi32(condition, _mm256_setzero_si256()), value);
+    }
+
+    __attribute__((target("avx2")))
+    static inline __m256i handTypeAvx2(HandType handType) noexcept
+    {
+        return _mm256_set1_epi32(static_cast<uint32_t>(handType) << HandTypeInValueShift);
+    }
+
+    __attribute__((target("avx2")))
+    static void evaluateHoldemHandsAvx2(const Evaluator& evaluator, ScalarEvaluator evaluateTail, const uint16_t* rankOfStraights, const uint16_t* highUpTo5Bits,
+            const uint16_t* highUpTo3Bits, const Hand* hands, uint32_t* values, size_t count) noexcept
+    {
+        const __m256i lowSuitMask = _mm256_set1_epi32(0xFFFF);
+        size_t i = 0;
+
+        for (; i + 8 <= count; i += 8) {
+            __m256 firstHands = _mm256_loadu_ps(reinterpret_cast<const float*>(hands + i));
+            __m256 secondHands = _mm256_loadu_ps(reinterpret_cast<const float*>(hands + i + 4));
+
+            // 32-bit lanes with (clubs | diamonds << 16) and (hearts | spades << 16) of 8 hands in original order
+            __m256i clubsAndDiamonds = _mm256_permute4x64_epi64(_mm256_castps_si256(_mm256_shuffle_ps(firstHands, secondHands, _MM_SHUFFLE(2, 0, 2, 0))), _MM_SHUFFLE(3, 1, 2, 0));
+            __m256i heartsAndSpades = _mm256_permute4x64_epi64(_mm256_castps_si256(_mm256_shuffle_ps(firstHands, secondHands, _MM_SHUFFLE(3, 1, 3, 1))), _MM_SHUFFLE(3, 1, 2, 0));
+
+            __m256i clubs = _mm256_and_si256(clubsAndDiamonds, lowSuitMask);
+            __m256i diamonds = _mm256_srli_epi32(clubsAndDiamonds, 16);
+            __m256i hearts = _mm256_and_si256(heartsAndSpades, lowSuitMask);
+            __m256i spades = _mm256_srli_epi32(heartsAndSpades, 16);
+
+            __m256i ranks = _mm256_or_si256(_mm256_or_si256(clubs, diamonds), _mm256_or_si256(hearts, spades));
+            __m256i quadsRanks = _mm256_and_si256(_mm256_and_si256(clubs, diamonds), _mm256_and_si256(hearts, spades));
+            __m256i singletonsAndTripsRanks = _mm256_xor_si256(_mm256_xor_si256(clubs, diamonds), _mm256_xor_si256(hearts, spades));
+            __m256i tripsAndQuadsRanks = _mm256_and_si256(
+                    _mm256_or_si256(_mm256_and_si256(clubs, diamonds), _mm256_and_si256(hearts, spades)),
+                    _mm256_or_si256(_mm256_and_si256(clubs, hearts), _mm256_and_si256(diamonds, spades)));
+            __m256i tripsRanks = _mm256_xor_si256(tripsAndQuadsRanks, quadsRanks);
+            __m256i pairsRanks = _mm256_andnot_si256(quadsRanks, _mm256_xor_si256(ranks, singletonsAndTripsRanks));
+            __m256i singletonsRanks = _mm256_andnot_si256(tripsAndQuadsRanks, singletonsAndTripsRanks);
+
+            // Flush: at most one suit can have 5 or more cards
+            __m256i fiveCards = _mm256_set1_epi16(4);
+            __m256i flushClubsAndDiamonds = _mm256_and_si256(clubsAndDiamonds, _mm256_cmpgt_epi16(numberOfBitsInSuitsAvx2(clubsAndDiamonds), fiveCards));
+            __m256i flushHeartsAndSpades = _mm256_and_si256(heartsAndSpades, _mm256_cmpgt_epi16(numberOfBitsInSuitsAvx2(heartsAndSpades), fiveCards));
+            __m256i flushRanks = _mm256_or_si256(
+                    _mm256_or_si256(_mm256_and_si256(flushClubsAndDiamonds, lowSuitMask), _mm256_srli_epi32(flushClubsAndDiamonds, 16)),
+                    _mm256_or_si256(_mm256_and_si256(flushHeartsAndSpades, lowSuitMask), _mm256_srli_epi32(flushHeartsAndSpades, 16)));
+
+            __m256i straightFlushRank = gatherAvx2(rankOfStraights, flushRanks);
+            __m256i flushValue = _mm256_blendv_epi8(
+                    _mm256_or_si256(handTypeAvx2(HandType::StraightFulsh), straightFlushRank),
+                    _mm256_or_si256(handTypeAvx2(HandType::Flush), gatherAvx2(highUpTo5Bits, flushRanks)),
+                    _mm256_cmpeq_epi32(straightFlushRank, _mm256_setzero_si256()));
+            __m256i value = ifNotZeroAvx2(flushRanks, flushValue);
+
+            __m256i quadsValue = _mm256_or_si256(_mm256_or_si256(handTypeAvx2(HandType::FourOfAKind), _mm256_slli_epi32(quadsRanks, RanksCount)),
+                    highBitAvx2(_mm256_xor_si256(ranks, quadsRanks)));
+            value = _mm256_max_epu32(value, ifNotZeroAvx2(quadsRanks, quadsValue));
+
+            __m256i highTripsRank = highBitAvx2(tripsRanks);
+            __m256i fullHousePairRank = highBitAvx2(_mm256_or_si256(_mm256_xor_si256(tripsRanks, highTripsRank), pairsRanks));
+            __m256i fullHouseValue = _mm256_or_si256(_mm256_or_si256(handTypeAvx2(HandType::FullHouse), _mm256_slli_epi32(highTripsRank, RanksCount)), fullHousePairRank);
+            value = _mm256_max_epu32(value, ifNotZeroAvx2(_mm256_min_epu32(highTripsRank, fullHousePairRank), fullHouseValue));
+
+            __m256i straightRank = gatherAvx2(rankOfStraights, ranks);
+            value = _mm256_max_epu32(value, ifNotZeroAvx2(straightRank, _mm256_or_si256(handTypeAvx2(HandType::Straight), straightRank)));
+
+            __m256i firstKickerRank = highBitAvx2(singletonsRanks);
+            __m256i secondKickerRank = highBitAvx2(_mm256_xor_si256(singletonsRanks, firstKickerRank));
+            __m256i threeOfAKindValue = _mm256_or_si256(_mm256_or_si256(handTypeAvx2(HandType::ThreeOfAKind), _mm256_slli_epi32(tripsRanks, RanksCount)),
+                    _mm256_or_si256(firstKickerRank, secondKickerRank));
+            value = _mm256_max_epu32(value, ifNotZeroAvx2(tripsRanks, threeOfAKindValue));
+
+            __m256i highPairRank = highBitAvx2(pairsRanks);
+            __m256i secondPairRank = highBitAvx2(_mm256_xor_si256(pairsRanks, highPairRank));
+            __m256i twoPairsRanks = _mm256_or_si256(highPairRank, secondPairRank);
+            __m256i twoPairValue = _mm256_or_si256(_mm256_or_si256(handTypeAvx2(HandType::TwoPair), _mm256_slli_epi32(twoPairsRanks, RanksCount)),
+                    highBitAvx2(_mm256_xor_si256(ranks, twoPairsRanks)));
+            value = _mm256_max_epu32(value, ifNotZeroAvx2(secondPairRank, twoPairValue));
+
+            __m256i pairKickersRanks = gatherAvx2(highUpTo3Bits, _mm256_min_epu32(singletonsRanks, _mm256_set1_epi32(HigUpTo3BitsArraySize - 1)));
+            __m256i pairValue = _mm256_or_si256(_mm256_or_si256(handTypeAvx2(HandType::Pair), _mm256_slli_epi32(pairsRanks, RanksCount)), pairKickersRanks);
+            value = _mm256_max_epu32(value, ifNotZeroAvx2(pairsRanks, pairValue));
+
+            value = _mm256_max_epu32(value, gatherAvx2(highUpTo5Bits, ranks)); // High Card
+
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(values + i), value);
         }
 
-        const uint16_t fiveHighStraightMask = 0b1000000001111;
+        for (; i < count; i++) {
+            values[i] = (evaluator.*evaluateTail)(hands[i]);
+        }
+    }
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized" // False positives in GCC AVX-512 intrinsics headers
 
-        return ((ranks & fiveHighStraightMask) == fiveHighStraightMask) ? (1 << 3) : 0;
+    __attribute__((target("avx512f,avx512bw")))
+    static inline __m512i gatherAvx512(const uint16_t* table, __m512i indexes) noexcept
+    {
+        return _mm512_and_si512(_mm512_i32gather_epi32(indexes, table, sizeof(uint16_t)), _mm512_set1_epi32(0xFFFF));
     }
 
-    void initializeEvaluator(std::unique_ptr<uint8_t, std::function<void(uint8_t*)>> internalTablesBuffer) noexcept
+    __attribute__((target("avx512f,avx512bw")))
+    static inline __m512i highBitAvx512(__m512i ranks) noexcept
     {
-        buffer          = std::move(internalTablesBuffer);
-        numberOfBits    = buffer.get();
-        rankOfStraights = reinterpret_cast<uint16_t*>(buffer.get() + sizeof(uint8_t) * BitsArraySize);
-        highUpTo5Bits   = reinterpret_cast<uint16_t*>(buffer.get() + 3 * sizeof(uint8_t) * BitsArraySize);
-        highBit         = reinterpret_cast<uint16_t*>(buffer.get() + 5 * sizeof(uint8_t) * BitsArraySize);
-        highUpTo3Bits   = reinterpret_cast<uint16_t*>(buffer.get() + 7 * sizeof(uint8_t) * BitsArraySize);
+        // Exponent of float representation is index of the highest bit, zero gives shift out of range
+        __m512i exponent = _mm512_srli_epi32(_mm512_castps_si512(_mm512_cvtepi32_ps(ranks)), 23);
+        return _mm512_sllv_epi32(_mm512_set1_epi32(1), _mm512_sub_epi32(exponent, _mm512_set1_epi32(127)));
+    }
 
-        numberOfBits[0] = 0;
-        rankOfStraights[0] = 0;
-        highUpTo5Bits[0] = 0;
-        highBit[0] = 0;
-        highUpTo3Bits[0] = 0;
+    __attribute__((target("avx512f,avx512bw")))
+    static inline __m512i numberOfBitsInSuitsAvx512(__m512i suits) noexcept
+    {
+        suits = _mm512_sub_epi16(suits, _mm512_and_si512(_mm512_srli_epi16(suits, 1), _mm512_set1_epi16(0x5555)));
+        suits = _mm512_add_epi16(_mm512_and_si512(suits, _mm512_set1_epi16(0x3333)), _mm512_and_si512(_mm512_srli_epi16(suits, 2), _mm512_set1_epi16(0x3333)));
+        suits = _mm512_and_si512(_mm512_add_epi16(suits, _mm512_srli_epi16(suits, 4)), _mm512_set1_epi16(0x0F0F));
+        return _mm512_and_si512(_mm512_add_epi16(suits, _mm512_srli_epi16(suits, 8)), _mm512_set1_epi16(0x001F));
+    }
 
-        for (uint16_t i = 1; i < BitsArraySize; i++) {
-            std::bitset<16> bitset(i);
+    __attribute__((target("avx512f,avx512bw")))
+    static inline __m512i ifNotZeroAvx512(__m512i condition, __m512i value) noexcept
+    {
+        return _mm512_maskz_mov_epi32(_mm512_test_epi32_mask(condition, condition), value);
+    }
 
-            numberOfBits[i] = bitset.count();
+    __attribute__((target("avx512f,avx512bw")))
+    static inline __m512i handTypeAvx512(HandType handType) noexcept
+    {
+        return _mm512_set1_epi32(static_cast<uint32_t>(handType) << HandTypeInValueShift);
+    }
 
-            for (int bit = 15; ; bit--) {
-                if (bitset.test(bit)) {
-                    highBit[i] = (1 << bit);
-                    break;
-                }
-            }
+    __attribute__((target("avx512f,avx512bw")))
+    static void evaluateHoldemHandsAvx512(const Evaluator& evaluator, ScalarEvaluator evaluateTail, const uint16_t* rankOfStraights, const uint16_t* highUpTo5Bits,
+            const uint16_t* highUpTo3Bits, const Hand* hands, uint32_t* values, size_t count) noexcept
+    {
+        const __m512i lowSuitMask = _mm512_set1_epi32(0xFFFF);
+        const __m512i lowHalvesIndexes = _mm512_setr_epi32(0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28, 30);
+        const __m512i highHalvesIndexes = _mm512_setr_epi32(1, 3, 5, 7, 9, 11, 13, 15, 17, 19, 21, 23, 25, 27, 29, 31);
+        size_t i = 0;
+
+        for (; i + 16 <= count; i += 16) {
+            __m512i firstHands = _mm512_loadu_si512(hands + i);
+            __m512i secondHands = _mm512_loadu_si512(hands + i + 8);
+
+            // 32-bit lanes with (clubs | diamonds << 16) and (hearts | spades << 16) of 16 hands in original order
+            __m512i clubsAndDiamonds = _mm512_permutex2var_epi32(firstHands, lowHalvesIndexes, secondHands);
+            __m512i heartsAndSpades = _mm512_permutex2var_epi32(firstHands, highHalvesIndexes, secondHands);
+
+            __m512i clubs = _mm512_and_si512(clubsAndDiamonds, lowSuitMask);
+            __m512i diamonds = _mm512_srli_epi32(clubsAndDiamonds, 16);
+            __m512i hearts = _mm512_and_si512(heartsAndSpades, lowSuitMask);
+            __m512i spades = _mm512_srli_epi32(heartsAndSpades, 16);
+
+            __m512i ranks = _mm512_or_si512(_mm512_or_si512(clubs, diamonds), _mm512_or_si512(hearts, spades));
+            __m512i quadsRanks = _mm512_and_si512(_mm512_and_si512(clubs, diamonds), _mm512_and_si512(hearts, spades));
+            __m512i singletonsAndTripsRanks = _mm512_xor_si512(_mm512_xor_si512(clubs, diamonds), _mm512_xor_si512(hearts, spades));
+            __m512i tripsAndQuadsRanks = _mm512_and_si512(
+                    _mm512_or_si512(_mm512_and_si512(clubs, diamonds), _mm512_and_si512(hearts, spades)),
+                    _mm512_or_si512(_mm512_and_si512(clubs, hearts), _mm512_and_si512(diamonds, spades)));
+            __m512i tripsRanks = _mm512_xor_si512(tripsAndQuadsRanks, quadsRanks);
+            __m512i pairsRanks = _mm512_andnot_si512(quadsRanks, _mm512_xor_si512(ranks, singletonsAndTripsRanks));
+            __m512i singletonsRanks = _mm512_andnot_si512(tripsAndQuadsRanks, singletonsAndTripsRanks);
+
+            // Flush: at most one suit can have 5 or more cards
+            __m512i fiveCards = _mm512_set1_epi16(4);
+            __m512i flushClubsAndDiamonds = _mm512_maskz_mov_epi16(_mm512_cmpgt_epi16_mask(numberOfBitsInSuitsAvx512(clubsAndDiamonds), fiveCards), clubsAndDiamonds);
+            __m512i flushHeartsAndSpades = _mm512_maskz_mov_epi16(_mm512_cmpgt_epi16_mask(numberOfBitsInSuitsAvx512(heartsAndSpades), fiveCards), heartsAndSpades);
+            __m512i flushRanks = _mm512_or_si512(
+                    _mm512_or_si512(_mm512_and_si512(flushClubsAndDiamonds, lowSuitMask), _mm512_srli_epi32(flushClubsAndDiamonds, 16)),
+                    _mm512_or_si512(_mm512_and_si512(flushHeartsAndSpades, lowSuitMask), _mm512_srli_epi32(flushHeartsAndSpades, 16)));
+
+            __m512i straightFlushRank = gatherAvx512(rankOfStraights, flushRanks);
+            __m512i flushValue = _mm512_mask_mov_epi32(
+                    _mm512_or_si512(handTypeAvx512(HandType::Flush), gatherAvx512(highUpTo5Bits, flushRanks)),
+                    _mm512_test_epi32_mask(straightFlushRank, straightFlushRank),
+                    _mm512_or_si512(handTypeAvx512(HandType::StraightFulsh), straightFlushRank));
+            __m512i value = ifNotZeroAvx512(flushRanks, flushValue);
+
+            __m512i quadsValue = _mm512_or_si512(_mm512_or_si512(handTypeAvx512(HandType::FourOfAKind), _mm512_slli_epi32(quadsRanks, RanksCount)),
+                    highBitAvx512(_mm512_xor_si512(ranks, quadsRanks)));
+            value = _mm512_max_epu32(value, ifNotZeroAvx512(quadsRanks, quadsValue));
+
+            __m512i highTripsRank = highBitAvx512(tripsRanks);
+            __m512i fullHousePairRank = highBitAvx512(_mm512_or_si512(_mm512_xor_si512(tripsRanks, highTripsRank), pairsRanks));
+            __m512i fullHouseValue = _mm512_or_si512(_mm512_or_si512(handTypeAvx512(HandType::FullHouse), _mm512_slli_epi32(highTripsRank, RanksCount)), fullHousePairRank);
+            value = _mm512_max_epu32(value, ifNotZeroAvx512(_mm512_min_epu32(highTripsRank, fullHousePairRank), fullHouseValue));
+
+            __m512i straightRank = gatherAvx512(rankOfStraights, ranks);
+            value = _mm512_max_epu32(value, ifNotZeroAvx512(straightRank, _mm512_or_si512(handTypeAvx512(HandType::Straight), straightRank)));
+
+            __m512i firstKickerRank = highBitAvx512(singletonsRanks);
+            __m512i secondKickerRank = highBitAvx512(_mm512_xor_si512(singletonsRanks, firstKickerRank));
+            __m512i threeOfAKindValue = _mm512_or_si512(_mm512_or_si512(handTypeAvx512(HandType::ThreeOfAKind), _mm512_slli_epi32(tripsRanks, RanksCount)),
+                    _mm512_or_si512(firstKickerRank, secondKickerRank));
+            value = _mm512_max_epu32(value, ifNotZeroAvx512(tripsRanks, threeOfAKindValue));
+
+            __m512i highPairRank = highBitAvx512(pairsRanks);
+            __m512i secondPairRank = highBitAvx512(_mm512_xor_si512(pairsRanks, highPairRank));
+            __m512i twoPairsRanks = _mm512_or_si512(highPairRank, secondPairRank);
+            __m512i twoPairValue = _mm512_or_si512(_mm512_or_si512(handTypeAvx512(HandType::TwoPair), _mm512_slli_epi32(twoPairsRanks, RanksCount)),
+                    highBitAvx512(_mm512_xor_si512(ranks, twoPairsRanks)));
+            value = _mm512_max_epu32(value, ifNotZeroAvx512(secondPairRank, twoPairValue));
+
+            __m512i pairKickersRanks = gatherAvx512(highUpTo3Bits, _mm512_min_epu32(singletonsRanks, _mm512_set1_epi32(HigUpTo3BitsArraySize - 1)));
+            __m512i pairValue = _mm512_or_si512(_mm512_or_si512(handTypeAvx512(HandType::Pair), _mm512_slli_epi32(pairsRanks, RanksCount)), pairKickersRanks);
+            value = _mm512_max_epu32(value, ifNotZeroAvx512(pairsRanks, pairValue));
+
+            value = _mm512_max_epu32(value, gatherAvx512(highUpTo5Bits, ranks)); // High Card
+
+            _mm512_storeu_si512(values + i, value);
+        }
+
+        for (; i < count; i++) {
+            values[i] = (evaluator.*evaluateTail)(hands[i]);
+        }
+    }
+
+#pragma GCC diagnostic pop
+#endif
+
+    static InstructionSet detectSupportedInstructionSet() noexcept
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_cpu_init();
+
+        if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")) {
+            return InstructionSet::Avx512;
+        } else if (__builtin_cpu_supports("avx2")) {
+            return InstructionSet::Avx2;
+        }
+#endif
+        return InstructionSet::Scalar;
+    }
+
+    InstructionSet getSupportedInstructionSet() noexcept
+    {
+        static const InstructionSet supportedInstructionSet = detectSupportedInstructionSet();
+        return supportedInstructionSet;
+    }
+
+    void Evaluator::evaluateHoldem7CardsHands(const Hand* hands, uint32_t* values, size_t count) const noexcept
+    {
+        evaluateHoldem7CardsHands(hands, values, count, getSupportedInstructionSet());
+    }
+
+    void Evaluator::evaluateHoldem7CardsHands(const Hand* hands, uint32_t* values, size_t count, InstructionSet instructionSet) const noexcept
+    {
+        evaluateHoldemHands(&Evaluator::evaluateHoldem7CardsHand, hands, values, count, instructionSet);
+    }
+
+    void Evaluator::evaluateHoldem6CardsHands(const Hand* hands, uint32_t* values, size_t count) const noexcept
+    {
+        evaluateHoldem6CardsHands(hands, values, count, getSupportedInstructionSet());
+    }
 
-            rankOfStraights[i] = getRankOfStraight(i);
+    void Evaluator::evaluateHoldem6CardsHands(const Hand* hands, uint32_t* values, size_t count, InstructionSet instructionSet) const noexcept
+    {
+        evaluateHoldemHands(&Evaluator::evaluateHoldem6CardsHand, hands, values, count, instructionSet);
+    }
 
-            int bitsCounter = 0;
-            highUpTo5Bits[i] = 0;
-            if (i < HigUpTo3BitsArraySize) {
-                highUpTo3Bits[i] = 0;
+    void Evaluator::evaluateHoldemHands(ScalarEvaluator evaluateHand, const Hand* hands, uint32_t* values, size_t count, InstructionSet instructionSet) const noexcept
+    {
+        assert(instructionSet <= getSupportedInstructionSet());
+
+        switch (instructionSet) {
+#if defined(__x86_64__) || defined(__i386__)
+        case InstructionSet::Avx512:
+            return evaluateHoldemHandsAvx512(*this, evaluateHand, rankOfStraights, highUpTo5Bits, highUpTo3Bits, hands, values, count);
+
+        case InstructionSet::Avx2:
+            return evaluateHoldemHandsAvx2(*this, evaluateHand, rankOfStraights, highUpTo5Bits, highUpTo3Bits, hands, values, count);
+#endif
+
+        default:
+            for (size_t i = 0; i < count; i++) {
+                values[i] = (this->*evaluateHand)(hands[i]);
             }
+        }
+    }
 
-            for (int bit = 15; bit >= 0; bit--) {
-                if (bitset.test(bit)) {
-                    highUpTo5Bits[i] |= (1 << bit);
-                    bitsCounter++;
+    Evaluator::Evaluator() noexcept
+        : engine(EvaluatorEngine::Branching)
+    {
+        useBuiltinTables();
+    }
 
-                    if ((bitsCounter <= 3) && (i < HigUpTo3BitsArraySize)) {
-                        highUpTo3Bits[i] |= (1 << bit);
-                    } else if (bitsCounter == 5) {
-                        break;
-                    }
-                }
+    Evaluator::Evaluator(InternalTablesBuffer internalTablesBuffer) noexcept
+        : engine(EvaluatorEngine::Branching), buffer(std::move(internalTablesBuffer))
+    {
+        // Packed table goes first to be aligned as buffer
+        uint16_t* packedRanksCopy = reinterpret_cast<uint16_t*>(buffer.get());
+        uint8_t* tablesBuffer = buffer.get() + sizeof(uint16_t) * BitsArraySize;
+        uint8_t* numberOfBitsCopy = tablesBuffer;
+        uint16_t* rankOfStraightsCopy = reinterpret_cast<uint16_t*>(tablesBuffer + sizeof(uint8_t) * BitsArraySize);
+        uint16_t* highUpTo5BitsCopy = reinterpret_cast<uint16_t*>(tablesBuffer + 3 * sizeof(uint8_t) * BitsArraySize);
+        uint16_t* highBitCopy = reinterpret_cast<uint16_t*>(tablesBuffer + 5 * sizeof(uint8_t) * BitsArraySize);
+        uint16_t* highUpTo3BitsCopy = reinterpret_cast<uint16_t*>(tablesBuffer + 7 * sizeof(uint8_t) * BitsArraySize);
+
+        // Last table keeps its gather padding, other tables are padded by the following ones
+        std::copy_n(tables::packedRanks.values, BitsArraySize, packedRanksCopy);
+        std::copy_n(tables::numberOfBits.values, BitsArraySize, numberOfBitsCopy);
+        std::copy_n(tables::rankOfStraights.values, BitsArraySize, rankOfStraightsCopy);
+        std::copy_n(tables::highUpTo5Bits.values, BitsArraySize, highUpTo5BitsCopy);
+        std::copy_n(tables::highBit.values, BitsArraySize, highBitCopy);
+        std::copy_n(tables::highUpTo3Bits.values, tables::highUpTo3Bits.size, highUpTo3BitsCopy);
+
+        numberOfBits    = numberOfBitsCopy;
+        rankOfStraights = rankOfStraightsCopy;
+        highUpTo5Bits   = highUpTo5BitsCopy;
+        highBit         = highBitCopy;
+        highUpTo3Bits   = highUpTo3BitsCopy;
+        packedRanks     = packedRanksCopy;
+    }
+
+    Evaluator::Evaluator(Evaluator&& other) noexcept
+        : Evaluator()
+    {
+        *this = std::move(other);
+    }
+
+    Evaluator& Evaluator::operator=(Evaluator&& other) noexcept
+    {
+        // Moved from evaluator is left with compile time generated tables and Branching engine
+        std::swap(numberOfBits, other.numberOfBits);
+        std::swap(rankOfStraights, other.rankOfStraights);
+        std::swap(highUpTo5Bits, other.highUpTo5Bits);
+        std::swap(highBit, other.highBit);
+        std::swap(highUpTo3Bits, other.highUpTo3Bits);
+        std::swap(packedRanks, other.packedRanks);
+        std::swap(engine, other.engine);
+        std::swap(buffer, other.buffer);
+        std::swap(perfectHashTables, other.perfectHashTables);
+
+        other.useBuiltinTables();
+        other.engine = EvaluatorEngine::Branching;
+        other.buffer.reset();
+        other.perfectHashTables.reset();
+
+        return *this;
+    }
+
+    Evaluator::~Evaluator() = default;
+
+    void Evaluator::useBuiltinTables() noexcept
+    {
+        numberOfBits    = tables::numberOfBits.values;
+        rankOfStraights = tables::rankOfStraights.values;
+        highUpTo5Bits   = tables::highUpTo5Bits.values;
+        highBit         = tables::highBit.values;
+        highUpTo3Bits   = tables::highUpTo3Bits.values;
+        packedRanks     = tables::packedRanks.values;
+    }
+
+    void Evaluator::initializeEngine(EvaluatorEngine engine)
+    {
+        if (engine == EvaluatorEngine::PerfectHash) {
+            if (!perfectHashTables) {
+                perfectHashTables = perfecthash::createTables();
             }
+        } else {
+            perfectHashTables.reset();
         }
+
+        this->engine = engine;
+    }
+
+    EvaluatorEngine Evaluator::getEngine() const noexcept
+    {
+        return engine;
+    }
+
+    uint32_t evaluateHoldem7CardsHand(Hand hand) noexcept
+    {
+        return getDefaultEvaluator().evaluateHoldem7CardsHand(hand);
+    }
+
+    uint32_t evaluateHoldem6CardsHand(Hand hand) noexcept
+    {
+        return getDefaultEvaluator().evaluateHoldem6CardsHand(hand);
+    }
+
+    uint32_t evaluateHoldem5CardsHand(Hand hand) noexcept
+    {
+        return getDefaultEvaluator().evaluateHoldem5CardsHand(hand);
+    }
+
+    uint32_t evaluateHoldemHand(Hand hand, unsigned cardsCount) noexcept
+    {
+        return getDefaultEvaluator().evaluateHoldemHand(hand, cardsCount);
+    }
+
+    uint32_t evaluateShortDeck7CardsHand(Hand hand) noexcept
+    {
+        return getDefaultEvaluator().evaluateShortDeck7CardsHand(hand);
+    }
+
+    uint32_t evaluateShortDeck5CardsHand(Hand hand) noexcept
+    {
+        return getDefaultEvaluator().evaluateShortDeck5CardsHand(hand);
+    }
+
+    uint32_t evaluateShortDeckHand(Hand hand, unsigned cardsCount) noexcept
+    {
+        return getDefaultEvaluator().evaluateShortDeckHand(hand, cardsCount);
+    }
+
+    uint32_t evaluateDeuceToSevenLowHand(Hand hand) noexcept
+    {
+        return getDefaultEvaluator().evaluateDeuceToSevenLowHand(hand);
+    }
+
+    HiLoValues evaluateHiLoHand(Hand hand, unsigned cardsCount) noexcept
+    {
+        return getDefaultEvaluator().evaluateHiLoHand(hand, cardsCount);
+    }
+
+    void evaluateHoldem7CardsHands(const Hand* hands, uint32_t* values, size_t count) noexcept
+    {
+        getDefaultEvaluator().evaluateHoldem7CardsHands(hands, values, count);
+    }
+
+    void evaluateHoldem7CardsHands(const Hand* hands, uint32_t* values, size_t count, InstructionSet instructionSet) noexcept
+    {
+        getDefaultEvaluator().evaluateHoldem7CardsHands(hands, values, count, instructionSet);
+    }
+
+    void evaluateHoldem6CardsHands(const Hand* hands, uint32_t* values, size_t count) noexcept
+    {
+        getDefaultEvaluator().evaluateHoldem6CardsHands(hands, values, count);
+    }
+
+    void evaluateHoldem6CardsHands(const Hand* hands, uint32_t* values, size_t count, InstructionSet instructionSet) noexcept
+    {
+        getDefaultEvaluator().evaluateHoldem6CardsHands(hands, values, count, instructionSet);
+    }
+
+    void initializeEvaluator(InternalTablesBuffer internalTablesBuffer) noexcept
+    {
+        // Selected engine of default evaluator is kept
+        Evaluator& defaultEvaluator = getDefaultEvaluator();
+        Evaluator evaluator(std::move(internalTablesBuffer));
+        evaluator.perfectHashTables = std::move(defaultEvaluator.perfectHashTables);
+        evaluator.engine = defaultEvaluator.engine;
+        defaultEvaluator = std::move(evaluator);
     }
 
     void deinitializeEvaluator()
     {
-        buffer.reset();
+        getDefaultEvaluator() = Evaluator();
+    }
+
+    void initializeEvaluatorEngine(EvaluatorEngine engine)
+    {
+        getDefaultEvaluator().initializeEngine(engine);
+    }
+
+    EvaluatorEngine getEvaluatorEngine() noexcept
+    {
+        return getDefaultEvaluator().getEngine();
     }
 }
@@ -0,0 +1,85 @@
+/* pokertools - tools for poker related coding
+ * Copyright (C) 2016 Andriy Lysnevych
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+#include <pokertools-cpp/hugepages.hpp>
+
+#include <new>
+#include <cstdint>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+namespace pokertools
+{
+#ifdef __linux__
+    static size_t roundUpToHugePages(size_t size) noexcept
+    {
+        return (size + HugePageSize - 1) / HugePageSize * HugePageSize;
+    }
+
+    void* allocateHugePages(size_t size)
+    {
+        size_t mappingSize = roundUpToHugePages(size);
+        void* pointer = mmap(nullptr, mappingSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+
+        if (pointer != MAP_FAILED) {
+            return pointer;
+        }
+
+        // No reserved huge pages, map one extra page to cut 2MB aligned range and ask for transparent huge pages
+        size_t alignedMappingSize = mappingSize + HugePageSize;
+        pointer = mmap(nullptr, alignedMappingSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+        if (pointer == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+
+        uint8_t* begin = static_cast<uint8_t*>(pointer);
+        uint8_t* alignedBegin = reinterpret_cast<uint8_t*>(roundUpToHugePages(reinterpret_cast<uintptr_t>(begin)));
+        uint8_t* alignedEnd = alignedBegin + mappingSize;
+
+        if (alignedBegin != begin) {
+            munmap(begin, alignedBegin - begin);
+        }
+
+        if (alignedEnd != begin + alignedMappingSize) {
+            munmap(alignedEnd, begin + alignedMappingSize - alignedEnd);
+        }
+
+        madvise(alignedBegin, mappingSize, MADV_HUGEPAGE); // Only a hint, regular pages are still usable
+
+        return alignedBegin;
+    }
+
+    void deallocateHugePages(void* pointer, size_t size) noexcept
+    {
+        munmap(pointer, roundUpToHugePages(size));
+    }
+#else
+    void* allocateHugePages(size_t size)
+    {
+        return ::operator new(size);
+    }
+
+    void deallocateHugePages(void* pointer, size_t size) noexcept
+    {
+        ::operator delete(pointer);
+    }
+#endif
+}
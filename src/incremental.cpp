@@ -0,0 +1,258 @@
+/* pokertools - tools for poker related coding
+ * Copyright (C) 2016 Andriy Lysnevych
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+#include <pokertools-cpp/incremental.hpp>
+#include <pokertools-cpp/evaluators.hpp>
+
+#include <stdexcept>
+#include <algorithm>
+#include <unordered_map>
+#include <fstream>
+#include <cstring>
+
+namespace pokertools
+{
+    static constexpr char IncrementalEvaluatorFileMagic[8] = { 'P', 'T', 'I', 'N', 'C', 'R', 'E', 'V' };
+    static constexpr uint64_t PayloadSize = sizeof(uint32_t) * IncrementalStatesCount * IncrementalStateSize;
+    static constexpr unsigned MaxCardsCount = 7;
+    static constexpr unsigned FlushCardsCount = 5;
+    static constexpr uint16_t FlushPossibleFlag = 0x8000;
+
+    constexpr uint32_t IncrementalEvaluator::InitialState;
+
+    /**
+     * Partial hand up to cards of suits that can't make a flush anymore:
+     * 3-bit count of every rank and 16-bit field of every suit with ranks mask
+     * and FlushPossibleFlag, zero when flush of suit is impossible.
+     */
+    struct StateKey {
+        uint64_t ranksCounts;
+        uint64_t suits;
+        unsigned cardsCount;
+
+        inline bool operator==(const StateKey& other) const noexcept
+        {
+            return (ranksCounts == other.ranksCounts) && (suits == other.suits);
+        }
+    };
+
+    struct StateKeyHash {
+        inline size_t operator()(const StateKey& key) const noexcept
+        {
+            uint64_t hash = (key.ranksCounts ^ (key.suits * 0x9E3779B97F4A7C15ull)) * 0xBF58476D1CE4E5B9ull;
+            return static_cast<size_t>(hash ^ (hash >> 31));
+        }
+    };
+
+    static inline unsigned getRankCount(const StateKey& key, unsigned rank) noexcept
+    {
+        return (key.ranksCounts >> (3 * rank)) & 0b111;
+    }
+
+    static inline uint16_t getSuitField(const StateKey& key, unsigned suit) noexcept
+    {
+        return static_cast<uint16_t>(key.suits >> (16 * suit));
+    }
+
+    // Returns false if card can't be added to any hand of state
+    static bool addCardToKey(const StateKey& key, unsigned cardNumber, StateKey& nextKey) noexcept
+    {
+        unsigned rank = cardNumber % RanksCount;
+        unsigned suit = cardNumber / RanksCount;
+        uint16_t rankBit = 1 << rank;
+        unsigned rankCount = getRankCount(key, rank);
+        uint16_t suitField = getSuitField(key, suit);
+
+        if (rankCount == SuitsCount) {
+            return false;
+        }
+
+        if (suitField & FlushPossibleFlag) {
+            if (suitField & rankBit) {
+                return false;
+            }
+        } else {
+            // Some suit without possible flush must not have card of this rank yet
+            unsigned impossibleFlushSuitsCount = 0;
+            unsigned rankInPossibleFlushSuitsCount = 0;
+
+            for (unsigned i = 0; i < SuitsCount; i++) {
+                uint16_t field = getSuitField(key, i);
+                impossibleFlushSuitsCount += (field & FlushPossibleFlag) ? 0 : 1;
+                rankInPossibleFlushSuitsCount += (field & rankBit) ? 1 : 0;
+            }
+
+            if (rankCount - rankInPossibleFlushSuitsCount >= impossibleFlushSuitsCount) {
+                return false;
+            }
+        }
+
+        nextKey.ranksCounts = key.ranksCounts + (uint64_t(1) << (3 * rank));
+        nextKey.cardsCount = key.cardsCount + 1;
+        nextKey.suits = 0;
+
+        for (unsigned i = 0; i < SuitsCount; i++) {
+            uint16_t field = getSuitField(key, i) | ((i == suit) ? rankBit : 0);
+            unsigned suitCardsCount = __builtin_popcount(field & ~FlushPossibleFlag);
+
+            if ((field & FlushPossibleFlag) && (suitCardsCount + MaxCardsCount - nextKey.cardsCount >= FlushCardsCount)) {
+                nextKey.suits |= static_cast<uint64_t>(field) << (16 * i);
+            }
+        }
+
+        return true;
+    }
+
+    // Value of any 5 to 7 cards hand of state
+    static uint32_t evaluateKey(const StateKey& key) noexcept
+    {
+        // Cards of every rank go to consecutive suits, so no suit has more than 2 cards and flush is impossible
+        Hand hand = 0;
+        unsigned cardIndex = 0;
+
+        for (unsigned rank = 0; rank < RanksCount; rank++) {
+            for (unsigned i = getRankCount(key, rank); i > 0; i--, cardIndex++) {
+                hand |= createCard((cardIndex % SuitsCount) * RanksCount + rank);
+            }
+        }
+
+        uint32_t value = evaluateHoldemHand(hand, key.cardsCount);
+
+        for (unsigned suit = 0; suit < SuitsCount; suit++) {
+            uint16_t suitRanks = getSuitField(key, suit) & ~FlushPossibleFlag;
+            unsigned suitCardsCount = __builtin_popcount(suitRanks);
+
+            if (suitCardsCount >= FlushCardsCount) {
+                value = std::max(value, evaluateHoldemHand(Hand(suitRanks), suitCardsCount));
+            }
+        }
+
+        return value;
+    }
+
+    std::vector<uint32_t> generateIncrementalEvaluatorTable()
+    {
+        std::vector<uint32_t> table(static_cast<size_t>(IncrementalStatesCount) * IncrementalStateSize, 0);
+        std::vector<StateKey> keys;
+        std::unordered_map<StateKey, uint32_t, StateKeyHash> states;
+
+        StateKey initialKey{ 0, 0, 0 };
+
+        for (unsigned suit = 0; suit < SuitsCount; suit++) {
+            initialKey.suits |= static_cast<uint64_t>(FlushPossibleFlag) << (16 * suit);
+        }
+
+        keys.push_back(initialKey);
+        states.emplace(initialKey, IncrementalEvaluator::InitialState);
+
+        // States are numbered in order of discovery, so all states of n cards precede states of n + 1 cards
+        for (size_t i = 0; i < keys.size(); i++) {
+            StateKey key = keys[i];
+            uint32_t* entries = table.data() + i * IncrementalStateSize;
+
+            if (key.cardsCount >= FlushCardsCount) {
+                entries[0] = evaluateKey(key);
+            }
+
+            for (unsigned cardNumber = 0; cardNumber < CardsCount; cardNumber++) {
+                StateKey nextKey;
+
+                if (!addCardToKey(key, cardNumber, nextKey)) {
+                    continue;
+                }
+
+                if (nextKey.cardsCount == MaxCardsCount) {
+                    entries[1 + cardNumber] = evaluateKey(nextKey);
+                } else {
+                    auto state = states.emplace(nextKey, static_cast<uint32_t>(keys.size() * IncrementalStateSize));
+
+                    if (state.second) {
+                        keys.push_back(nextKey);
+                    }
+
+                    entries[1 + cardNumber] = state.first->second;
+                }
+            }
+        }
+
+        assert(keys.size() == IncrementalStatesCount);
+        return table;
+    }
+
+    void writeIncrementalEvaluatorFile(const std::string& fileName, const std::vector<uint32_t>& table)
+    {
+        if (table.size() * sizeof(uint32_t) != PayloadSize) {
+            throw std::invalid_argument("Incremental evaluator table must have IncrementalStatesCount * IncrementalStateSize entries");
+        }
+
+        IncrementalEvaluatorFileHeader header{};
+        std::copy_n(IncrementalEvaluatorFileMagic, sizeof(header.magic), header.magic);
+        header.version = IncrementalEvaluatorFileVersion;
+        header.headerSize = sizeof(IncrementalEvaluatorFileHeader);
+        header.statesCount = IncrementalStatesCount;
+        header.stateSize = IncrementalStateSize;
+        header.payloadSize = PayloadSize;
+        header.checksum = calculateFileChecksum(reinterpret_cast<const uint8_t*>(table.data()), PayloadSize);
+
+        std::ofstream file(fileName, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(table.data()), PayloadSize);
+        file.close();
+
+        if (!file) {
+            throw std::runtime_error("Can't write incremental evaluator file " + fileName);
+        }
+    }
+
+    IncrementalEvaluator::IncrementalEvaluator(const std::string& fileName, bool verifyChecksum)
+        : file(fileName, "incremental evaluator", sizeof(IncrementalEvaluatorFileHeader) + PayloadSize, sizeof(IncrementalEvaluatorFileHeader) + PayloadSize),
+          entries(nullptr)
+    {
+        const IncrementalEvaluatorFileHeader& header = *reinterpret_cast<const IncrementalEvaluatorFileHeader*>(file.getData());
+        const uint8_t* payload = file.getData() + sizeof(IncrementalEvaluatorFileHeader);
+
+        const char* error = nullptr;
+
+        if (!std::equal(header.magic, header.magic + sizeof(header.magic), IncrementalEvaluatorFileMagic)) {
+            error = "Not an incremental evaluator file ";
+        } else if (header.version != IncrementalEvaluatorFileVersion) {
+            error = "Unsupported version of incremental evaluator file ";
+        } else if ((header.headerSize != sizeof(IncrementalEvaluatorFileHeader)) || (header.statesCount != IncrementalStatesCount) ||
+                   (header.stateSize != IncrementalStateSize) || (header.payloadSize != PayloadSize)) {
+            error = "Invalid header of incremental evaluator file ";
+        } else if (verifyChecksum && (header.checksum != calculateFileChecksum(payload, PayloadSize))) {
+            error = "Invalid checksum of incremental evaluator file ";
+        }
+
+        if (error) {
+            throw std::runtime_error(error + fileName);
+        }
+
+        entries = reinterpret_cast<const uint32_t*>(payload);
+    }
+
+    IncrementalEvaluator::IncrementalEvaluator(std::vector<uint32_t> table)
+        : table(std::move(table)), entries(nullptr)
+    {
+        if (this->table.size() * sizeof(uint32_t) != PayloadSize) {
+            throw std::invalid_argument("Incremental evaluator table must have IncrementalStatesCount * IncrementalStateSize entries");
+        }
+
+        entries = this->table.data();
+    }
+}
@@ -0,0 +1,162 @@
+/* pokertools - tools for poker related coding
+ * Copyright (C) 2016 Andriy Lysnevych
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+#include <pokertools-cpp/isomorphism.hpp>
+
+#include <stdexcept>
+#include <vector>
+
+namespace pokertools
+{
+    static constexpr unsigned MinBoardCardsCount = 3;
+    static constexpr unsigned MaxBoardCardsCount = 5;
+
+    struct CanonicalBoardsIndex {
+        unsigned cardsCount;
+        std::vector<uint32_t> indexes; // Dense index of every canonical board by colex rank of its cards
+        std::vector<Hand> boards;      // Canonical board of every dense index
+
+        explicit CanonicalBoardsIndex(unsigned boardCardsCount);
+    };
+
+    struct Binomials {
+        uint32_t values[CardsCount + 1][MaxBoardCardsCount + 1];
+    };
+
+    static constexpr Binomials makeBinomials() noexcept
+    {
+        Binomials binomials{};
+
+        for (unsigned n = 0; n <= CardsCount; n++) {
+            binomials.values[n][0] = 1;
+
+            for (unsigned k = 1; (k <= MaxBoardCardsCount) && (n > 0); k++) {
+                binomials.values[n][k] = binomials.values[n - 1][k - 1] + binomials.values[n - 1][k];
+            }
+        }
+
+        return binomials;
+    }
+
+    static constexpr Binomials binomials = makeBinomials();
+
+    // Colex rank of cards among all combinations of the same number of cards
+    static uint32_t getColexRank(Hand cards) noexcept
+    {
+        uint32_t rank = 0;
+        unsigned k = 1;
+
+        for (uint64_t bits = cards; bits != 0; bits &= bits - 1, k++) {
+            rank += binomials.values[getCardNumber(static_cast<Card>(bits & (~bits + 1)))][k];
+        }
+
+        return rank;
+    }
+
+    CanonicalBoardsIndex::CanonicalBoardsIndex(unsigned boardCardsCount)
+        : cardsCount(boardCardsCount)
+    {
+        unsigned cards[MaxBoardCardsCount];
+
+        for (unsigned i = 0; i < cardsCount; i++) {
+            cards[i] = i;
+        }
+
+        // All boards in colex order of cards numbers
+        for (;;) {
+            Hand board = 0;
+
+            for (unsigned i = 0; i < cardsCount; i++) {
+                board |= createCard(cards[i]);
+            }
+
+            if (canonicalize(board).board == board) {
+                indexes.push_back(static_cast<uint32_t>(boards.size()));
+                boards.push_back(board);
+            } else {
+                indexes.push_back(UINT32_MAX);
+            }
+
+            unsigned i = 0;
+
+            while ((i + 1 < cardsCount) && (cards[i] + 1 == cards[i + 1])) {
+                cards[i] = i;
+                i++;
+            }
+
+            if (++cards[i] >= CardsCount) {
+                break;
+            }
+        }
+
+        assert(boards.size() == ((cardsCount == 3) ? CanonicalFlopsCount : (cardsCount == 4) ? CanonicalTurnsCount : CanonicalRiversCount));
+    }
+
+    // Every street has own accessor, so index of street is built only when it is used
+    static const CanonicalBoardsIndex& getCanonicalFlopsIndex()
+    {
+        static const CanonicalBoardsIndex flops(3);
+        return flops;
+    }
+
+    static const CanonicalBoardsIndex& getCanonicalTurnsIndex()
+    {
+        static const CanonicalBoardsIndex turns(4);
+        return turns;
+    }
+
+    static const CanonicalBoardsIndex& getCanonicalRiversIndex()
+    {
+        static const CanonicalBoardsIndex rivers(5);
+        return rivers;
+    }
+
+    static const CanonicalBoardsIndex& getCanonicalBoardsIndex(unsigned cardsCount)
+    {
+        if ((cardsCount < MinBoardCardsCount) || (cardsCount > MaxBoardCardsCount)) {
+            throw std::invalid_argument("Board must have from 3 to 5 cards");
+        }
+
+        return (cardsCount == 3) ? getCanonicalFlopsIndex() : (cardsCount == 4) ? getCanonicalTurnsIndex() : getCanonicalRiversIndex();
+    }
+
+    unsigned getCanonicalBoardIndex(Hand board)
+    {
+        const CanonicalBoardsIndex& index = getCanonicalBoardsIndex(countCards(board));
+        return index.indexes[getColexRank(canonicalize(board).board)];
+    }
+
+    Hand getCanonicalBoard(unsigned index, unsigned cardsCount)
+    {
+        const CanonicalBoardsIndex& boardsIndex = getCanonicalBoardsIndex(cardsCount);
+
+        if (index >= boardsIndex.boards.size()) {
+            throw std::invalid_argument("Invalid canonical board index");
+        }
+
+        return boardsIndex.boards[index];
+    }
+
+    uint32_t getCanonicalSituationIndex(Hand holeCards, Hand board)
+    {
+        CanonicalForm canonicalForm = canonicalize(holeCards, board);
+        const CanonicalBoardsIndex& index = getCanonicalBoardsIndex(countCards(board));
+
+        return index.indexes[getColexRank(canonicalForm.board)] * HoleCardsCombinationsCount + getHoleCardsIndex(canonicalForm.holeCards);
+    }
+}
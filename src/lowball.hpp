@@ -0,0 +1,107 @@
+/* pokertools - tools for poker related coding
+ * Copyright (C) 2016 Andriy Lysnevych
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+/**
+ * Helpers of lowball evaluators. Low hands are evaluated in Ace low ranks
+ * masks (bit 0 is Ace, bit 12 is King) and encoded as values of high
+ * evaluators inverted field by field, so greater value is better low hand.
+ */
+
+#pragma once
+
+#include "tables.hpp"
+#include "values.hpp"
+
+namespace pokertools
+{
+    constexpr uint16_t AllRanks = (1 << RanksCount) - 1;
+    constexpr uint32_t MaxHandValue = (static_cast<uint32_t>(HandType::StraightFulsh) << HandTypeInValueShift) | (static_cast<uint32_t>(AllRanks) << RanksCount) | AllRanks;
+
+    // Ranks of Eight or better low qualified hands (Ace to Eight) in Ace low ranks mask
+    constexpr uint16_t EightOrBetterRanks = 0b0000011111111;
+
+    // Hand type, high and low ranks fields never exceed ones of MaxHandValue, so subtraction inverts each field
+    inline uint32_t toLowValue(uint32_t value) noexcept
+    {
+        return MaxHandValue - value;
+    }
+
+    inline uint16_t toAceLowRanks(uint16_t ranks) noexcept
+    {
+        return ((ranks << 1) | (ranks >> (RanksCount - 1))) & AllRanks;
+    }
+
+    inline uint16_t lowBit(uint16_t ranks) noexcept
+    {
+        return ranks & -ranks;
+    }
+
+    inline uint16_t lowUpTo5Bits(uint16_t ranks) noexcept
+    {
+        return tables::reversedRanks[tables::highUpTo5Bits[tables::reversedRanks[ranks]]];
+    }
+
+    // Ace to Five low of 5 to 7 cards. Straights and flushes don't count, pairs do.
+    inline uint32_t evaluateAceToFiveLow(uint16_t clubs, uint16_t diamonds, uint16_t hearts, uint16_t spades) noexcept
+    {
+        uint16_t ranks = toAceLowRanks(clubs | diamonds | hearts | spades);
+        uint8_t ranksCount = tables::numberOfBits[ranks];
+
+        if (ranksCount >= 5) {
+            return toLowValue(calculateHighCardValue(lowUpTo5Bits(ranks)));
+        }
+
+        uint16_t pairsRanks = toAceLowRanks((clubs & diamonds) | (clubs & hearts) | (clubs & spades) | (diamonds & hearts) | (diamonds & spades) | (hearts & spades));
+        uint16_t tripsRanks = toAceLowRanks((clubs & diamonds & (hearts | spades)) | (hearts & spades & (clubs | diamonds)));
+
+        switch (ranksCount) {
+            case 4: { // Lowest possible pair and the rest ranks as kickers
+                uint16_t pairRank = lowBit(pairsRanks);
+
+                return toLowValue(calculatePairValue(pairRank, ranks ^ pairRank));
+            }
+
+            case 3:
+                if (tables::numberOfBits[pairsRanks] >= 2) {
+                    uint16_t lowPairRank = lowBit(pairsRanks);
+                    uint16_t secondPairRank = lowBit(pairsRanks ^ lowPairRank);
+
+                    return toLowValue(calculateTwoPairValue(lowPairRank | secondPairRank, ranks ^ lowPairRank ^ secondPairRank));
+                } else {
+                    return toLowValue(calculateThreeOfAKindValue(tripsRanks, ranks ^ tripsRanks));
+                }
+
+            default: // Two ranks
+                if (tables::numberOfBits[pairsRanks] == 2) {
+                    uint16_t tripsRank = lowBit(tripsRanks);
+
+                    return toLowValue(calculateFullHouseValue(tripsRank, ranks ^ tripsRank));
+                } else {
+                    return toLowValue(calculateFourOfAKindValue(tripsRanks, ranks ^ tripsRanks));
+                }
+        }
+    }
+
+    // Five distinct ranks of Eight or lower are required, so only ranks present matter. Returns 0 if there is no low.
+    inline uint32_t evaluateEightOrBetterLow(uint16_t ranks) noexcept
+    {
+        uint16_t lowRanks = toAceLowRanks(ranks) & EightOrBetterRanks;
+
+        return (tables::numberOfBits[lowRanks] >= 5) ? toLowValue(calculateHighCardValue(lowUpTo5Bits(lowRanks))) : 0;
+    }
+}
@@ -0,0 +1,101 @@
+/* pokertools - tools for poker related coding
+ * Copyright (C) 2016 Andriy Lysnevych
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+#include <pokertools-cpp/mappedfile.hpp>
+
+#include <stdexcept>
+#include <utility>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+// Headers and payloads are mapped as they are, without byte order conversion
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__)
+#error "Data files are little-endian, big-endian targets aren't supported"
+#endif
+
+namespace pokertools
+{
+    uint64_t calculateFileChecksum(const uint8_t* data, size_t size) noexcept
+    {
+        uint64_t hash = 0xCBF29CE484222325ull;
+
+        for (size_t i = 0; i < size; i++) {
+            hash = (hash ^ data[i]) * 0x100000001B3ull;
+        }
+
+        return hash;
+    }
+
+    MappedFile::MappedFile() noexcept
+        : mapping(nullptr), mappingSize(0)
+    {
+    }
+
+    MappedFile::MappedFile(const std::string& fileName, const char* fileDescription, uint64_t minimumSize, uint64_t maximumSize)
+        : mapping(nullptr), mappingSize(0)
+    {
+        int fileDescriptor = open(fileName.c_str(), O_RDONLY);
+
+        if (fileDescriptor == -1) {
+            throw std::runtime_error(std::string("Can't open ") + fileDescription + " file " + fileName);
+        }
+
+        struct stat fileStatus;
+
+        if ((fstat(fileDescriptor, &fileStatus) != 0) || (static_cast<uint64_t>(fileStatus.st_size) < minimumSize) ||
+            (static_cast<uint64_t>(fileStatus.st_size) > maximumSize)) {
+            close(fileDescriptor);
+            throw std::runtime_error(std::string("Invalid size of ") + fileDescription + " file " + fileName);
+        }
+
+        void* fileMapping = mmap(nullptr, fileStatus.st_size, PROT_READ, MAP_SHARED, fileDescriptor, 0);
+        close(fileDescriptor); // Mapping keeps file open
+
+        if (fileMapping == MAP_FAILED) {
+            throw std::runtime_error(std::string("Can't map ") + fileDescription + " file " + fileName);
+        }
+
+        mapping = fileMapping;
+        mappingSize = fileStatus.st_size;
+    }
+
+    MappedFile::MappedFile(MappedFile&& other) noexcept
+        : mapping(other.mapping), mappingSize(other.mappingSize)
+    {
+        other.mapping = nullptr;
+        other.mappingSize = 0;
+    }
+
+    MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+    {
+        std::swap(mapping, other.mapping);
+        std::swap(mappingSize, other.mappingSize);
+
+        return *this;
+    }
+
+    MappedFile::~MappedFile()
+    {
+        if (mapping) {
+            munmap(mapping, mappingSize);
+        }
+    }
+}
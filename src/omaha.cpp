@@ -0,0 +1,249 @@
+/* pokertools - tools for poker related coding
+ * Copyright (C) 2016 Andriy Lysnevych
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+#include <pokertools-cpp/evaluators.hpp>
+#include "tables.hpp"
+#include "values.hpp"
+#include "lowball.hpp"
+
+#include <algorithm>
+
+namespace pokertools
+{
+    using tables::numberOfBits;
+    using tables::rankOfStraights;
+    using tables::highBit;
+    using tables::highUpTo3Bits;
+
+    static constexpr unsigned StraightsCount = 10;
+    static constexpr unsigned MaxOmahaHoleCardsCount = 6;
+    static constexpr unsigned MaxBoardCardsCount = 5;
+
+    // From the highest straight to the five high one
+    static constexpr uint16_t straightsRanks[StraightsCount] = {
+        0b1111100000000, 0b0111110000000, 0b0011111000000, 0b0001111100000, 0b0000111110000,
+        0b0000011111000, 0b0000001111100, 0b0000000111110, 0b0000000011111, 0b1000000001111
+    };
+
+    static inline uint16_t getStraightHighRank(unsigned straightIndex) noexcept
+    {
+        return (straightIndex + 1 < StraightsCount) ? (1 << (RanksCount - 1 - straightIndex)) : (1 << 3);
+    }
+
+    // Ranks of cards, one bit per card
+    static unsigned splitToRanks(Hand hand, uint16_t* ranks) noexcept
+    {
+        unsigned count = 0;
+
+        for (unsigned suit = 0; suit < SuitsCount; suit++) {
+            for (uint16_t suitRanks = hand.suit(static_cast<Suit>(suit)); suitRanks != 0; suitRanks &= suitRanks - 1) {
+                ranks[count++] = suitRanks & (~suitRanks + 1);
+            }
+        }
+
+        return count;
+    }
+
+    // Layer i contains ranks that appear more than i times, layers work as suits of a hand without flush
+    static inline void addRank(uint16_t* layers, uint16_t rank) noexcept
+    {
+        layers[3] |= layers[2] & rank;
+        layers[2] |= layers[1] & rank;
+        layers[1] |= layers[0] & rank;
+        layers[0] |= rank;
+    }
+
+    static inline uint32_t evaluateLayers(const uint16_t* layers) noexcept
+    {
+        if (numberOfBits[layers[0]] == 5) {
+            uint16_t straightRank = rankOfStraights[layers[0]];
+            return (straightRank != 0) ? calculateStraightValue(straightRank) : calculateHighCardValue(layers[0]);
+        }
+
+        return evaluateHoldem5CardsHand(static_cast<uint64_t>(layers[0]) | (static_cast<uint64_t>(layers[1]) << SuitSizeInBits) |
+                                        (static_cast<uint64_t>(layers[2]) << 2 * SuitSizeInBits) | (static_cast<uint64_t>(layers[3]) << 3 * SuitSizeInBits));
+    }
+
+    uint32_t evaluateOmahaHand(Hand holeCards, Hand board, unsigned holeCardsCount) noexcept
+    {
+        assert((holeCardsCount >= 4) && (holeCardsCount <= MaxOmahaHoleCardsCount));
+        assert(countCards(holeCards) == holeCardsCount);
+        assert((countCards(board) >= 3) && (countCards(board) <= MaxBoardCardsCount));
+        assert((holeCards & board) == 0);
+
+        // Flush and Straight Flush are possible only in suits with 2 hole and 3 board cards
+        uint32_t flushValue = 0;
+        uint16_t straightFlushRank = 0;
+
+        for (unsigned suit = 0; suit < SuitsCount; suit++) {
+            uint16_t holeSuit = holeCards.suit(static_cast<Suit>(suit));
+            uint16_t boardSuit = board.suit(static_cast<Suit>(suit));
+
+            if ((numberOfBits[holeSuit] < 2) || (numberOfBits[boardSuit] < 3)) {
+                continue;
+            }
+
+            for (unsigned i = 0; i < StraightsCount; i++) {
+                uint16_t straight = straightsRanks[i];
+
+                // Board and hole cards of one suit have different ranks, so the other 3 ranks come from board
+                if (((straight & ~(holeSuit | boardSuit)) == 0) && (numberOfBits[straight & holeSuit] == 2)) {
+                    straightFlushRank = std::max(straightFlushRank, getStraightHighRank(i));
+                    break;
+                }
+            }
+
+            uint16_t firstHoleRank = highBit[holeSuit];
+            uint16_t secondHoleRank = highBit[holeSuit ^ firstHoleRank];
+
+            flushValue = std::max(flushValue, calculateFlushValue(firstHoleRank | secondHoleRank | highUpTo3Bits[boardSuit]));
+        }
+
+        if (straightFlushRank != 0) {
+            return calculateStraightFlushValue(straightFlushRank);
+        }
+
+        uint16_t holeRanks[MaxOmahaHoleCardsCount];
+        uint16_t boardRanks[MaxBoardCardsCount];
+        unsigned boardCardsCount = splitToRanks(board, boardRanks);
+        splitToRanks(holeCards, holeRanks);
+
+        uint16_t allHoleRanks = holeCards.suit(Suit::Clubs) | holeCards.suit(Suit::Diamonds) | holeCards.suit(Suit::Hearts) | holeCards.suit(Suit::Spades);
+        uint16_t allBoardRanks = board.suit(Suit::Clubs) | board.suit(Suit::Diamonds) | board.suit(Suit::Hearts) | board.suit(Suit::Spades);
+        bool isBoardPaired = numberOfBits[allBoardRanks] < boardCardsCount;
+        uint32_t straightValue = 0;
+
+        for (unsigned i = 0; i < StraightsCount; i++) {
+            uint16_t straight = straightsRanks[i];
+            uint16_t ranksMissingOnBoard = straight & ~allBoardRanks;
+
+            // Up to 2 missing ranks come from hole cards that can add more ranks of the straight instead of board ones
+            if ((numberOfBits[ranksMissingOnBoard] <= 2) && ((ranksMissingOnBoard & ~allHoleRanks) == 0) && (numberOfBits[straight & allHoleRanks] >= 2)) {
+                straightValue = calculateStraightValue(getStraightHighRank(i));
+                break;
+            }
+        }
+
+        // Full House and Four of a Kind need paired board
+        if (!isBoardPaired && ((flushValue | straightValue) != 0)) {
+            return std::max(flushValue, straightValue);
+        }
+
+        // Other hand types depend only on ranks, so equal ranks combinations of hole cards are evaluated once
+        uint16_t holeRanksPairs[MaxOmahaHoleCardsCount * (MaxOmahaHoleCardsCount - 1) / 2][2];
+        unsigned holeRanksPairsCount = 0;
+
+        for (unsigned i = 0; i < holeCardsCount; i++) {
+            for (unsigned j = i + 1; j < holeCardsCount; j++) {
+                uint16_t first = std::max(holeRanks[i], holeRanks[j]);
+                uint16_t second = std::min(holeRanks[i], holeRanks[j]);
+                bool isDuplicate = false;
+
+                for (unsigned k = 0; k < holeRanksPairsCount; k++) {
+                    isDuplicate |= (holeRanksPairs[k][0] == first) && (holeRanksPairs[k][1] == second);
+                }
+
+                if (!isDuplicate) {
+                    holeRanksPairs[holeRanksPairsCount][0] = first;
+                    holeRanksPairs[holeRanksPairsCount][1] = second;
+                    holeRanksPairsCount++;
+                }
+            }
+        }
+
+        uint32_t value = std::max(flushValue, straightValue);
+
+        for (unsigned i = 0; i < boardCardsCount; i++) {
+            for (unsigned j = i + 1; j < boardCardsCount; j++) {
+                for (unsigned k = j + 1; k < boardCardsCount; k++) {
+                    uint16_t boardLayers[4] = {};
+
+                    addRank(boardLayers, boardRanks[i]);
+                    addRank(boardLayers, boardRanks[j]);
+                    addRank(boardLayers, boardRanks[k]);
+
+                    // Only Full House or Four of a Kind can beat Flush and they need pair on board
+                    if ((flushValue != 0) && (boardLayers[1] == 0)) {
+                        continue;
+                    }
+
+                    for (unsigned pair = 0; pair < holeRanksPairsCount; pair++) {
+                        uint16_t layers[4] = { boardLayers[0], boardLayers[1], boardLayers[2], boardLayers[3] };
+
+                        addRank(layers, holeRanksPairs[pair][0]);
+                        addRank(layers, holeRanksPairs[pair][1]);
+
+                        value = std::max(value, evaluateLayers(layers));
+                    }
+                }
+            }
+        }
+
+        return value;
+    }
+
+    // Low depends only on ranks: 2 distinct hole ranks and 3 lowest board ranks different from them
+    static inline uint32_t evaluateOmahaEightOrBetterLow(uint16_t allHoleRanks, uint16_t allBoardRanks) noexcept
+    {
+        uint16_t holeLowRanks = toAceLowRanks(allHoleRanks) & EightOrBetterRanks;
+        uint16_t boardLowRanks = toAceLowRanks(allBoardRanks) & EightOrBetterRanks;
+
+        if ((numberOfBits[holeLowRanks] < 2) || (numberOfBits[boardLowRanks] < 3) || (numberOfBits[holeLowRanks | boardLowRanks] < 5)) {
+            return 0;
+        }
+
+        uint16_t bestLowRanks = AllRanks;
+
+        for (uint16_t first = holeLowRanks; first != 0; first &= first - 1) {
+            for (uint16_t second = first & (first - 1); second != 0; second &= second - 1) {
+                uint16_t holeRanks = lowBit(first) | lowBit(second);
+                uint16_t boardRanks = boardLowRanks & ~holeRanks;
+
+                if (numberOfBits[boardRanks] >= 3) {
+                    uint16_t firstBoardRank = lowBit(boardRanks);
+                    uint16_t secondBoardRank = lowBit(boardRanks ^ firstBoardRank);
+                    uint16_t thirdBoardRank = lowBit(boardRanks ^ firstBoardRank ^ secondBoardRank);
+
+                    bestLowRanks = std::min<uint16_t>(bestLowRanks, holeRanks | firstBoardRank | secondBoardRank | thirdBoardRank);
+                }
+            }
+        }
+
+        return (bestLowRanks != AllRanks) ? toLowValue(calculateHighCardValue(bestLowRanks)) : 0;
+    }
+
+    static inline uint16_t getRanks(Hand hand) noexcept
+    {
+        return hand.suit(Suit::Clubs) | hand.suit(Suit::Diamonds) | hand.suit(Suit::Hearts) | hand.suit(Suit::Spades);
+    }
+
+    uint32_t evaluateOmahaEightOrBetterLowHand(Hand holeCards, Hand board, unsigned holeCardsCount) noexcept
+    {
+        assert((holeCardsCount >= 4) && (holeCardsCount <= MaxOmahaHoleCardsCount));
+        assert(countCards(holeCards) == holeCardsCount);
+        assert((countCards(board) >= 3) && (countCards(board) <= MaxBoardCardsCount));
+        assert((holeCards & board) == 0);
+
+        return evaluateOmahaEightOrBetterLow(getRanks(holeCards), getRanks(board));
+    }
+
+    HiLoValues evaluateOmahaHiLoHand(Hand holeCards, Hand board, unsigned holeCardsCount) noexcept
+    {
+        return HiLoValues{evaluateOmahaHand(holeCards, board, holeCardsCount), evaluateOmahaEightOrBetterLow(getRanks(holeCards), getRanks(board))};
+    }
+}
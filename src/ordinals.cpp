@@ -0,0 +1,72 @@
+/* pokertools - tools for poker related coding
+ * Copyright (C) 2016 Andriy Lysnevych
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+#include "tables.hpp"
+
+#include <cassert>
+
+namespace pokertools
+{
+    /**
+     * Ordinal is offset of hand type plus index of main ranks times number of
+     * kickers combinations plus index of kickers among ranks left. Straights
+     * have single rank bit from 5 (index 3) up, so their offsets are shifted.
+     */
+    static constexpr unsigned OrdinalsOffsets[] = { 0, 1277, 4137, 4995, 5853 - 3, 5863, 7140, 7296, 7452 - 3 };
+    static constexpr unsigned KickersCombinationsCounts[] = { 0, 220, 11, 66, 0, 0, 12, 12, 0 };
+
+    // Removes main ranks (up to 2 bits) from kickers ranks, so kickers are indexed among ranks left
+    static inline uint16_t removeRanks(uint16_t kickers, uint16_t ranks) noexcept
+    {
+        uint16_t lowest = ranks & (~ranks + 1);
+        uint16_t highest = ranks ^ lowest;
+        uint16_t belowHighest = highest - 1;
+        uint16_t belowLowest = lowest - 1;
+
+        kickers = (kickers & belowHighest) | ((kickers >> 1) & ~belowHighest);
+        return (kickers & belowLowest) | ((kickers >> 1) & ~belowLowest);
+    }
+
+    unsigned convertValueToOrdinal(uint32_t value) noexcept
+    {
+        unsigned handType = value >> HandTypeInValueShift;
+        uint16_t highRanks = (value >> RanksCount) & ((1 << RanksCount) - 1);
+        uint16_t lowRanks = value & ((1 << RanksCount) - 1);
+
+        assert(handType <= static_cast<unsigned>(HandType::StraightFulsh));
+
+        unsigned ordinal = OrdinalsOffsets[handType] + tables::ranksIndexes[highRanks] * KickersCombinationsCounts[handType] +
+                           tables::ranksIndexes[removeRanks(lowRanks, highRanks)];
+
+        assert(tables::ordinalValues[ordinal] == value);
+        return ordinal;
+    }
+
+    uint32_t convertOrdinalToValue(unsigned ordinal) noexcept
+    {
+        assert(ordinal < HandValuesCount);
+        return tables::ordinalValues[ordinal];
+    }
+
+    void convertValuesToOrdinals(const uint32_t* values, uint16_t* ordinals, size_t count) noexcept
+    {
+        for (size_t i = 0; i < count; i++) {
+            ordinals[i] = convertValueToOrdinal(values[i]);
+        }
+    }
+}
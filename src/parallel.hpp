@@ -0,0 +1,75 @@
+/* pokertools - tools for poker related coding
+ * Copyright (C) 2016 Andriy Lysnevych
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+/**
+ * Minimal parallel loop used by library algorithms that split work to threads.
+ */
+
+#pragma once
+
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <algorithm>
+
+namespace pokertools
+{
+    inline unsigned resolveThreadsCount(unsigned threadsCount) noexcept
+    {
+        return (threadsCount != 0) ? threadsCount : std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    /**
+     * Calls function(taskIndex, threadIndex) for every task index in [0, tasksCount)
+     * using up to threadsCount threads (0 means number of hardware threads). Tasks
+     * are taken dynamically, so function must not depend on which thread runs it
+     * except for using per thread state selected by threadIndex.
+     */
+    template<typename Function>
+    void parallelFor(unsigned threadsCount, size_t tasksCount, Function&& function)
+    {
+        threadsCount = static_cast<unsigned>(std::min<size_t>(resolveThreadsCount(threadsCount), tasksCount));
+
+        if (threadsCount <= 1) {
+            for (size_t i = 0; i < tasksCount; i++) {
+                function(i, 0u);
+            }
+            return;
+        }
+
+        std::atomic<size_t> nextTaskIndex(0);
+        auto worker = [&] (unsigned threadIndex) {
+            for (size_t i = nextTaskIndex++; i < tasksCount; i = nextTaskIndex++) {
+                function(i, threadIndex);
+            }
+        };
+
+        std::vector<std::thread> threads;
+        threads.reserve(threadsCount - 1);
+
+        for (unsigned i = 1; i < threadsCount; i++) {
+            threads.emplace_back(worker, i);
+        }
+
+        worker(0);
+
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+    }
+}
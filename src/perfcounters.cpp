@@ -0,0 +1,109 @@
+/* pokertools - tools for poker related coding
+ * Copyright (C) 2016 Andriy Lysnevych
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+#include <pokertools-cpp/perfcounters.hpp>
+
+#ifdef POKERTOOLS_PERF_COUNTERS
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace pokertools
+{
+    // Order of counters in fileDescriptors, the first one leads the group
+    static const uint32_t countersTypes[] = { PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE, PERF_TYPE_HW_CACHE };
+    static const uint64_t countersConfigs[] = {
+        PERF_COUNT_HW_CPU_CYCLES,
+        PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_BRANCH_MISSES,
+        PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+        PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)
+    };
+
+    static int openCounter(uint32_t type, uint64_t config, int groupFileDescriptor) noexcept
+    {
+        perf_event_attr attributes{};
+        attributes.size = sizeof(attributes);
+        attributes.type = type;
+        attributes.config = config;
+        attributes.disabled = (groupFileDescriptor == -1) ? 1 : 0;
+        attributes.exclude_kernel = 1;
+        attributes.exclude_hv = 1;
+
+        return static_cast<int>(syscall(__NR_perf_event_open, &attributes, 0, -1, groupFileDescriptor, 0));
+    }
+
+    PerfCounters::PerfCounters() noexcept
+    {
+        fileDescriptors[0] = openCounter(countersTypes[0], countersConfigs[0], -1);
+
+        for (unsigned i = 1; i < CountersCount; i++) {
+            fileDescriptors[i] = (fileDescriptors[0] != -1) ? openCounter(countersTypes[i], countersConfigs[i], fileDescriptors[0]) : -1;
+        }
+    }
+
+    PerfCounters::~PerfCounters()
+    {
+        for (int fileDescriptor : fileDescriptors) {
+            if (fileDescriptor != -1) {
+                close(fileDescriptor);
+            }
+        }
+    }
+
+    bool PerfCounters::isAvailable() const noexcept
+    {
+        return fileDescriptors[0] != -1;
+    }
+
+    void PerfCounters::start() noexcept
+    {
+        if (isAvailable()) {
+            ioctl(fileDescriptors[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+            ioctl(fileDescriptors[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        }
+    }
+
+    PerfCountersValues PerfCounters::stop() noexcept
+    {
+        uint64_t values[CountersCount] = {};
+
+        if (isAvailable()) {
+            ioctl(fileDescriptors[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+            for (unsigned i = 0; i < CountersCount; i++) {
+                if ((fileDescriptors[i] == -1) || (read(fileDescriptors[i], &values[i], sizeof(uint64_t)) != sizeof(uint64_t))) {
+                    values[i] = 0;
+                }
+            }
+        }
+
+        PerfCountersValues result;
+        result.cycles = values[0];
+        result.instructions = values[1];
+        result.branchMisses = values[2];
+        result.l1dReadMisses = values[3];
+        result.dtlbReadMisses = values[4];
+
+        return result;
+    }
+}
+
+#endif
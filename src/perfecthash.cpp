@@ -0,0 +1,134 @@
+/* pokertools - tools for poker related coding
+ * Copyright (C) 2016 Andriy Lysnevych
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+#include "perfecthash.hpp"
+
+#include <vector>
+
+namespace pokertools
+{
+    namespace perfecthash
+    {
+        // Counts of ranks of one part decoded from its base 5 key
+        static unsigned decodeKey(unsigned key, unsigned ranksCount, unsigned* counts) noexcept
+        {
+            unsigned cardsCount = 0;
+
+            for (unsigned rank = 0; rank < ranksCount; rank++) {
+                counts[rank] = key % 5;
+                cardsCount += counts[rank];
+                key /= 5;
+            }
+
+            return cardsCount;
+        }
+
+        // Every rank's cards go to the least filled suits, so no suit gets more than 2 cards
+        static Hand createHandWithoutFlush(const unsigned* counts) noexcept
+        {
+            unsigned suitsCardsCounts[SuitsCount] = {};
+            uint64_t bits = 0;
+
+            for (unsigned rank = 0; rank < RanksCount; rank++) {
+                bool isUsed[SuitsCount] = {};
+
+                for (unsigned i = 0; i < counts[rank]; i++) {
+                    unsigned suit = SuitsCount;
+
+                    for (unsigned candidate = 0; candidate < SuitsCount; candidate++) {
+                        if (!isUsed[candidate] && ((suit == SuitsCount) || (suitsCardsCounts[candidate] < suitsCardsCounts[suit]))) {
+                            suit = candidate;
+                        }
+                    }
+
+                    isUsed[suit] = true;
+                    suitsCardsCounts[suit]++;
+                    bits |= uint64_t(1) << (rank + SuitSizeInBits * suit);
+                }
+            }
+
+            return bits;
+        }
+
+        std::unique_ptr<Tables> createTables()
+        {
+            std::unique_ptr<Tables> tables(new Tables());
+
+            for (unsigned ranks = 0; ranks < (1 << LowRanksCount); ranks++) {
+                for (unsigned rank = 0, power = 1; rank < LowRanksCount; rank++, power *= 5) {
+                    tables->lowKeys[ranks] += (ranks & (1 << rank)) ? power : 0;
+                }
+            }
+
+            for (unsigned ranks = 0; ranks < (1 << HighRanksCount); ranks++) {
+                for (unsigned rank = 0, power = 1; rank < HighRanksCount; rank++, power *= 5) {
+                    tables->highKeys[ranks] += (ranks & (1 << rank)) ? power : 0;
+                }
+            }
+
+            unsigned counts[RanksCount];
+            std::vector<unsigned> lowKeysByCardsCount[8];
+
+            for (unsigned key = 0; key < LowKeysCount; key++) {
+                unsigned cardsCount = decodeKey(key, LowRanksCount, counts);
+
+                if (cardsCount <= 7) {
+                    tables->lowIndexes[key] = static_cast<uint16_t>(lowKeysByCardsCount[cardsCount].size());
+                    lowKeysByCardsCount[cardsCount].push_back(key);
+                }
+            }
+
+            unsigned offset = 0;
+
+            for (unsigned key = 0; key < HighKeysCount; key++) {
+                unsigned cardsCount = decodeKey(key, HighRanksCount, counts);
+
+                if (cardsCount <= 7) {
+                    tables->highOffsets[key] = offset;
+                    offset += static_cast<unsigned>(lowKeysByCardsCount[7 - cardsCount].size());
+                }
+            }
+
+            assert(offset == RanksMultisetsCount);
+
+            for (unsigned highKey = 0; highKey < HighKeysCount; highKey++) {
+                unsigned highCardsCount = decodeKey(highKey, HighRanksCount, counts + LowRanksCount);
+
+                if (highCardsCount > 7) {
+                    continue;
+                }
+
+                for (unsigned lowKey : lowKeysByCardsCount[7 - highCardsCount]) {
+                    decodeKey(lowKey, LowRanksCount, counts);
+                    tables->values[tables->highOffsets[highKey] + tables->lowIndexes[lowKey]] = evaluateHoldemHand(createHandWithoutFlush(counts), 7);
+                }
+            }
+
+            // Flush or Straight Flush value depends only on ranks of the flush suit
+            for (unsigned ranks = 0; ranks < BitsArraySize; ranks++) {
+                unsigned cardsCount = countCards(ranks);
+
+                if ((cardsCount >= 5) && (cardsCount <= 7)) {
+                    tables->flushValues[ranks] = evaluateHoldemHand(ranks, cardsCount);
+                }
+            }
+
+            return tables;
+        }
+    }
+}
@@ -0,0 +1,90 @@
+/* pokertools - tools for poker related coding
+ * Copyright (C) 2016 Andriy Lysnevych
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+/**
+ * Perfect hash engine of 7 cards Hold'em evaluator. Hands with flush are
+ * looked up by ranks of the flush suit. Other hands depend only on multiset
+ * of ranks that is hashed to dense index: ranks are split to low (2 to 8) and
+ * high (9 to Ace) parts, counts of ranks in each part are summed as base 5
+ * numbers per suit, and the index is offset of high part block plus index of
+ * low part among low parts with the same number of cards.
+ */
+
+#pragma once
+
+#include <pokertools-cpp/evaluators.hpp>
+
+#include <memory>
+
+namespace pokertools
+{
+    namespace perfecthash
+    {
+        constexpr unsigned LowRanksCount = 7;
+        constexpr unsigned HighRanksCount = RanksCount - LowRanksCount;
+        constexpr unsigned LowKeysCount = 78125; // 5 ^ LowRanksCount
+        constexpr unsigned HighKeysCount = 15625; // 5 ^ HighRanksCount
+        constexpr unsigned RanksMultisetsCount = 49205; // Multisets of 7 ranks with up to 4 cards of a rank
+
+        struct Tables {
+            uint32_t lowKeys[1 << LowRanksCount];
+            uint16_t highKeys[1 << HighRanksCount];
+            uint16_t lowIndexes[LowKeysCount];
+            uint16_t highOffsets[HighKeysCount];
+            uint32_t values[RanksMultisetsCount];
+            uint32_t flushValues[BitsArraySize];
+        };
+
+        extern std::unique_ptr<Tables> createTables();
+
+        // Every suit's 16-bit lane gets 0x10 bit when suit has 5 or more cards
+        inline uint64_t getFlushLanes(uint64_t bits) noexcept
+        {
+            bits = bits - ((bits >> 1) & 0x5555555555555555);
+            bits = (bits & 0x3333333333333333) + ((bits >> 2) & 0x3333333333333333);
+            bits = (bits + (bits >> 4)) & 0x0F0F0F0F0F0F0F0F;
+            bits = (bits + (bits >> 8)) & 0x001F001F001F001F;
+
+            return (bits + 0x000B000B000B000B) & 0x0010001000100010;
+        }
+
+        inline uint32_t evaluate7CardsHand(const Tables& tables, Hand hand) noexcept
+        {
+            uint64_t bits = hand;
+            uint64_t flushLanes = getFlushLanes(bits);
+
+            if (flushLanes != 0) {
+                unsigned shift = __builtin_ctzll(flushLanes) - 4;
+                return tables.flushValues[(bits >> shift) & 0x1FFF];
+            }
+
+            uint16_t clubs = hand.suit(Suit::Clubs);
+            uint16_t diamonds = hand.suit(Suit::Diamonds);
+            uint16_t hearts = hand.suit(Suit::Hearts);
+            uint16_t spades = hand.suit(Suit::Spades);
+
+            const uint16_t lowRanksMask = (1 << LowRanksCount) - 1;
+            uint32_t lowKey = tables.lowKeys[clubs & lowRanksMask] + tables.lowKeys[diamonds & lowRanksMask] +
+                              tables.lowKeys[hearts & lowRanksMask] + tables.lowKeys[spades & lowRanksMask];
+            uint32_t highKey = tables.highKeys[clubs >> LowRanksCount] + tables.highKeys[diamonds >> LowRanksCount] +
+                               tables.highKeys[hearts >> LowRanksCount] + tables.highKeys[spades >> LowRanksCount];
+
+            return tables.values[tables.highOffsets[highKey] + tables.lowIndexes[lowKey]];
+        }
+    }
+}
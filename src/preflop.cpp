@@ -0,0 +1,291 @@
+/* pokertools - tools for poker related coding
+ * Copyright (C) 2016 Andriy Lysnevych
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+#include <pokertools-cpp/preflop.hpp>
+#include <pokertools-cpp/evaluators.hpp>
+#include "parallel.hpp"
+
+#include <stdexcept>
+#include <algorithm>
+#include <fstream>
+#include <cstring>
+
+namespace pokertools
+{
+    static constexpr char PreflopEquityFileMagic[8] = { 'P', 'T', 'P', 'R', 'E', 'F', 'L', 'P' };
+    static constexpr size_t SharesCount = HoleCardsCombinationsCount * HoleCardsCombinationsCount;
+    static constexpr size_t StartingHandsEquitiesCount = StartingHandsCount * StartingHandsCount;
+    static constexpr uint64_t PayloadSize = sizeof(uint32_t) * SharesCount + sizeof(double) * StartingHandsEquitiesCount;
+    static constexpr unsigned BatchBoardsCount = 1024;
+
+    // Hero share of all boards, both hands of every board are evaluated by batch evaluator
+    static uint32_t calculateMatchupShare(Hand heroHoleCards, Hand villainHoleCards)
+    {
+        Hand deck[CardsCount];
+        unsigned deckSize = 0;
+
+        for (unsigned i = 0; i < CardsCount; i++) {
+            Hand card = createCard(i);
+
+            if ((card & (heroHoleCards | villainHoleCards)) == 0) {
+                deck[deckSize++] = card;
+            }
+        }
+
+        std::vector<Hand> hands(2 * BatchBoardsCount); // Hero and villain hands of every board
+        std::vector<uint32_t> values(2 * BatchBoardsCount);
+        unsigned boardsCount = 0;
+        uint32_t share = 0;
+
+        auto evaluateBatch = [&] {
+            evaluateHoldem7CardsHands(hands.data(), values.data(), 2 * boardsCount);
+
+            for (unsigned i = 0; i < boardsCount; i++) {
+                share += (values[2 * i] > values[2 * i + 1]) ? 2 : (values[2 * i] == values[2 * i + 1]) ? 1 : 0;
+            }
+
+            boardsCount = 0;
+        };
+
+        for (unsigned first = 0; first < deckSize; first++) {
+            for (unsigned second = first + 1; second < deckSize; second++) {
+                for (unsigned third = second + 1; third < deckSize; third++) {
+                    for (unsigned fourth = third + 1; fourth < deckSize; fourth++) {
+                        Hand partialBoard = deck[first] | deck[second] | deck[third] | deck[fourth];
+
+                        for (unsigned fifth = fourth + 1; fifth < deckSize; fifth++) {
+                            Hand board = partialBoard | deck[fifth];
+
+                            hands[2 * boardsCount] = heroHoleCards | board;
+                            hands[2 * boardsCount + 1] = villainHoleCards | board;
+
+                            if (++boardsCount == BatchBoardsCount) {
+                                evaluateBatch();
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        evaluateBatch();
+
+        return share;
+    }
+
+    struct Matchup {
+        uint64_t canonicalHero; // Smallest pair of hole cards over suits permutations and both orders
+        uint64_t canonicalVillain;
+        uint16_t heroIndex;
+        uint16_t villainIndex;
+        bool isSwapped;         // Canonical hero comes from villain hole cards
+
+        inline bool operator<(const Matchup& other) const noexcept
+        {
+            return (canonicalHero != other.canonicalHero) ? (canonicalHero < other.canonicalHero) : (canonicalVillain < other.canonicalVillain);
+        }
+    };
+
+    std::vector<uint32_t> calculatePreflopEquityShares(unsigned threadsCount, const std::vector<std::pair<Hand, Hand>>& matchupsSubset)
+    {
+        // Indexes of both orders of matchups of subset
+        std::vector<bool> isInSubset(SharesCount, matchupsSubset.empty());
+
+        for (const std::pair<Hand, Hand>& matchup : matchupsSubset) {
+            if ((countCards(matchup.first) != 2) || (countCards(matchup.second) != 2) || ((matchup.first & matchup.second) != 0)) {
+                throw std::invalid_argument("Matchup must have 2 not overlapping hole cards of both players");
+            }
+
+            unsigned heroIndex = getHoleCardsIndex(matchup.first), villainIndex = getHoleCardsIndex(matchup.second);
+            isInSubset[heroIndex * HoleCardsCombinationsCount + villainIndex] = true;
+            isInSubset[villainIndex * HoleCardsCombinationsCount + heroIndex] = true;
+        }
+
+        Suit permutations[24][SuitsCount];
+        Suit permutation[SuitsCount] = { Suit::Clubs, Suit::Diamonds, Suit::Hearts, Suit::Spades };
+
+        for (auto& suits : permutations) {
+            std::copy_n(permutation, SuitsCount, suits);
+            std::next_permutation(permutation, permutation + SuitsCount);
+        }
+
+        // Matchups equivalent under suits permutations are enumerated once
+        std::vector<Matchup> matchups;
+        matchups.reserve(HoleCardsCombinationsCount * (HoleCardsCombinationsCount - 1) / 2);
+
+        for (unsigned heroIndex = 0; heroIndex < HoleCardsCombinationsCount; heroIndex++) {
+            Hand heroHoleCards = getHoleCardsByIndex(heroIndex);
+
+            for (unsigned villainIndex = heroIndex + 1; villainIndex < HoleCardsCombinationsCount; villainIndex++) {
+                Hand villainHoleCards = getHoleCardsByIndex(villainIndex);
+
+                if ((heroHoleCards & villainHoleCards) != 0) {
+                    continue;
+                }
+
+                Matchup matchup{UINT64_MAX, UINT64_MAX, static_cast<uint16_t>(heroIndex), static_cast<uint16_t>(villainIndex), false};
+
+                for (const auto& suits : permutations) {
+                    uint64_t hero = permuteSuits(heroHoleCards, suits);
+                    uint64_t villain = permuteSuits(villainHoleCards, suits);
+
+                    if ((hero < matchup.canonicalHero) || ((hero == matchup.canonicalHero) && (villain < matchup.canonicalVillain))) {
+                        matchup.canonicalHero = hero;
+                        matchup.canonicalVillain = villain;
+                        matchup.isSwapped = false;
+                    }
+
+                    if ((villain < matchup.canonicalHero) || ((villain == matchup.canonicalHero) && (hero < matchup.canonicalVillain))) {
+                        matchup.canonicalHero = villain;
+                        matchup.canonicalVillain = hero;
+                        matchup.isSwapped = true;
+                    }
+                }
+
+                matchups.push_back(matchup);
+            }
+        }
+
+        std::sort(matchups.begin(), matchups.end());
+
+        std::vector<size_t> classesBegins;
+        std::vector<bool> isClassInSubset;
+
+        for (size_t i = 0; i < matchups.size(); i++) {
+            if ((i == 0) || (matchups[i - 1] < matchups[i])) {
+                classesBegins.push_back(i);
+                isClassInSubset.push_back(false);
+            }
+
+            if (isInSubset[matchups[i].heroIndex * HoleCardsCombinationsCount + matchups[i].villainIndex]) {
+                isClassInSubset.back() = true;
+            }
+        }
+
+        std::vector<uint32_t> classesShares(classesBegins.size());
+
+        parallelFor(threadsCount, classesBegins.size(), [&] (size_t classIndex, unsigned) {
+            if (isClassInSubset[classIndex]) {
+                const Matchup& matchup = matchups[classesBegins[classIndex]];
+                classesShares[classIndex] = calculateMatchupShare(matchup.canonicalHero, matchup.canonicalVillain);
+            }
+        });
+
+        std::vector<uint32_t> shares(SharesCount, 0);
+        size_t classIndex = 0;
+
+        for (size_t i = 0; i < matchups.size(); i++) {
+            if ((classIndex + 1 < classesBegins.size()) && (classesBegins[classIndex + 1] == i)) {
+                classIndex++;
+            }
+
+            if (!isClassInSubset[classIndex]) {
+                continue;
+            }
+
+            const Matchup& matchup = matchups[i];
+            uint32_t canonicalHeroShare = classesShares[classIndex];
+            uint32_t heroShare = matchup.isSwapped ? (PreflopMaxShare - canonicalHeroShare) : canonicalHeroShare;
+
+            shares[matchup.heroIndex * HoleCardsCombinationsCount + matchup.villainIndex] = heroShare;
+            shares[matchup.villainIndex * HoleCardsCombinationsCount + matchup.heroIndex] = PreflopMaxShare - heroShare;
+        }
+
+        return shares;
+    }
+
+    void writePreflopEquityFile(const std::string& fileName, const std::vector<uint32_t>& shares)
+    {
+        if (shares.size() != SharesCount) {
+            throw std::invalid_argument("Preflop equity shares must have HoleCardsCombinationsCount^2 values");
+        }
+
+        std::vector<double> startingHandsEquities(StartingHandsEquitiesCount, 0);
+        std::vector<unsigned> matchupsCounts(StartingHandsEquitiesCount, 0);
+
+        for (unsigned heroIndex = 0; heroIndex < HoleCardsCombinationsCount; heroIndex++) {
+            Hand heroHoleCards = getHoleCardsByIndex(heroIndex);
+            unsigned heroStartingHandIndex = getStartingHandIndex(heroHoleCards);
+
+            for (unsigned villainIndex = 0; villainIndex < HoleCardsCombinationsCount; villainIndex++) {
+                Hand villainHoleCards = getHoleCardsByIndex(villainIndex);
+
+                if ((heroHoleCards & villainHoleCards) == 0) {
+                    unsigned index = heroStartingHandIndex * StartingHandsCount + getStartingHandIndex(villainHoleCards);
+                    startingHandsEquities[index] += static_cast<double>(shares[heroIndex * HoleCardsCombinationsCount + villainIndex]) / PreflopMaxShare;
+                    matchupsCounts[index]++;
+                }
+            }
+        }
+
+        for (size_t i = 0; i < StartingHandsEquitiesCount; i++) {
+            startingHandsEquities[i] /= matchupsCounts[i];
+        }
+
+        std::vector<uint8_t> payload(PayloadSize);
+        std::memcpy(payload.data(), shares.data(), sizeof(uint32_t) * SharesCount);
+        std::memcpy(payload.data() + sizeof(uint32_t) * SharesCount, startingHandsEquities.data(), sizeof(double) * StartingHandsEquitiesCount);
+
+        PreflopEquityFileHeader header{};
+        std::copy_n(PreflopEquityFileMagic, sizeof(header.magic), header.magic);
+        header.version = PreflopEquityFileVersion;
+        header.headerSize = sizeof(PreflopEquityFileHeader);
+        header.combinationsCount = HoleCardsCombinationsCount;
+        header.startingHandsCount = StartingHandsCount;
+        header.maxShare = PreflopMaxShare;
+        header.payloadSize = PayloadSize;
+        header.checksum = calculateFileChecksum(payload.data(), payload.size());
+
+        std::ofstream file(fileName, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(payload.data()), payload.size());
+        file.close();
+
+        if (!file) {
+            throw std::runtime_error("Can't write preflop equity file " + fileName);
+        }
+    }
+
+    PreflopEquityTable::PreflopEquityTable(const std::string& fileName, bool verifyChecksum)
+        : file(fileName, "preflop equity", sizeof(PreflopEquityFileHeader) + PayloadSize, sizeof(PreflopEquityFileHeader) + PayloadSize),
+          shares(nullptr), startingHandsEquities(nullptr)
+    {
+        const PreflopEquityFileHeader& header = *reinterpret_cast<const PreflopEquityFileHeader*>(file.getData());
+        const uint8_t* payload = file.getData() + sizeof(PreflopEquityFileHeader);
+
+        const char* error = nullptr;
+
+        if (!std::equal(header.magic, header.magic + sizeof(header.magic), PreflopEquityFileMagic)) {
+            error = "Not a preflop equity file ";
+        } else if (header.version != PreflopEquityFileVersion) {
+            error = "Unsupported version of preflop equity file ";
+        } else if ((header.headerSize != sizeof(PreflopEquityFileHeader)) || (header.combinationsCount != HoleCardsCombinationsCount) ||
+                   (header.startingHandsCount != StartingHandsCount) || (header.maxShare != PreflopMaxShare) || (header.payloadSize != PayloadSize)) {
+            error = "Invalid header of preflop equity file ";
+        } else if (verifyChecksum && (header.checksum != calculateFileChecksum(payload, PayloadSize))) {
+            error = "Invalid checksum of preflop equity file ";
+        }
+
+        if (error) {
+            throw std::runtime_error(error + fileName);
+        }
+
+        shares = reinterpret_cast<const uint32_t*>(payload);
+        startingHandsEquities = reinterpret_cast<const double*>(payload + sizeof(uint32_t) * SharesCount);
+    }
+}
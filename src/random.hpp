@@ -0,0 +1,80 @@
+/* pokertools - tools for poker related coding
+ * Copyright (C) 2016 Andriy Lysnevych
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+/**
+ * Fast pseudo random generators for simulations. Xoshiro256** generator is
+ * seeded with SplitMix64, so independent streams can be created cheaply from
+ * (seed, stream index) pairs.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace pokertools
+{
+    inline uint64_t splitMix64(uint64_t& state) noexcept
+    {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    class Xoshiro256StarStar
+    {
+    public:
+        Xoshiro256StarStar(uint64_t seed, uint64_t stream = 0) noexcept
+        {
+            uint64_t state = seed ^ splitMix64(stream);
+
+            for (uint64_t& value : _state) {
+                value = splitMix64(state);
+            }
+        }
+
+        inline uint64_t operator()() noexcept
+        {
+            uint64_t result = rotateLeft(_state[1] * 5, 7) * 9;
+            uint64_t t = _state[1] << 17;
+
+            _state[2] ^= _state[0];
+            _state[3] ^= _state[1];
+            _state[1] ^= _state[2];
+            _state[0] ^= _state[3];
+            _state[2] ^= t;
+            _state[3] = rotateLeft(_state[3], 45);
+
+            return result;
+        }
+
+        // Uniform number in [0, range) by multiply-shift, bias is below 2^-32 * range
+        inline uint32_t operator()(uint32_t range) noexcept
+        {
+            return static_cast<uint32_t>(((*this)() >> 32) * range >> 32);
+        }
+
+    private:
+        uint64_t _state[4];
+
+        static inline uint64_t rotateLeft(uint64_t value, int shift) noexcept
+        {
+            return (value << shift) | (value >> (64 - shift));
+        }
+    };
+}
@@ -0,0 +1,573 @@
+/* pokertools - tools for poker related coding
+ * Copyright (C) 2016 Andriy Lysnevych
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+#include <pokertools-cpp/river.hpp>
+#include <pokertools-cpp/evaluators.hpp>
+
+#include <stdexcept>
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+namespace pokertools
+{
+    static constexpr unsigned ExploitabilityCheckInterval = 10; // Exploitability costs about as much as one iteration
+
+    RiverSolver::RiverSolver(const RiverSubgame& subgame)
+        : subgame(subgame), pairsWeight(0), iterationsCount(0), actionsDepth(0), maxActionsCount(0)
+    {
+        if (countCards(subgame.board) != 5) {
+            throw std::invalid_argument("River board must have 5 cards");
+        } else if (!(subgame.pot > 0) || !(subgame.stack >= 0)) {
+            throw std::invalid_argument("Pot must be positive and stack can't be negative");
+        }
+
+        for (const std::vector<double>* sizes : { &subgame.betSizes, &subgame.raiseSizes }) {
+            if (std::any_of(sizes->begin(), sizes->end(), [] (double size) { return !(size > 0); })) {
+                throw std::invalid_argument("Bet sizes must be positive");
+            }
+        }
+
+        initializeRange(0);
+        initializeRange(1);
+
+        // Weight of pairs is sum of weights of opponent hands not sharing cards with every hand
+        double cardsWeights[64] = {}, totalWeight = 0;
+
+        for (size_t i = 0; i < ranges[1].holeCards.size(); i++) {
+            totalWeight += ranges[1].weights[i];
+            cardsWeights[ranges[1].cardsBits[2 * i]] += ranges[1].weights[i];
+            cardsWeights[ranges[1].cardsBits[2 * i + 1]] += ranges[1].weights[i];
+        }
+
+        for (size_t i = 0; i < ranges[0].holeCards.size(); i++) {
+            int sameHand = ranges[0].sameHands[i];
+            double compatibleWeight = totalWeight - cardsWeights[ranges[0].cardsBits[2 * i]] - cardsWeights[ranges[0].cardsBits[2 * i + 1]] +
+                                      ((sameHand >= 0) ? ranges[1].weights[sameHand] : 0.0);
+            pairsWeight += ranges[0].weights[i] * compatibleWeight;
+        }
+
+        if (!(pairsWeight > 0)) {
+            throw std::invalid_argument("Ranges must have hands not sharing cards");
+        }
+
+        double contributions[2] = { 0, 0 };
+        buildNode(0, contributions, 0, false, 0);
+
+        size_t strategiesSize = 0;
+
+        for (Node& node : nodes) {
+            node.strategyOffset = strategiesSize;
+            strategiesSize += node.actions.size() * ranges[node.player].holeCards.size() * (node.type == NodeType::Action);
+        }
+
+        regrets.assign(strategiesSize, 0);
+        cumulativeStrategy.assign(strategiesSize, 0);
+        buffers = createBuffers();
+    }
+
+    void RiverSolver::initializeRange(unsigned player)
+    {
+        Range& range = ranges[player];
+        std::vector<uint32_t> values;
+
+        range.handsIndexes.assign(HoleCardsCombinationsCount, -1);
+
+        for (const WeightedHoleCards& hand : subgame.ranges[player]) {
+            if ((countCards(hand.holeCards) != 2) || !(hand.weight >= 0)) {
+                throw std::invalid_argument("Range must have hole cards of 2 cards with non-negative weights");
+            } else if (range.handsIndexes[getHoleCardsIndex(hand.holeCards)] != -1) {
+                throw std::invalid_argument("Range can't have same hole cards twice");
+            }
+
+            range.handsIndexes[getHoleCardsIndex(hand.holeCards)] = -2; // Seen
+
+            if (((hand.holeCards & subgame.board) == 0) && (hand.weight > 0)) {
+                uint64_t bits = hand.holeCards;
+                range.holeCards.push_back(hand.holeCards);
+                range.weights.push_back(hand.weight);
+                range.values.push_back(evaluateHoldem7CardsHand(hand.holeCards | subgame.board));
+                range.cardsBits.push_back(static_cast<uint8_t>(__builtin_ctzll(bits)));
+                range.cardsBits.push_back(static_cast<uint8_t>(__builtin_ctzll(bits & (bits - 1))));
+            }
+        }
+
+        std::fill(range.handsIndexes.begin(), range.handsIndexes.end(), -1);
+
+        for (size_t i = 0; i < range.holeCards.size(); i++) {
+            range.handsIndexes[getHoleCardsIndex(range.holeCards[i])] = static_cast<int>(i);
+            range.sortedHands.push_back(static_cast<uint32_t>(i));
+        }
+
+        std::sort(range.sortedHands.begin(), range.sortedHands.end(), [&range] (uint32_t first, uint32_t second) {
+            return range.values[first] < range.values[second];
+        });
+
+        // Both ranges are known after second one
+        if (player == 1) {
+            for (unsigned i = 0; i < 2; i++) {
+                ranges[i].sameHands.clear();
+
+                for (Hand holeCards : ranges[i].holeCards) {
+                    ranges[i].sameHands.push_back(ranges[1 - i].handsIndexes[getHoleCardsIndex(holeCards)]);
+                }
+            }
+        }
+    }
+
+    unsigned RiverSolver::buildNode(unsigned player, const double* contributions, unsigned raisesCount, bool isChecked, unsigned depth)
+    {
+        unsigned opponent = 1 - player;
+        double callContribution = std::max(contributions[0], contributions[1]);
+        double potAfterCall = subgame.pot + 2 * callContribution;
+        std::vector<RiverAction> actions;
+
+        if (contributions[player] < contributions[opponent]) {
+            actions.push_back({ RiverActionType::Fold, contributions[player] });
+            actions.push_back({ RiverActionType::Call, callContribution });
+
+            if (raisesCount < subgame.maxRaisesCount) {
+                addBetActions(actions, subgame.raiseSizes, callContribution, potAfterCall, RiverActionType::Raise);
+            }
+        } else {
+            actions.push_back({ RiverActionType::Check, contributions[player] });
+            addBetActions(actions, subgame.betSizes, callContribution, potAfterCall, RiverActionType::Bet);
+        }
+
+        unsigned index = static_cast<unsigned>(nodes.size());
+        nodes.push_back({ NodeType::Action, player, { contributions[0], contributions[1] }, actions, {}, 0 });
+        actionsDepth = std::max(actionsDepth, depth);
+        maxActionsCount = std::max(maxActionsCount, actions.size());
+
+        for (const RiverAction& action : actions) {
+            double childContributions[2] = { contributions[0], contributions[1] };
+            childContributions[player] = action.amount;
+            unsigned child = 0;
+
+            switch (action.type) {
+                case RiverActionType::Fold:
+                    child = addTerminalNode(NodeType::Fold, player, childContributions);
+                    break;
+                case RiverActionType::Call:
+                    child = addTerminalNode(NodeType::Showdown, player, childContributions);
+                    break;
+                case RiverActionType::Check:
+                    child = isChecked ? addTerminalNode(NodeType::Showdown, player, childContributions)
+                                      : buildNode(opponent, childContributions, raisesCount, true, depth + 1);
+                    break;
+                case RiverActionType::Bet:
+                    child = buildNode(opponent, childContributions, raisesCount, false, depth + 1);
+                    break;
+                case RiverActionType::Raise:
+                    child = buildNode(opponent, childContributions, raisesCount + 1, false, depth + 1);
+                    break;
+            }
+
+            nodes[index].children.push_back(child);
+        }
+
+        return index;
+    }
+
+    unsigned RiverSolver::addTerminalNode(NodeType type, unsigned player, const double* contributions)
+    {
+        nodes.push_back({ type, player, { contributions[0], contributions[1] }, {}, {}, 0 });
+        return static_cast<unsigned>(nodes.size() - 1);
+    }
+
+    void RiverSolver::addBetActions(std::vector<RiverAction>& actions, const std::vector<double>& sizes, double callContribution,
+                                    double potAfterCall, RiverActionType type) const
+    {
+        std::vector<double> amounts;
+
+        for (double size : sizes) {
+            amounts.push_back(std::min(callContribution + size * potAfterCall, subgame.stack));
+        }
+
+        if (subgame.allowAllIn) {
+            amounts.push_back(subgame.stack);
+        }
+
+        std::sort(amounts.begin(), amounts.end());
+        amounts.erase(std::unique(amounts.begin(), amounts.end()), amounts.end());
+
+        for (double amount : amounts) {
+            if (amount > callContribution) {
+                actions.push_back({ type, amount });
+            }
+        }
+    }
+
+    std::vector<std::vector<double>> RiverSolver::createBuffers() const
+    {
+        size_t handsCount = std::max(ranges[0].holeCards.size(), ranges[1].holeCards.size());
+        return std::vector<std::vector<double>>(actionsDepth + 1, std::vector<double>((2 * maxActionsCount + 2) * handsCount));
+    }
+
+    void RiverSolver::calculateTerminalValues(const Node& node, unsigned player, const double* reach, double* values) const noexcept
+    {
+        const Range& range = ranges[player];
+        const Range& opponentRange = ranges[1 - player];
+        size_t handsCount = range.holeCards.size();
+        size_t opponentHandsCount = opponentRange.holeCards.size();
+        double cardsReach[64] = {}, totalReach = 0;
+
+        for (size_t i = 0; i < opponentHandsCount; i++) {
+            totalReach += reach[i];
+            cardsReach[opponentRange.cardsBits[2 * i]] += reach[i];
+            cardsReach[opponentRange.cardsBits[2 * i + 1]] += reach[i];
+        }
+
+        if (node.type == NodeType::Fold) {
+            double payoff = (node.player == player) ? -node.contributions[player] : subgame.pot + node.contributions[1 - player];
+
+            for (size_t i = 0; i < handsCount; i++) {
+                int sameHand = range.sameHands[i];
+                double compatibleReach = totalReach - cardsReach[range.cardsBits[2 * i]] - cardsReach[range.cardsBits[2 * i + 1]] +
+                                         ((sameHand >= 0) ? reach[sameHand] : 0.0);
+                values[i] = payoff * compatibleReach;
+            }
+
+            return;
+        }
+
+        // Reach of beaten opponent hands by sweep up, then minus reach of winning hands by sweep down
+        double sweepReach = 0, sweepCardsReach[64] = {};
+
+        for (size_t i = 0, j = 0; i < handsCount; i++) {
+            uint32_t hand = range.sortedHands[i];
+
+            for (; (j < opponentHandsCount) && (opponentRange.values[opponentRange.sortedHands[j]] < range.values[hand]); j++) {
+                uint32_t opponentHand = opponentRange.sortedHands[j];
+                sweepReach += reach[opponentHand];
+                sweepCardsReach[opponentRange.cardsBits[2 * opponentHand]] += reach[opponentHand];
+                sweepCardsReach[opponentRange.cardsBits[2 * opponentHand + 1]] += reach[opponentHand];
+            }
+
+            values[hand] = sweepReach - sweepCardsReach[range.cardsBits[2 * hand]] - sweepCardsReach[range.cardsBits[2 * hand + 1]];
+        }
+
+        sweepReach = 0;
+        std::fill_n(sweepCardsReach, 64, 0.0);
+
+        for (size_t i = handsCount, j = opponentHandsCount; i > 0; i--) {
+            uint32_t hand = range.sortedHands[i - 1];
+
+            for (; (j > 0) && (opponentRange.values[opponentRange.sortedHands[j - 1]] > range.values[hand]); j--) {
+                uint32_t opponentHand = opponentRange.sortedHands[j - 1];
+                sweepReach += reach[opponentHand];
+                sweepCardsReach[opponentRange.cardsBits[2 * opponentHand]] += reach[opponentHand];
+                sweepCardsReach[opponentRange.cardsBits[2 * opponentHand + 1]] += reach[opponentHand];
+            }
+
+            values[hand] -= sweepReach - sweepCardsReach[range.cardsBits[2 * hand]] - sweepCardsReach[range.cardsBits[2 * hand + 1]];
+        }
+
+        // Tie takes half of pot, win takes also called bet
+        double halfPot = subgame.pot / 2;
+        double winPayoff = halfPot + node.contributions[player];
+
+        for (size_t i = 0; i < handsCount; i++) {
+            int sameHand = range.sameHands[i];
+            double compatibleReach = totalReach - cardsReach[range.cardsBits[2 * i]] - cardsReach[range.cardsBits[2 * i + 1]] +
+                                     ((sameHand >= 0) ? reach[sameHand] : 0.0);
+            values[i] = halfPot * compatibleReach + winPayoff * values[i];
+        }
+    }
+
+    // Regret matching+: probabilities proportional to positive regrets, uniform without them
+    void RiverSolver::calculateCurrentStrategy(const Node& node, double* strategy, double* sums) const noexcept
+    {
+        size_t actionsCount = node.actions.size();
+        size_t handsCount = ranges[node.player].holeCards.size();
+        const double* nodeRegrets = &regrets[node.strategyOffset];
+
+        std::fill_n(sums, handsCount, 0.0);
+
+        for (size_t action = 0; action < actionsCount; action++) {
+            for (size_t i = 0; i < handsCount; i++) {
+                sums[i] += nodeRegrets[action * handsCount + i];
+            }
+        }
+
+        for (size_t action = 0; action < actionsCount; action++) {
+            for (size_t i = 0; i < handsCount; i++) {
+                strategy[action * handsCount + i] = (sums[i] > 0) ? nodeRegrets[action * handsCount + i] / sums[i] : 1.0 / actionsCount;
+            }
+        }
+    }
+
+    void RiverSolver::calculateAverageStrategy(const Node& node, double* strategy, double* sums) const noexcept
+    {
+        size_t actionsCount = node.actions.size();
+        size_t handsCount = ranges[node.player].holeCards.size();
+        const double* nodeStrategy = &cumulativeStrategy[node.strategyOffset];
+
+        std::fill_n(sums, handsCount, 0.0);
+
+        for (size_t action = 0; action < actionsCount; action++) {
+            for (size_t i = 0; i < handsCount; i++) {
+                sums[i] += nodeStrategy[action * handsCount + i];
+            }
+        }
+
+        for (size_t action = 0; action < actionsCount; action++) {
+            for (size_t i = 0; i < handsCount; i++) {
+                strategy[action * handsCount + i] = (sums[i] > 0) ? nodeStrategy[action * handsCount + i] / sums[i] : 1.0 / actionsCount;
+            }
+        }
+    }
+
+    /**
+     * Counterfactual values of all hands of player in node, opponent reach
+     * includes weights of opponent range. Hands of player get regrets of
+     * their nodes, hands of opponent get cumulative strategy weighted by
+     * iteration.
+     */
+    void RiverSolver::updateRegrets(unsigned nodeIndex, unsigned player, const double* reach, double* values, unsigned depth)
+    {
+        const Node& node = nodes[nodeIndex];
+
+        if (node.type != NodeType::Action) {
+            calculateTerminalValues(node, player, reach, values);
+            return;
+        }
+
+        size_t actionsCount = node.actions.size();
+        size_t handsCount = ranges[player].holeCards.size();
+        size_t actingHandsCount = ranges[node.player].holeCards.size();
+        size_t bufferHandsCount = std::max(ranges[0].holeCards.size(), ranges[1].holeCards.size());
+        double* strategy = buffers[depth].data();
+        double* actionsValues = strategy + maxActionsCount * bufferHandsCount;
+        double* childReach = actionsValues + maxActionsCount * bufferHandsCount;
+        double* sums = childReach + bufferHandsCount;
+
+        calculateCurrentStrategy(node, strategy, sums);
+        std::fill_n(values, handsCount, 0.0);
+
+        if (node.player == player) {
+            double* nodeRegrets = &regrets[node.strategyOffset];
+
+            for (size_t action = 0; action < actionsCount; action++) {
+                double* actionValues = actionsValues + action * handsCount;
+                updateRegrets(node.children[action], player, reach, actionValues, depth + 1);
+
+                for (size_t i = 0; i < handsCount; i++) {
+                    values[i] += strategy[action * handsCount + i] * actionValues[i];
+                }
+            }
+
+            for (size_t action = 0; action < actionsCount; action++) {
+                for (size_t i = 0; i < handsCount; i++) {
+                    nodeRegrets[action * handsCount + i] = std::max(nodeRegrets[action * handsCount + i] + actionsValues[action * handsCount + i] - values[i], 0.0);
+                }
+            }
+        } else {
+            double* nodeStrategy = &cumulativeStrategy[node.strategyOffset];
+            double iterationWeight = iterationsCount;
+
+            for (size_t action = 0; action < actionsCount; action++) {
+                bool isReached = false;
+
+                for (size_t i = 0; i < actingHandsCount; i++) {
+                    childReach[i] = reach[i] * strategy[action * actingHandsCount + i];
+                    nodeStrategy[action * actingHandsCount + i] += iterationWeight * childReach[i];
+                    isReached |= childReach[i] > 0;
+                }
+
+                // Subtree not reached by opponent can't change values and regrets
+                if (isReached) {
+                    updateRegrets(node.children[action], player, childReach, actionsValues, depth + 1);
+
+                    for (size_t i = 0; i < handsCount; i++) {
+                        values[i] += actionsValues[i];
+                    }
+                }
+            }
+        }
+    }
+
+    // Values of player hands against average strategy of opponent with average or best response strategy of player
+    void RiverSolver::calculateValues(unsigned nodeIndex, unsigned player, const double* reach, double* values, unsigned depth, bool isBestResponse,
+                                      std::vector<std::vector<double>>& depthsBuffers) const
+    {
+        const Node& node = nodes[nodeIndex];
+
+        if (node.type != NodeType::Action) {
+            calculateTerminalValues(node, player, reach, values);
+            return;
+        }
+
+        size_t actionsCount = node.actions.size();
+        size_t handsCount = ranges[player].holeCards.size();
+        size_t actingHandsCount = ranges[node.player].holeCards.size();
+        size_t bufferHandsCount = std::max(ranges[0].holeCards.size(), ranges[1].holeCards.size());
+        double* strategy = depthsBuffers[depth].data();
+        double* actionValues = strategy + maxActionsCount * bufferHandsCount;
+        double* childReach = actionValues + maxActionsCount * bufferHandsCount;
+        double* sums = childReach + bufferHandsCount;
+
+        calculateAverageStrategy(node, strategy, sums);
+        std::fill_n(values, handsCount, ((node.player == player) && isBestResponse) ? -std::numeric_limits<double>::infinity() : 0.0);
+
+        for (size_t action = 0; action < actionsCount; action++) {
+            if (node.player == player) {
+                calculateValues(node.children[action], player, reach, actionValues, depth + 1, isBestResponse, depthsBuffers);
+
+                for (size_t i = 0; i < handsCount; i++) {
+                    values[i] = isBestResponse ? std::max(values[i], actionValues[i]) : values[i] + strategy[action * handsCount + i] * actionValues[i];
+                }
+            } else {
+                for (size_t i = 0; i < actingHandsCount; i++) {
+                    childReach[i] = reach[i] * strategy[action * actingHandsCount + i];
+                }
+
+                calculateValues(node.children[action], player, childReach, actionValues, depth + 1, isBestResponse, depthsBuffers);
+
+                for (size_t i = 0; i < handsCount; i++) {
+                    values[i] += actionValues[i];
+                }
+            }
+        }
+    }
+
+    double RiverSolver::calculateGameValue(unsigned player, bool isBestResponse) const
+    {
+        std::vector<std::vector<double>> depthsBuffers = createBuffers();
+        std::vector<double> values(ranges[player].holeCards.size());
+        double value = 0;
+
+        calculateValues(getRootNode(), player, ranges[1 - player].weights.data(), values.data(), 0, isBestResponse, depthsBuffers);
+
+        for (size_t i = 0; i < values.size(); i++) {
+            value += ranges[player].weights[i] * values[i];
+        }
+
+        return value / pairsWeight;
+    }
+
+    RiverSolverResult RiverSolver::solve(unsigned maxIterationsCount, double targetExploitability, double secondsBudget)
+    {
+        auto begin = std::chrono::steady_clock::now();
+        auto getSeconds = [begin] () {
+            return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        };
+
+        std::vector<double> values(std::max(ranges[0].holeCards.size(), ranges[1].holeCards.size()));
+        double exploitability = -1;
+
+        for (unsigned iteration = 0; iteration < maxIterationsCount; iteration++) {
+            iterationsCount++;
+            exploitability = -1;
+
+            for (unsigned player = 0; player < 2; player++) {
+                updateRegrets(getRootNode(), player, ranges[1 - player].weights.data(), values.data(), 0);
+            }
+
+            if ((targetExploitability > 0) && (iterationsCount % ExploitabilityCheckInterval == 0)) {
+                exploitability = calculateExploitability();
+
+                if (exploitability <= targetExploitability) {
+                    break;
+                }
+            }
+
+            if ((secondsBudget > 0) && (getSeconds() >= secondsBudget)) {
+                break;
+            }
+        }
+
+        if (exploitability < 0) {
+            exploitability = calculateExploitability();
+        }
+
+        return { iterationsCount, exploitability, getSeconds() };
+    }
+
+    double RiverSolver::calculateExploitability() const
+    {
+        // Values of both players sum to pot
+        return (calculateGameValue(0, true) + calculateGameValue(1, true) - subgame.pot) / 2;
+    }
+
+    double RiverSolver::calculateExpectedValue(unsigned player) const
+    {
+        if (player > 1) {
+            throw std::invalid_argument("Invalid river player");
+        }
+
+        return calculateGameValue(player, false);
+    }
+
+    unsigned RiverSolver::getPlayer(unsigned node) const
+    {
+        if (node >= nodes.size()) {
+            throw std::invalid_argument("Invalid river node");
+        }
+
+        return nodes[node].player;
+    }
+
+    const std::vector<RiverAction>& RiverSolver::getActions(unsigned node) const
+    {
+        if (node >= nodes.size()) {
+            throw std::invalid_argument("Invalid river node");
+        }
+
+        return nodes[node].actions;
+    }
+
+    unsigned RiverSolver::getChild(unsigned node, unsigned action) const
+    {
+        if ((node >= nodes.size()) || (action >= nodes[node].children.size())) {
+            throw std::invalid_argument("Invalid river node or action");
+        }
+
+        return nodes[node].children[action];
+    }
+
+    std::vector<double> RiverSolver::getStrategy(unsigned node, Hand holeCards) const
+    {
+        if ((node >= nodes.size()) || (nodes[node].type != NodeType::Action)) {
+            throw std::invalid_argument("Strategy exists only for action nodes");
+        }
+
+        const Node& actionNode = nodes[node];
+        const Range& range = ranges[actionNode.player];
+        int hand = (countCards(holeCards) == 2) ? range.handsIndexes[getHoleCardsIndex(holeCards)] : -1;
+
+        if (hand < 0) {
+            throw std::invalid_argument("Hole cards aren't in range of acting player");
+        }
+
+        size_t handsCount = range.holeCards.size();
+        std::vector<double> strategy(actionNode.actions.size());
+        double sum = 0;
+
+        for (size_t action = 0; action < strategy.size(); action++) {
+            strategy[action] = cumulativeStrategy[actionNode.strategyOffset + action * handsCount + hand];
+            sum += strategy[action];
+        }
+
+        for (double& probability : strategy) {
+            probability = (sum > 0) ? probability / sum : 1.0 / strategy.size();
+        }
+
+        return strategy;
+    }
+}
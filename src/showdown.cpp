@@ -0,0 +1,322 @@
+/* pokertools - tools for poker related coding
+ * Copyright (C) 2016 Andriy Lysnevych
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+#include <pokertools-cpp/showdown.hpp>
+
+#include <stdexcept>
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace pokertools
+{
+    static constexpr unsigned BoardSize = 5;
+    static constexpr unsigned PaddedValuesCount = 16; // Values of one deal are read by vectors of 16 lanes
+    static constexpr unsigned BatchDealsCount = 256;
+
+    static_assert(MaxShowdownPlayersCount <= PaddedValuesCount, "players of one deal must fit one vector");
+
+    struct Pots {
+        unsigned count;
+        uint64_t amounts[MaxShowdownPlayersCount];
+        uint32_t eligiblePlayers[MaxShowdownPlayersCount]; // Bit per player
+        uint32_t winners[MaxShowdownPlayersCount];
+    };
+
+    using FindWinners = void (*)(const uint32_t* values, Pots& pots);
+
+    static void checkPlayersCount(unsigned playersCount)
+    {
+        if ((playersCount == 0) || (playersCount > MaxShowdownPlayersCount)) {
+            throw std::invalid_argument("Number of players must be from 1 to 10");
+        }
+    }
+
+    static void checkDeal(Hand board, const Hand* holeCards, unsigned playersCount)
+    {
+        if (countCards(board) != BoardSize) {
+            throw std::invalid_argument("Board must have exactly 5 cards");
+        }
+
+        Hand usedCards = board;
+        bool hasLivePlayer = false;
+
+        for (unsigned i = 0; i < playersCount; i++) {
+            if (holeCards[i] != FoldedHoleCards) {
+                if (countCards(holeCards[i]) != 2) {
+                    throw std::invalid_argument("Player must have exactly 2 hole cards or FoldedHoleCards");
+                }
+
+                if ((usedCards & holeCards[i]) != 0) {
+                    throw std::invalid_argument("Cards must not overlap");
+                }
+
+                usedCards |= holeCards[i];
+                hasLivePlayer = true;
+            }
+        }
+
+        if (!hasLivePlayer) {
+            throw std::invalid_argument("At least one player must not fold");
+        }
+    }
+
+    // Pots by distinct contributions of players that didn't fold, from the main pot to the last side pot
+    static void createPots(const Hand* holeCards, const uint64_t* contributions, unsigned playersCount, Pots& pots) noexcept
+    {
+        uint64_t liveContributions[MaxShowdownPlayersCount];
+        uint64_t maxLiveContribution = 0;
+        uint32_t livePlayers = 0;
+
+        for (unsigned i = 0; i < playersCount; i++) {
+            bool isLive = holeCards[i] != FoldedHoleCards;
+            liveContributions[i] = isLive ? contributions[i] : 0;
+            maxLiveContribution = std::max(maxLiveContribution, liveContributions[i]);
+            livePlayers |= static_cast<uint32_t>(isLive) << i;
+        }
+
+        // Loops are branchless as contributions are unpredictable. Chips of folded players alone make one pot of all live players.
+        uint64_t previousLevel = 0;
+        pots.count = 0;
+
+        do {
+            uint64_t level = maxLiveContribution;
+
+            for (unsigned i = 0; i < playersCount; i++) {
+                level = std::min(level, (liveContributions[i] > previousLevel) ? liveContributions[i] : level);
+            }
+
+            uint64_t maxPotContribution = (level == maxLiveContribution) ? UINT64_MAX : level;
+            uint64_t amount = 0;
+            uint32_t eligiblePlayers = 0;
+
+            for (unsigned i = 0; i < playersCount; i++) {
+                uint64_t contribution = contributions[i];
+                amount += std::min(contribution, maxPotContribution) - std::min(contribution, previousLevel);
+                eligiblePlayers |= static_cast<uint32_t>(contribution >= level) << i;
+            }
+
+            pots.amounts[pots.count] = amount;
+            pots.eligiblePlayers[pots.count] = eligiblePlayers & livePlayers;
+            pots.count++;
+            previousLevel = level;
+        } while (previousLevel < maxLiveContribution);
+    }
+
+    static void findWinnersScalar(const uint32_t* values, Pots& pots) noexcept
+    {
+        for (unsigned pot = 0; pot < pots.count; pot++) {
+            uint32_t bestValue = 0;
+            uint32_t winners = 0;
+
+            for (uint32_t players = pots.eligiblePlayers[pot]; players != 0; players &= players - 1) {
+                bestValue = std::max(bestValue, values[__builtin_ctz(players)]);
+            }
+
+            for (uint32_t players = pots.eligiblePlayers[pot]; players != 0; players &= players - 1) {
+                unsigned player = __builtin_ctz(players);
+                winners |= static_cast<uint32_t>(values[player] == bestValue) << player;
+            }
+
+            pots.winners[pot] = winners;
+        }
+    }
+
+#if defined(__x86_64__) || defined(__i386__)
+    __attribute__((target("avx2")))
+    static void findWinnersAvx2(const uint32_t* values, Pots& pots) noexcept
+    {
+        const __m256i laneBits = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+        __m256i lowValues = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values));
+        __m256i highValues = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + 8));
+
+        for (unsigned pot = 0; pot < pots.count; pot++) {
+            uint32_t eligiblePlayers = pots.eligiblePlayers[pot];
+            __m256i lowEligible = _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_set1_epi32(eligiblePlayers), laneBits), laneBits);
+            __m256i highEligible = _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_set1_epi32(eligiblePlayers >> 8), laneBits), laneBits);
+
+            // Values are never 0, so values of not eligible players are masked by 0
+            __m256i bestValue = _mm256_max_epu32(_mm256_and_si256(lowValues, lowEligible), _mm256_and_si256(highValues, highEligible));
+            bestValue = _mm256_max_epu32(bestValue, _mm256_permute2x128_si256(bestValue, bestValue, 1));
+            bestValue = _mm256_max_epu32(bestValue, _mm256_shuffle_epi32(bestValue, _MM_SHUFFLE(1, 0, 3, 2)));
+            bestValue = _mm256_max_epu32(bestValue, _mm256_shuffle_epi32(bestValue, _MM_SHUFFLE(2, 3, 0, 1)));
+
+            uint32_t lowWinners = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(lowValues, bestValue)));
+            uint32_t highWinners = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(highValues, bestValue)));
+            pots.winners[pot] = (lowWinners | (highWinners << 8)) & eligiblePlayers;
+        }
+    }
+
+    __attribute__((target("avx512f")))
+    static void findWinnersAvx512(const uint32_t* values, Pots& pots) noexcept
+    {
+        __m512i allValues = _mm512_loadu_si512(values);
+
+        for (unsigned pot = 0; pot < pots.count; pot++) {
+            __mmask16 eligiblePlayers = static_cast<__mmask16>(pots.eligiblePlayers[pot]);
+            __m512i eligibleValues = _mm512_maskz_mov_epi32(eligiblePlayers, allValues);
+
+            // Zero masked extractions instead of casts that GCC warns about as uninitialized
+            __m256i bestValue = _mm256_max_epu32(_mm512_maskz_extracti64x4_epi64(0xF, eligibleValues, 0), _mm512_maskz_extracti64x4_epi64(0xF, eligibleValues, 1));
+            bestValue = _mm256_max_epu32(bestValue, _mm256_permute2x128_si256(bestValue, bestValue, 1));
+            bestValue = _mm256_max_epu32(bestValue, _mm256_shuffle_epi32(bestValue, _MM_SHUFFLE(1, 0, 3, 2)));
+            bestValue = _mm256_max_epu32(bestValue, _mm256_shuffle_epi32(bestValue, _MM_SHUFFLE(2, 3, 0, 1)));
+            pots.winners[pot] = _mm512_mask_cmpeq_epi32_mask(eligiblePlayers, allValues, _mm512_set1_epi32(_mm256_cvtsi256_si32(bestValue)));
+        }
+    }
+#endif
+
+    static unsigned getHighestCardIndex(Hand holeCards) noexcept
+    {
+        unsigned highestCardIndex = 0;
+
+        for (uint64_t cards = holeCards; cards != 0; cards &= cards - 1) {
+            unsigned bit = __builtin_ctzll(cards);
+            highestCardIndex = std::max(highestCardIndex, (bit % 16) * SuitsCount + bit / 16);
+        }
+
+        return highestCardIndex;
+    }
+
+    static void distributePots(const Pots& pots, const Hand* holeCards, unsigned playersCount, OddChipRule oddChipRule, uint64_t* payouts) noexcept
+    {
+        std::fill(payouts, payouts + playersCount, 0);
+
+        for (unsigned pot = 0; pot < pots.count; pot++) {
+            uint32_t winners = pots.winners[pot];
+
+            // Most pots have one winner and need no division
+            if ((winners & (winners - 1)) == 0) {
+                payouts[__builtin_ctz(winners)] += pots.amounts[pot];
+                continue;
+            }
+
+            unsigned winnersCount = __builtin_popcount(winners);
+            uint64_t share = pots.amounts[pot] / winnersCount;
+            unsigned oddChipsCount = static_cast<unsigned>(pots.amounts[pot] % winnersCount);
+
+            for (uint32_t players = winners; players != 0; players &= players - 1) {
+                payouts[__builtin_ctz(players)] += share;
+            }
+
+            // Odd chips are less than winners, so every winner gets at most one
+            for (uint32_t players = winners; oddChipsCount > 0; oddChipsCount--) {
+                unsigned player = __builtin_ctz(players);
+
+                if (oddChipRule == OddChipRule::HighestCard) {
+                    for (uint32_t others = players & (players - 1); others != 0; others &= others - 1) {
+                        unsigned other = __builtin_ctz(others);
+
+                        if (getHighestCardIndex(holeCards[other]) > getHighestCardIndex(holeCards[player])) {
+                            player = other;
+                        }
+                    }
+                }
+
+                payouts[player]++;
+                players &= ~(1u << player);
+            }
+        }
+    }
+
+    void resolveShowdown(Hand board, const Hand* holeCards, const uint64_t* contributions, unsigned playersCount, uint64_t* payouts, OddChipRule oddChipRule)
+    {
+        checkPlayersCount(playersCount);
+        checkDeal(board, holeCards, playersCount);
+
+        uint32_t values[PaddedValuesCount] = {};
+
+        for (unsigned i = 0; i < playersCount; i++) {
+            if (holeCards[i] != FoldedHoleCards) {
+                values[i] = evaluateHoldem7CardsHand(board | holeCards[i]);
+            }
+        }
+
+        Pots pots;
+        createPots(holeCards, contributions, playersCount, pots);
+        findWinnersScalar(values, pots);
+        distributePots(pots, holeCards, playersCount, oddChipRule, payouts);
+    }
+
+    void resolveShowdowns(const Hand* boards, const Hand* holeCards, const uint64_t* contributions, unsigned playersCount, size_t dealsCount,
+                          uint64_t* payouts, OddChipRule oddChipRule)
+    {
+        resolveShowdowns(boards, holeCards, contributions, playersCount, dealsCount, payouts, oddChipRule, getSupportedInstructionSet());
+    }
+
+    void resolveShowdowns(const Hand* boards, const Hand* holeCards, const uint64_t* contributions, unsigned playersCount, size_t dealsCount,
+                          uint64_t* payouts, OddChipRule oddChipRule, InstructionSet instructionSet)
+    {
+        checkPlayersCount(playersCount);
+
+        FindWinners findWinners = findWinnersScalar;
+
+        switch (instructionSet) {
+#if defined(__x86_64__) || defined(__i386__)
+            case InstructionSet::Avx512: findWinners = findWinnersAvx512; break;
+            case InstructionSet::Avx2:   findWinners = findWinnersAvx2; break;
+#endif
+            default: break;
+        }
+
+        // Every deal is checked before any payout is written, so invalid deal leaves payouts untouched
+        for (size_t deal = 0; deal < dealsCount; deal++) {
+            checkDeal(boards[deal], holeCards + deal * playersCount, playersCount);
+        }
+
+        // Hands of players that didn't fold are evaluated together, values of folded players stay 0
+        Hand hands[BatchDealsCount * MaxShowdownPlayersCount];
+        uint32_t handsValues[BatchDealsCount * MaxShowdownPlayersCount];
+        uint32_t values[BatchDealsCount * MaxShowdownPlayersCount + PaddedValuesCount];
+        Pots pots;
+
+        for (size_t firstDeal = 0; firstDeal < dealsCount; firstDeal += BatchDealsCount) {
+            size_t batchDealsCount = std::min<size_t>(BatchDealsCount, dealsCount - firstDeal);
+            const Hand* batchHoleCards = holeCards + firstDeal * playersCount;
+            size_t playersHandsCount = batchDealsCount * playersCount;
+            size_t handsCount = 0;
+
+            for (size_t deal = 0; deal < batchDealsCount; deal++) {
+                for (unsigned i = 0; i < playersCount; i++) {
+                    Hand playerHoleCards = batchHoleCards[deal * playersCount + i];
+
+                    if (playerHoleCards != FoldedHoleCards) {
+                        hands[handsCount++] = boards[firstDeal + deal] | playerHoleCards;
+                    }
+                }
+            }
+
+            evaluateHoldem7CardsHands(hands, handsValues, handsCount, instructionSet);
+
+            for (size_t i = 0, handIndex = 0; i < playersHandsCount; i++) {
+                values[i] = (batchHoleCards[i] != FoldedHoleCards) ? handsValues[handIndex++] : 0;
+            }
+
+            std::fill(values + playersHandsCount, values + playersHandsCount + PaddedValuesCount, 0);
+
+            for (size_t deal = 0; deal < batchDealsCount; deal++) {
+                size_t offset = (firstDeal + deal) * playersCount;
+                createPots(holeCards + offset, contributions + offset, playersCount, pots);
+                findWinners(values + deal * playersCount, pots);
+                distributePots(pots, holeCards + offset, playersCount, oddChipRule, payouts + offset);
+            }
+        }
+    }
+}
@@ -0,0 +1,296 @@
+/* pokertools - tools for poker related coding
+ * Copyright (C) 2016 Andriy Lysnevych
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+#include <pokertools-cpp/strength.hpp>
+#include <pokertools-cpp/evaluators.hpp>
+#include <pokertools-cpp/combinations.hpp>
+#include "parallel.hpp"
+
+#include <stdexcept>
+#include <algorithm>
+#include <unordered_map>
+
+namespace pokertools
+{
+    static constexpr unsigned BoardSize = 5;
+    static constexpr unsigned StrengthTaskRunoutsCount = 16;
+
+    // Outcomes of hero against opponent combination, half of outcome is hero share
+    static constexpr unsigned Behind = 0;
+    static constexpr unsigned Tied = 1;
+    static constexpr unsigned Ahead = 2;
+    static constexpr unsigned OutcomesCount = 3;
+
+    struct OpponentCombination {
+        Hand holeCards;
+        unsigned index; // getHoleCardsIndex of hole cards
+        double weight;
+        unsigned outcome; // Outcome of hero on current board
+    };
+
+    struct StrengthRunout {
+        Hand cards;
+        double weight; // Number of runouts equivalent under symmetries of hero, board and range
+    };
+
+    struct StrengthAccumulator {
+        double runoutsWeight;
+        double strengthSum;
+        double squaredStrengthSum;
+        double outcomesWeights[OutcomesCount][OutcomesCount]; // Opponent combinations by current and river outcomes
+        std::vector<double> histogram;
+    };
+
+    static inline unsigned getOutcome(uint32_t heroValue, uint32_t opponentValue) noexcept
+    {
+        return static_cast<unsigned>(heroValue >= opponentValue) + static_cast<unsigned>(heroValue > opponentValue);
+    }
+
+    static std::vector<OpponentCombination> createOpponentCombinations(Hand holeCards, Hand board, const std::vector<WeightedHoleCards>& range)
+    {
+        std::vector<OpponentCombination> combinations;
+        std::vector<bool> isAdded(HoleCardsCombinationsCount, false);
+        unsigned cardsCount = countCards(holeCards | board);
+        uint32_t heroValue = evaluateHoldemHand(holeCards | board, cardsCount);
+
+        for (const WeightedHoleCards& combination : range) {
+            if (countCards(combination.holeCards) != 2) {
+                throw std::invalid_argument("Range combination must have exactly 2 cards");
+            }
+
+            unsigned index = getHoleCardsIndex(combination.holeCards);
+
+            if (isAdded[index]) {
+                throw std::invalid_argument("Range combinations must not repeat");
+            }
+
+            isAdded[index] = true;
+
+            if ((combination.holeCards & (holeCards | board)) == 0) {
+                uint32_t opponentValue = evaluateHoldemHand(combination.holeCards | board, cardsCount);
+                combinations.push_back(OpponentCombination{ combination.holeCards, index, combination.weight, getOutcome(heroValue, opponentValue) });
+            }
+        }
+
+        return combinations;
+    }
+
+    // Runouts minimal in orbits of suit permutations that keep hole cards, board and weights of opponent combinations
+    static std::vector<StrengthRunout> createRunouts(Hand holeCards, Hand board, const std::vector<OpponentCombination>& opponents)
+    {
+        std::unordered_map<uint64_t, double> weights;
+
+        for (const OpponentCombination& opponent : opponents) {
+            weights.emplace(opponent.holeCards, opponent.weight);
+        }
+
+        std::vector<std::vector<Suit>> permutations;
+        Suit permutation[SuitsCount] = { Suit::Clubs, Suit::Diamonds, Suit::Hearts, Suit::Spades };
+
+        do {
+            bool isSymmetry = (permuteSuits(holeCards, permutation) == holeCards) && (permuteSuits(board, permutation) == board);
+
+            for (size_t i = 0; isSymmetry && (i < opponents.size()); i++) {
+                auto iterator = weights.find(permuteSuits(opponents[i].holeCards, permutation));
+                isSymmetry = (iterator != weights.end()) && (iterator->second == opponents[i].weight);
+            }
+
+            if (isSymmetry) {
+                permutations.emplace_back(permutation, permutation + SuitsCount);
+            }
+        } while (std::next_permutation(permutation, permutation + SuitsCount));
+
+        std::vector<StrengthRunout> runouts;
+
+        for (Hand runout : CardsCombinations(FullDeck ^ (holeCards | board), BoardSize - countCards(board))) {
+            unsigned stabilizerSize = 0;
+            bool isMinimal = true;
+
+            for (const std::vector<Suit>& suitPermutation : permutations) {
+                Hand permutedRunout = permuteSuits(runout, suitPermutation.data());
+                isMinimal = isMinimal && (permutedRunout >= runout);
+                stabilizerSize += (permutedRunout == runout);
+            }
+
+            if (isMinimal) {
+                runouts.push_back(StrengthRunout{ runout, static_cast<double>(permutations.size()) / stabilizerSize });
+            }
+        }
+
+        return runouts;
+    }
+
+    static void evaluateRunout(Hand holeCards, Hand fullBoard, double runoutWeight, const std::vector<OpponentCombination>& opponents,
+                               std::vector<uint32_t>& values, StrengthAccumulator& accumulator) noexcept
+    {
+        // Wide ranges take all values at once, narrow ones evaluate only their combinations
+        BoardContext context = createBoardContext(fullBoard);
+        bool isAllEvaluated = !values.empty();
+        uint32_t heroValue = evaluateWithBoard(context, holeCards);
+        double outcomesWeights[OutcomesCount][OutcomesCount] = {};
+        double totalWeight = 0;
+        double winWeight = 0;
+
+        if (isAllEvaluated) {
+            evaluateAllWithBoard(context, values.data());
+        }
+
+        for (const OpponentCombination& opponent : opponents) {
+            if ((opponent.holeCards & fullBoard) == 0) {
+                uint32_t opponentValue = isAllEvaluated ? values[opponent.index] : evaluateWithBoard(context, opponent.holeCards);
+                unsigned outcome = getOutcome(heroValue, opponentValue);
+
+                outcomesWeights[opponent.outcome][outcome] += opponent.weight;
+                totalWeight += opponent.weight;
+                winWeight += opponent.weight * outcome / 2;
+            }
+        }
+
+        if (totalWeight == 0) {
+            return;
+        }
+
+        double strength = winWeight / totalWeight;
+        unsigned binsCount = static_cast<unsigned>(accumulator.histogram.size());
+
+        accumulator.runoutsWeight += runoutWeight;
+        accumulator.strengthSum += runoutWeight * strength;
+        accumulator.squaredStrengthSum += runoutWeight * strength * strength;
+        accumulator.histogram[std::min(static_cast<unsigned>(strength * binsCount), binsCount - 1)] += runoutWeight;
+
+        for (unsigned current = 0; current < OutcomesCount; current++) {
+            for (unsigned river = 0; river < OutcomesCount; river++) {
+                accumulator.outcomesWeights[current][river] += runoutWeight * outcomesWeights[current][river];
+            }
+        }
+    }
+
+    HandStrengthResult calculateHandStrength(Hand holeCards, Hand board, unsigned binsCount, unsigned threadsCount)
+    {
+        std::vector<WeightedHoleCards> range;
+        range.reserve(HoleCardsCombinationsCount);
+
+        for (unsigned i = 0; i < HoleCardsCombinationsCount; i++) {
+            range.push_back(WeightedHoleCards{ getHoleCardsByIndex(i), 1.0 });
+        }
+
+        return calculateHandStrength(holeCards, board, range, binsCount, threadsCount);
+    }
+
+    HandStrengthResult calculateHandStrength(Hand holeCards, Hand board, const std::vector<WeightedHoleCards>& opponentRange, unsigned binsCount,
+                                             unsigned threadsCount)
+    {
+        if (countCards(holeCards) != 2) {
+            throw std::invalid_argument("Hero must have exactly 2 hole cards");
+        } else if ((countCards(board) < 3) || (countCards(board) > BoardSize)) {
+            throw std::invalid_argument("Board must have from 3 to 5 cards");
+        } else if ((holeCards & board) != 0) {
+            throw std::invalid_argument("Cards must not overlap");
+        } else if (binsCount == 0) {
+            throw std::invalid_argument("Number of bins must be positive");
+        }
+
+        std::vector<OpponentCombination> opponents = createOpponentCombinations(holeCards, board, opponentRange);
+        std::vector<StrengthRunout> runouts = createRunouts(holeCards, board, opponents);
+
+        HandStrengthResult result{};
+        double currentWinWeight = 0;
+        double currentTotalWeight = 0;
+
+        for (const OpponentCombination& opponent : opponents) {
+            currentWinWeight += opponent.weight * opponent.outcome / 2;
+            currentTotalWeight += opponent.weight;
+        }
+
+        result.handStrength = (currentTotalWeight > 0) ? currentWinWeight / currentTotalWeight : 0.0;
+
+        // Every task has own accumulator, so they are summed in the same order with any number of threads
+        size_t tasksCount = (runouts.size() + StrengthTaskRunoutsCount - 1) / StrengthTaskRunoutsCount;
+        std::vector<StrengthAccumulator> accumulators(tasksCount, StrengthAccumulator{});
+        threadsCount = resolveThreadsCount(threadsCount);
+        std::vector<std::vector<uint32_t>> threadsValues(threadsCount);
+
+        for (std::vector<uint32_t>& values : threadsValues) {
+            if (opponents.size() > HoleCardsCombinationsCount / 4) {
+                values.resize(HoleCardsCombinationsCount);
+            }
+        }
+
+        for (StrengthAccumulator& accumulator : accumulators) {
+            accumulator.histogram.assign(binsCount, 0.0);
+        }
+
+        parallelFor(threadsCount, tasksCount, [&] (size_t task, unsigned threadIndex) {
+            size_t end = std::min(runouts.size(), (task + 1) * StrengthTaskRunoutsCount);
+
+            for (size_t i = task * StrengthTaskRunoutsCount; i < end; i++) {
+                evaluateRunout(holeCards, board | runouts[i].cards, runouts[i].weight, opponents, threadsValues[threadIndex], accumulators[task]);
+            }
+        });
+
+        StrengthAccumulator total{};
+        total.histogram.assign(binsCount, 0.0);
+
+        for (const StrengthAccumulator& accumulator : accumulators) {
+            total.runoutsWeight += accumulator.runoutsWeight;
+            total.strengthSum += accumulator.strengthSum;
+            total.squaredStrengthSum += accumulator.squaredStrengthSum;
+
+            for (unsigned current = 0; current < OutcomesCount; current++) {
+                for (unsigned river = 0; river < OutcomesCount; river++) {
+                    total.outcomesWeights[current][river] += accumulator.outcomesWeights[current][river];
+                }
+            }
+
+            for (unsigned bin = 0; bin < binsCount; bin++) {
+                total.histogram[bin] += accumulator.histogram[bin];
+            }
+        }
+
+        result.histogram.assign(binsCount, 0.0);
+
+        if (total.runoutsWeight == 0) {
+            return result;
+        }
+
+        result.expectedHandStrength = total.strengthSum / total.runoutsWeight;
+        result.expectedHandStrengthSquared = total.squaredStrengthSum / total.runoutsWeight;
+
+        for (unsigned bin = 0; bin < binsCount; bin++) {
+            result.histogram[bin] = total.histogram[bin] / total.runoutsWeight;
+        }
+
+        // Potentials as defined by Billings et al.
+        const auto& weights = total.outcomesWeights;
+        double behindWeight = weights[Behind][Behind] + weights[Behind][Tied] + weights[Behind][Ahead];
+        double tiedWeight = weights[Tied][Behind] + weights[Tied][Tied] + weights[Tied][Ahead];
+        double aheadWeight = weights[Ahead][Behind] + weights[Ahead][Tied] + weights[Ahead][Ahead];
+        double positiveDenominator = behindWeight + tiedWeight / 2;
+        double negativeDenominator = aheadWeight + tiedWeight / 2;
+
+        if (positiveDenominator > 0) {
+            result.positivePotential = (weights[Behind][Ahead] + weights[Behind][Tied] / 2 + weights[Tied][Ahead] / 2) / positiveDenominator;
+        }
+
+        if (negativeDenominator > 0) {
+            result.negativePotential = (weights[Ahead][Behind] + weights[Ahead][Tied] / 2 + weights[Tied][Behind] / 2) / negativeDenominator;
+        }
+
+        return result;
+    }
+}
@@ -0,0 +1,55 @@
+/* pokertools - tools for poker related coding
+ * Copyright (C) 2016 Andriy Lysnevych
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+#include "tables.hpp"
+
+namespace pokertools
+{
+    namespace tables
+    {
+        constexpr Table<uint8_t, BitsArraySize> numberOfBits = makeNumberOfBits();
+        constexpr Table16<BitsArraySize> rankOfStraights = makeRankOfStraights();
+        constexpr Table16<BitsArraySize> highUpTo5Bits = makeHighUpToNBits<BitsArraySize>(5);
+        constexpr Table16<BitsArraySize> highBit = makeHighBit();
+        constexpr Table16<HigUpTo3BitsArraySize> highUpTo3Bits = makeHighUpToNBits<HigUpTo3BitsArraySize>(3);
+        constexpr Table16<BitsArraySize> shortDeckRankOfStraights = makeShortDeckRankOfStraights();
+        constexpr Table16<BitsArraySize> deuceToSevenRankOfStraights = makeDeuceToSevenRankOfStraights();
+        constexpr Table16<BitsArraySize> reversedRanks = makeReversedRanks();
+        constexpr Table<uint16_t, BitsArraySize> packedRanks = makePackedRanks();
+        constexpr Table<uint16_t, BitsArraySize> ranksIndexes = makeRanksIndexes();
+        constexpr Table<uint32_t, HandValuesCount> ordinalValues = makeOrdinalValues();
+
+        static_assert(numberOfBits[0b1111111000000] == 7, "Invalid numberOfBits table");
+        static_assert(rankOfStraights[0b1000000001111] == 0b1000, "Invalid rankOfStraights table");
+        static_assert(rankOfStraights[0b1111100000000] == 0b1000000000000, "Invalid rankOfStraights table");
+        static_assert(highUpTo5Bits[0b1111111000000] == 0b1111100000000, "Invalid highUpTo5Bits table");
+        static_assert(highBit[0b0000101000000] == 0b0000100000000, "Invalid highBit table");
+        static_assert(highUpTo3Bits[0b1010100000001] == 0b1010100000000, "Invalid highUpTo3Bits table");
+        static_assert(shortDeckRankOfStraights[0b1000011110000] == 0b0000010000000, "Invalid shortDeckRankOfStraights table");
+        static_assert(shortDeckRankOfStraights[0b1000111110000] == 0b0000100000000, "Invalid shortDeckRankOfStraights table");
+        static_assert(deuceToSevenRankOfStraights[0b1000000001111] == 0, "Invalid deuceToSevenRankOfStraights table");
+        static_assert(deuceToSevenRankOfStraights[0b1000000011111] == 0b10000, "Invalid deuceToSevenRankOfStraights table");
+        static_assert(reversedRanks[0b1100000000010] == 0b0100000000011, "Invalid reversedRanks table");
+        static_assert(packedRanks[0b1111111000000] == (7 | (13 << 4) | (8 << 8) | (10 << 12)), "Invalid packedRanks table");
+        static_assert(packedRanks[0b1000000001111] == (5 | (4 << 4) | (0 << 8) | (2 << 12)), "Invalid packedRanks table");
+        static_assert(ranksIndexes[0b1111010000000] == 1276, "Invalid ranksIndexes table");
+        static_assert(ranksIndexes[0b1100000000000] == 77, "Invalid ranksIndexes table");
+        static_assert(ordinalValues[0] == calculateHighCardValue(0b0000000101111), "Invalid ordinalValues table");
+        static_assert(ordinalValues[HandValuesCount - 1] == calculateStraightFlushValue(1 << 12), "Invalid ordinalValues table");
+    }
+}
@@ -0,0 +1,339 @@
+/* pokertools - tools for poker related coding
+ * Copyright (C) 2016 Andriy Lysnevych
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+/**
+ * Lookup tables used by evaluators. All tables are indexed by 13-bit ranks mask
+ * and generated at compile time, so they live in read-only memory shared by
+ * all processes using the library and need no initialization.
+ */
+
+#pragma once
+
+#include <pokertools-cpp/evaluators.hpp>
+#include "values.hpp"
+
+namespace pokertools
+{
+    namespace tables
+    {
+        template<typename T, unsigned Size>
+        struct Table {
+            static constexpr unsigned size = Size;
+
+            T values[Size];
+
+            inline constexpr const T& operator[](unsigned index) const noexcept
+            {
+                return values[index];
+            }
+        };
+
+        // 16-bit tables have one extra zero entry so SIMD evaluators can gather them by 32 bits
+        template<unsigned Size>
+        using Table16 = Table<uint16_t, Size + GatherPaddingSize / sizeof(uint16_t)>;
+
+        inline constexpr uint16_t getRankOfStraight(uint16_t ranks) noexcept
+        {
+            uint16_t straightMask = 0b1111100000000;
+
+            for (int i = 8; i >= 0; i--) {
+                if ((ranks & straightMask) == straightMask) {
+                    return 1 << (i + 4);
+                }
+                straightMask >>= 1;
+            }
+
+            const uint16_t fiveHighStraightMask = 0b1000000001111;
+
+            return ((ranks & fiveHighStraightMask) == fiveHighStraightMask) ? (1 << 3) : 0;
+        }
+
+        // Short Deck has no cards of ranks 2 to 5 and A-6-7-8-9 is the lowest straight
+        inline constexpr uint16_t getShortDeckRankOfStraight(uint16_t ranks) noexcept
+        {
+            const uint16_t nineHighStraightMask = 0b1000011110000;
+            uint16_t rank = getRankOfStraight(ranks);
+
+            return ((rank == 0) && ((ranks & nineHighStraightMask) == nineHighStraightMask)) ? (1 << 7) : rank;
+        }
+
+        inline constexpr Table<uint8_t, BitsArraySize> makeNumberOfBits() noexcept
+        {
+            Table<uint8_t, BitsArraySize> table{};
+
+            for (unsigned i = 1; i < BitsArraySize; i++) {
+                table.values[i] = table.values[i >> 1] + (i & 1);
+            }
+
+            return table;
+        }
+
+        inline constexpr Table16<BitsArraySize> makeRankOfStraights() noexcept
+        {
+            Table16<BitsArraySize> table{};
+
+            for (unsigned i = 0; i < BitsArraySize; i++) {
+                table.values[i] = getRankOfStraight(i);
+            }
+
+            return table;
+        }
+
+        inline constexpr Table16<BitsArraySize> makeShortDeckRankOfStraights() noexcept
+        {
+            Table16<BitsArraySize> table{};
+
+            for (unsigned i = 0; i < BitsArraySize; i++) {
+                table.values[i] = getShortDeckRankOfStraight(i);
+            }
+
+            return table;
+        }
+
+        inline constexpr Table16<BitsArraySize> makeHighBit() noexcept
+        {
+            Table16<BitsArraySize> table{};
+
+            for (unsigned i = 1; i < BitsArraySize; i++) {
+                table.values[i] = (i == 1) ? 1 : (table.values[i >> 1] << 1);
+            }
+
+            return table;
+        }
+
+        // Reverses order of 13 ranks bits, so lowest bits selection can be done by high bits tables
+        inline constexpr Table16<BitsArraySize> makeReversedRanks() noexcept
+        {
+            Table16<BitsArraySize> table{};
+
+            for (unsigned i = 0; i < BitsArraySize; i++) {
+                for (unsigned bit = 0; bit < RanksCount; bit++) {
+                    if (i & (1 << bit)) {
+                        table.values[i] |= 1 << (RanksCount - 1 - bit);
+                    }
+                }
+            }
+
+            return table;
+        }
+
+        // Ace to Five wheel is a high card hand in Deuce to Seven lowball
+        inline constexpr Table16<BitsArraySize> makeDeuceToSevenRankOfStraights() noexcept
+        {
+            Table16<BitsArraySize> table = makeRankOfStraights();
+
+            for (unsigned i = 0; i < BitsArraySize; i++) {
+                if (table.values[i] == (1 << 3)) {
+                    table.values[i] = 0;
+                }
+            }
+
+            return table;
+        }
+
+        // Clears lowest bits until at most maxBitsCount are left
+        template<unsigned Size>
+        inline constexpr Table16<Size> makeHighUpToNBits(unsigned maxBitsCount) noexcept
+        {
+            Table16<Size> table{};
+            Table<uint8_t, BitsArraySize> numberOfBits = makeNumberOfBits();
+
+            for (unsigned i = 1; i < Size; i++) {
+                table.values[i] = (numberOfBits[i] <= maxBitsCount) ? i : table.values[i & (i - 1)];
+            }
+
+            return table;
+        }
+
+        // Index of the lowest bit kept by highUpToNBits table, so kept bits are (ranks >> index) << index
+        inline constexpr unsigned getLowestOfHighBits(uint16_t ranks, unsigned maxBitsCount) noexcept
+        {
+            unsigned bitsCount = 0;
+            unsigned bit = RanksCount;
+
+            while ((bit > 0) && (bitsCount < maxBitsCount)) {
+                bit--;
+                bitsCount += (ranks >> bit) & 1;
+            }
+
+            return bit;
+        }
+
+        /**
+         * Fields of numberOfBits, rankOfStraights, highUpTo5Bits and highUpTo3Bits
+         * tables packed to 4 bits each, so one 16KB table fits L1 and a lookup
+         * gives all of them from one cache line:
+         *   bits 0-3   number of bits,
+         *   bits 4-7   index of straight rank bit + 1, 0 when there is no straight,
+         *   bits 8-11  lowest of up to 5 highest bits index,
+         *   bits 12-15 lowest of up to 3 highest bits index.
+         * High bit is not packed as bit scan instruction finds it without lookup.
+         */
+        inline constexpr Table<uint16_t, BitsArraySize> makePackedRanks() noexcept
+        {
+            Table<uint16_t, BitsArraySize> table{};
+            Table<uint8_t, BitsArraySize> numberOfBits = makeNumberOfBits();
+
+            for (unsigned i = 0; i < BitsArraySize; i++) {
+                uint16_t straightRank = getRankOfStraight(i);
+                unsigned straightField = 0;
+
+                while (straightRank != 0) {
+                    straightRank >>= 1;
+                    straightField++;
+                }
+
+                table.values[i] = numberOfBits[i] | (straightField << 4) | (getLowestOfHighBits(i, 5) << 8) | (getLowestOfHighBits(i, 3) << 12);
+            }
+
+            return table;
+        }
+
+        /**
+         * Index of ranks mask among masks with the same number of bits in
+         * increasing order, so within a hand type it's the dense index of
+         * kickers. Straights are skipped when 5 bits masks are indexed.
+         */
+        inline constexpr Table<uint16_t, BitsArraySize> makeRanksIndexes() noexcept
+        {
+            Table<uint16_t, BitsArraySize> table{};
+            Table<uint8_t, BitsArraySize> numberOfBits = makeNumberOfBits();
+            uint16_t counts[RanksCount + 1] = {};
+
+            for (unsigned i = 0; i < BitsArraySize; i++) {
+                table.values[i] = counts[numberOfBits[i]];
+
+                if ((numberOfBits[i] != 5) || (getRankOfStraight(i) == 0)) {
+                    counts[numberOfBits[i]]++;
+                }
+            }
+
+            return table;
+        }
+
+        // All distinct Hold'em values in increasing order, position of value is its ordinal
+        inline constexpr Table<uint32_t, HandValuesCount> makeOrdinalValues() noexcept
+        {
+            Table<uint32_t, HandValuesCount> table{};
+            Table<uint8_t, BitsArraySize> numberOfBits = makeNumberOfBits();
+            unsigned count = 0;
+
+            for (unsigned ranks = 0; ranks < BitsArraySize; ranks++) {
+                if ((numberOfBits[ranks] == 5) && (getRankOfStraight(ranks) == 0)) {
+                    table.values[count++] = calculateHighCardValue(ranks);
+                }
+            }
+
+            for (unsigned pair = 0; pair < RanksCount; pair++) {
+                for (unsigned kickers = 0; kickers < BitsArraySize; kickers++) {
+                    if ((numberOfBits[kickers] == 3) && ((kickers & (1 << pair)) == 0)) {
+                        table.values[count++] = calculatePairValue(1 << pair, kickers);
+                    }
+                }
+            }
+
+            for (unsigned pairs = 0; pairs < BitsArraySize; pairs++) {
+                for (unsigned kicker = 0; (numberOfBits[pairs] == 2) && (kicker < RanksCount); kicker++) {
+                    if ((pairs & (1 << kicker)) == 0) {
+                        table.values[count++] = calculateTwoPairValue(pairs, 1 << kicker);
+                    }
+                }
+            }
+
+            for (unsigned trips = 0; trips < RanksCount; trips++) {
+                for (unsigned kickers = 0; kickers < BitsArraySize; kickers++) {
+                    if ((numberOfBits[kickers] == 2) && ((kickers & (1 << trips)) == 0)) {
+                        table.values[count++] = calculateThreeOfAKindValue(1 << trips, kickers);
+                    }
+                }
+            }
+
+            for (unsigned high = 3; high < RanksCount; high++) {
+                table.values[count++] = calculateStraightValue(1 << high);
+            }
+
+            for (unsigned ranks = 0; ranks < BitsArraySize; ranks++) {
+                if ((numberOfBits[ranks] == 5) && (getRankOfStraight(ranks) == 0)) {
+                    table.values[count++] = calculateFlushValue(ranks);
+                }
+            }
+
+            for (unsigned trips = 0; trips < RanksCount; trips++) {
+                for (unsigned pair = 0; pair < RanksCount; pair++) {
+                    if (pair != trips) {
+                        table.values[count++] = calculateFullHouseValue(1 << trips, 1 << pair);
+                    }
+                }
+            }
+
+            for (unsigned quads = 0; quads < RanksCount; quads++) {
+                for (unsigned kicker = 0; kicker < RanksCount; kicker++) {
+                    if (kicker != quads) {
+                        table.values[count++] = calculateFourOfAKindValue(1 << quads, 1 << kicker);
+                    }
+                }
+            }
+
+            for (unsigned high = 3; high < RanksCount; high++) {
+                table.values[count++] = calculateStraightFlushValue(1 << high);
+            }
+
+            return table;
+        }
+
+        inline unsigned unpackNumberOfBits(uint16_t packedRanks) noexcept
+        {
+            return packedRanks & 0xF;
+        }
+
+        inline uint16_t unpackRankOfStraight(uint16_t packedRanks) noexcept
+        {
+            return (1 << ((packedRanks >> 4) & 0xF)) >> 1;
+        }
+
+        inline uint16_t unpackHighUpTo5Bits(uint16_t ranks, uint16_t packedRanks) noexcept
+        {
+            unsigned lowestBit = (packedRanks >> 8) & 0xF;
+            return (ranks >> lowestBit) << lowestBit;
+        }
+
+        inline uint16_t unpackHighUpTo3Bits(uint16_t ranks, uint16_t packedRanks) noexcept
+        {
+            unsigned lowestBit = packedRanks >> 12;
+            return (ranks >> lowestBit) << lowestBit;
+        }
+
+        // Same as highBit table, 0 for empty ranks
+        inline uint16_t getHighBit(uint16_t ranks) noexcept
+        {
+            return (0x80000000u >> __builtin_clz(ranks | 1)) & ranks;
+        }
+
+        extern const Table<uint8_t, BitsArraySize> numberOfBits;
+        extern const Table16<BitsArraySize> rankOfStraights;
+        extern const Table16<BitsArraySize> highUpTo5Bits;
+        extern const Table16<BitsArraySize> highBit;
+        extern const Table16<HigUpTo3BitsArraySize> highUpTo3Bits;
+        extern const Table16<BitsArraySize> shortDeckRankOfStraights;
+        extern const Table16<BitsArraySize> deuceToSevenRankOfStraights;
+        extern const Table16<BitsArraySize> reversedRanks;
+        extern const Table<uint16_t, BitsArraySize> packedRanks;
+        extern const Table<uint16_t, BitsArraySize> ranksIndexes;
+        extern const Table<uint32_t, HandValuesCount> ordinalValues;
+    }
+}
@@ -0,0 +1,90 @@
+/* pokertools - tools for poker related coding
+ * Copyright (C) 2016 Andriy Lysnevych
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+/**
+ * Encoding of evaluated hands to values, see EvaluateResult.
+ */
+
+#pragma once
+
+#include <pokertools-cpp/poker.hpp>
+
+namespace pokertools
+{
+    constexpr unsigned HandTypeInValueShift = 28;
+
+    inline constexpr uint32_t calculateStraightFlushValue(uint16_t highCardRank) noexcept
+    {
+        return (static_cast<uint32_t>(HandType::StraightFulsh) << HandTypeInValueShift) | highCardRank;
+    }
+
+    inline constexpr uint32_t calculateFourOfAKindValue(uint16_t quadsRank, uint16_t kickerRank) noexcept
+    {
+        return (static_cast<uint32_t>(HandType::FourOfAKind) << HandTypeInValueShift) | (static_cast<uint32_t>(quadsRank) << RanksCount) | kickerRank;
+    }
+
+    inline constexpr uint32_t calculateFullHouseValue(uint16_t tripsRank, uint16_t pairRank) noexcept
+    {
+        return (static_cast<uint32_t>(HandType::FullHouse) << HandTypeInValueShift) | (static_cast<uint32_t>(tripsRank) << RanksCount) | pairRank;
+    }
+
+    inline constexpr uint32_t calculateFlushValue(uint16_t fiveCardsRanks) noexcept
+    {
+        return (static_cast<uint32_t>(HandType::Flush) << HandTypeInValueShift) | fiveCardsRanks;
+    }
+
+    inline constexpr uint32_t calculateStraightValue(uint16_t highCardRank) noexcept
+    {
+        return (static_cast<uint32_t>(HandType::Straight) << HandTypeInValueShift) | highCardRank;
+    }
+
+    inline constexpr uint32_t calculateThreeOfAKindValue(uint16_t tripsRank, uint16_t twoKickersRanks) noexcept
+    {
+        return (static_cast<uint32_t>(HandType::ThreeOfAKind) << HandTypeInValueShift) | (static_cast<uint32_t>(tripsRank) << RanksCount) | twoKickersRanks;
+    }
+
+    inline constexpr uint32_t calculateTwoPairValue(uint16_t pairsRanks, uint16_t kickerRank) noexcept
+    {
+        return (static_cast<uint32_t>(HandType::TwoPair) << HandTypeInValueShift) | (static_cast<uint32_t>(pairsRanks) << RanksCount) | kickerRank;
+    }
+
+    inline constexpr uint32_t calculatePairValue(uint16_t pairRank, uint16_t threeKickersRanks) noexcept
+    {
+        return (static_cast<uint32_t>(HandType::Pair) << HandTypeInValueShift) | (static_cast<uint32_t>(pairRank) << RanksCount) | threeKickersRanks;
+    }
+
+    inline constexpr uint32_t calculateHighCardValue(uint16_t fiveCardsRanks) noexcept
+    {
+        return (static_cast<uint32_t>(HandType::HighCard) << HandTypeInValueShift) | fiveCardsRanks;
+    }
+
+    /**
+     * Converts value of Hold'em evaluator to Short Deck one where Flush beats Full House.
+     */
+    inline uint32_t toShortDeckValue(uint32_t value) noexcept
+    {
+        static_assert((static_cast<unsigned>(HandType::Flush) ^ static_cast<unsigned>(ShortDeckHandType::Flush)) ==
+                      (static_cast<unsigned>(HandType::FullHouse) ^ static_cast<unsigned>(ShortDeckHandType::FullHouse)), "Flush and Full House must swap");
+
+        uint32_t handType = value >> HandTypeInValueShift;
+        uint32_t swapMask = static_cast<unsigned>(HandType::Flush) ^ static_cast<unsigned>(ShortDeckHandType::Flush);
+        bool isFlushOrFullHouse = (handType == static_cast<unsigned>(HandType::Flush)) || (handType == static_cast<unsigned>(HandType::FullHouse));
+
+        return value ^ ((isFlushOrFullHouse ? swapMask : 0) << HandTypeInValueShift);
+    }
+}
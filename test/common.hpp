@@ -0,0 +1,96 @@
+/* pokertools - tools for poker related coding
+ * Copyright (C) 2016 Andriy Lysnevych
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+/**
+ * Helpers shared by tests.
+ */
+
+#pragma once
+
+#include <string>
+#include <fstream>
+#include <stdexcept>
+#include <cstdlib>
+#include <cstdio>
+
+#include <unistd.h>
+
+/**
+ * Empty file with unique name in temporary directory, so tests don't write to
+ * working directory. File is removed when test leaves its scope in any way.
+ */
+class TemporaryFile
+{
+public:
+    explicit TemporaryFile(const char* prefix)
+    {
+        const char* directory = std::getenv("TMPDIR");
+        name = std::string((directory && *directory) ? directory : "/tmp") + "/" + prefix + "-XXXXXX";
+        int fileDescriptor = mkstemp(&name[0]);
+
+        if (fileDescriptor != -1) {
+            close(fileDescriptor);
+        }
+    }
+
+    ~TemporaryFile()
+    {
+        std::remove(name.c_str());
+    }
+
+    TemporaryFile(const TemporaryFile&) = delete;
+    TemporaryFile& operator=(const TemporaryFile&) = delete;
+
+    const std::string& getName() const noexcept
+    {
+        return name;
+    }
+
+private:
+    std::string name;
+};
+
+// Inverts byte of payload behind header of data file, so only checksum can detect it
+inline void corruptPayload(const std::string& fileName, size_t headerSize)
+{
+    std::fstream file(fileName, std::ios::in | std::ios::out | std::ios::binary);
+    file.seekg(headerSize + 12345);
+    char byte = static_cast<char>(file.get());
+    file.seekp(headerSize + 12345);
+    file.put(static_cast<char>(~byte));
+}
+
+// Whether calling function throws Exception, other exceptions are propagated
+template<typename Exception, typename Function>
+bool throws(Function&& function)
+{
+    try {
+        function();
+    } catch (const Exception&) {
+        return true;
+    }
+
+    return false;
+}
+
+// Whether table memory mapping file rejects it
+template<typename Table>
+bool throwsRuntimeError(const std::string& fileName, bool verifyChecksum = true)
+{
+    return throws<std::runtime_error>([&] { Table table(fileName, verifyChecksum); });
+}
@@ -22,10 +22,19 @@
  */
 
 #include <pokertools-cpp/evaluators.hpp>
+#include <pokertools-cpp/hugepages.hpp>
+#include <pokertools-cpp/isomorphism.hpp>
+#include <pokertools-cpp/combinations.hpp>
+#include <pokertools-cpp/incremental.hpp>
+#include "common.hpp"
 
 #include <iostream>
 #include <random>
 #include <bitset>
+#include <vector>
+#include <algorithm>
+#include <thread>
+#include <cstdio>
 
 using namespace pokertools;
 
@@ -55,6 +64,14 @@ static Hand getRandomHand(unsigned cardsCount, Hand filter = 0) noexcept
     return hand;
 }
 
+static Hand getRandomShortDeckHand(unsigned cardsCount) noexcept
+{
+    // Cards of ranks 2 to 5 are not present in Short Deck
+    return getRandomHand(cardsCount, 0b0000000000001111000000000000111100000000000011110000000000001111);
+}
+
+static unsigned errorsCount = 0;
+
 void testCorrectness() noexcept
 {
     for (unsigned i = 0; i < 9999999; i++) {
@@ -62,19 +79,791 @@ void testCorrectness() noexcept
 
         if (evaluateHoldem7CardsHand(hand) != evaluateHoldemHand(hand, 7)) {
             std::cout << "ERROR evaluating hand " << std::bitset<64>(hand) << std::endl;
+            errorsCount++;
         }
 
         hand = getRandomHand(5);
 
         if (evaluateHoldem5CardsHand(hand) != evaluateHoldemHand(hand, 5)) {
             std::cout << "ERROR evaluating hand " << std::bitset<64>(hand) << std::endl;
+            errorsCount++;
+        }
+    }
+}
+
+// Best of 5 cards hands made by removing each card
+static uint32_t evaluateHoldem6CardsHandNaive(Hand hand) noexcept
+{
+    uint32_t value = 0;
+
+    for (uint64_t cards = hand; cards != 0; cards &= cards - 1) {
+        value = std::max(value, evaluateHoldem5CardsHand(hand & ~(cards & (~cards + 1))));
+    }
+
+    return value;
+}
+
+void test6CardsCorrectness() noexcept
+{
+    for (Hand hand : CardsCombinations(FullDeck, 6)) {
+        if (evaluateHoldem6CardsHand(hand) != evaluateHoldemHand(hand, 6)) {
+            std::cout << "ERROR evaluating 6 cards hand " << std::bitset<64>(hand) << std::endl;
+            errorsCount++;
+        }
+    }
+
+    for (unsigned i = 0; i < 999999; i++) {
+        Hand hand = getRandomHand(6);
+
+        if (evaluateHoldem6CardsHand(hand) != evaluateHoldem6CardsHandNaive(hand)) {
+            std::cout << "ERROR evaluating 6 cards hand " << std::bitset<64>(hand) << " by 5 cards hands" << std::endl;
+            errorsCount++;
+        }
+    }
+}
+
+void testEngineCorrectness() noexcept
+{
+    // Generic evaluator is always Branching engine
+    for (unsigned i = 0; i < 2999999; i++) {
+        Hand hand = getRandomHand(7);
+
+        if (evaluateHoldem7CardsHand(hand) != evaluateHoldemHand(hand, 7)) {
+            std::cout << "ERROR evaluating hand " << std::bitset<64>(hand) << " by engine " << static_cast<unsigned>(getEvaluatorEngine()) << std::endl;
+            errorsCount++;
+        }
+    }
+}
+
+void testBatchCorrectness() noexcept
+{
+    const unsigned handsCount = 999999; // Not multiple of SIMD width to test tail processing
+    std::vector<Hand> hands(handsCount);
+    std::vector<uint32_t> values(handsCount);
+
+    for (unsigned i = 0; i < handsCount; i++) {
+        hands[i] = getRandomHand(7);
+    }
+
+    for (unsigned instructionSet = 0; instructionSet <= static_cast<unsigned>(getSupportedInstructionSet()); instructionSet++) {
+        std::fill(values.begin(), values.end(), 0);
+        evaluateHoldem7CardsHands(hands.data(), values.data(), handsCount, static_cast<InstructionSet>(instructionSet));
+
+        for (unsigned i = 0; i < handsCount; i++) {
+            if (values[i] != evaluateHoldem7CardsHand(hands[i])) {
+                std::cout << "ERROR batch evaluating (instruction set " << instructionSet << ") hand " << std::bitset<64>(hands[i]) << std::endl;
+                errorsCount++;
+            }
+        }
+    }
+
+    for (unsigned i = 0; i < handsCount; i++) {
+        hands[i] = getRandomHand(6);
+    }
+
+    for (unsigned instructionSet = 0; instructionSet <= static_cast<unsigned>(getSupportedInstructionSet()); instructionSet++) {
+        std::fill(values.begin(), values.end(), 0);
+        evaluateHoldem6CardsHands(hands.data(), values.data(), handsCount, static_cast<InstructionSet>(instructionSet));
+
+        for (unsigned i = 0; i < handsCount; i++) {
+            if (values[i] != evaluateHoldem6CardsHand(hands[i])) {
+                std::cout << "ERROR batch evaluating (instruction set " << instructionSet << ") 6 cards hand " << std::bitset<64>(hands[i]) << std::endl;
+                errorsCount++;
+            }
         }
     }
 }
 
+// Reference Short Deck evaluation built from Hold'em evaluator
+static uint32_t evaluateShortDeck5CardsHandNaive(Hand hand) noexcept
+{
+    const uint16_t nineHighStraightRanks = 0b1000011110000;
+    EvaluateResult result;
+    result.value = evaluateHoldem5CardsHand(hand);
+
+    if ((hand.suit(Suit::Clubs) | hand.suit(Suit::Diamonds) | hand.suit(Suit::Hearts) | hand.suit(Suit::Spades)) == nineHighStraightRanks) {
+        bool isFlush = result.details.handType == static_cast<unsigned>(HandType::Flush);
+        result.value = static_cast<uint32_t>(isFlush ? ShortDeckHandType::StraightFulsh : ShortDeckHandType::Straight) << 28 | (1 << 7);
+    } else if (result.details.handType == static_cast<unsigned>(HandType::Flush)) {
+        result.details.handType = static_cast<unsigned>(ShortDeckHandType::Flush);
+    } else if (result.details.handType == static_cast<unsigned>(HandType::FullHouse)) {
+        result.details.handType = static_cast<unsigned>(ShortDeckHandType::FullHouse);
+    }
+
+    return result.value;
+}
+
+static uint32_t evaluateShortDeck7CardsHandNaive(Hand hand) noexcept
+{
+    std::vector<Card> cards;
+    uint32_t value = 0;
+
+    for (unsigned i = 0; i < CardsCount; i++) {
+        if ((hand | createCard(i)) == hand) {
+            cards.push_back(createCard(i));
+        }
+    }
+
+    // Best of all 5 cards combinations made by excluding 2 cards
+    for (unsigned i = 0; i < cards.size(); i++) {
+        for (unsigned j = i + 1; j < cards.size(); j++) {
+            value = std::max(value, evaluateShortDeck5CardsHandNaive(hand & ~(cards[i] | cards[j])));
+        }
+    }
+
+    return value;
+}
+
+void testShortDeckCorrectness() noexcept
+{
+    for (unsigned i = 0; i < 999999; i++) {
+        Hand hand = getRandomShortDeckHand(7);
+        uint32_t value = evaluateShortDeck7CardsHand(hand);
+
+        if (value != evaluateShortDeckHand(hand, 7) || value != evaluateShortDeck7CardsHandNaive(hand)) {
+            std::cout << "ERROR evaluating Short Deck hand " << std::bitset<64>(hand) << std::endl;
+            errorsCount++;
+        }
+
+        hand = getRandomShortDeckHand(5);
+        value = evaluateShortDeck5CardsHand(hand);
+
+        if (value != evaluateShortDeckHand(hand, 5) || value != evaluateShortDeck5CardsHandNaive(hand)) {
+            std::cout << "ERROR evaluating Short Deck hand " << std::bitset<64>(hand) << std::endl;
+            errorsCount++;
+        }
+    }
+}
+
+static std::vector<Card> splitToCards(Hand hand) noexcept
+{
+    std::vector<Card> cards;
+
+    for (unsigned i = 0; i < CardsCount; i++) {
+        if ((hand | createCard(i)) == hand) {
+            cards.push_back(createCard(i));
+        }
+    }
+
+    return cards;
+}
+
+// Ace low rank of card: Ace is 0, King is 12
+static unsigned getAceLowRank(Card card) noexcept
+{
+    unsigned rank = static_cast<unsigned>(std::bitset<64>(static_cast<uint64_t>(card) - 1).count()) % SuitSizeInBits;
+    return (rank + 1) % RanksCount;
+}
+
+// Reference key of Ace to Five low of 5 cards, lower key is better low
+static std::vector<unsigned> getAceToFiveLowKeyNaive(const std::vector<Card>& cards) noexcept
+{
+    unsigned counts[RanksCount] = {};
+
+    for (Card card : cards) {
+        counts[getAceLowRank(card)]++;
+    }
+
+    // Ranks grouped by count and ordered like in high hands comparison
+    std::vector<std::pair<unsigned, unsigned>> groups;
+
+    for (unsigned rank = 0; rank < RanksCount; rank++) {
+        if (counts[rank] != 0) {
+            groups.emplace_back(counts[rank], rank);
+        }
+    }
+
+    std::sort(groups.rbegin(), groups.rend());
+
+    unsigned handType;
+    if (groups[0].first == 4) {
+        handType = static_cast<unsigned>(HandType::FourOfAKind);
+    } else if (groups[0].first == 3) {
+        handType = static_cast<unsigned>((groups[1].first == 2) ? HandType::FullHouse : HandType::ThreeOfAKind);
+    } else if (groups[0].first == 2) {
+        handType = static_cast<unsigned>((groups[1].first == 2) ? HandType::TwoPair : HandType::Pair);
+    } else {
+        handType = static_cast<unsigned>(HandType::HighCard);
+    }
+
+    std::vector<unsigned> key = { handType };
+
+    for (auto& group : groups) {
+        key.push_back(group.second);
+    }
+
+    return key;
+}
+
+static std::vector<unsigned> getAceToFiveLowKeyNaive(Hand hand) noexcept
+{
+    std::vector<Card> cards = splitToCards(hand);
+    std::vector<unsigned> bestKey = { ~0u };
+
+    for (unsigned mask = 0; mask < (1u << cards.size()); mask++) {
+        if (std::bitset<32>(mask).count() != 5) {
+            continue;
+        }
+
+        std::vector<Card> subset;
+
+        for (unsigned i = 0; i < cards.size(); i++) {
+            if (mask & (1u << i)) {
+                subset.push_back(cards[i]);
+            }
+        }
+
+        bestKey = std::min(bestKey, getAceToFiveLowKeyNaive(subset));
+    }
+
+    return bestKey;
+}
+
+// Reference Deuce to Seven low as high value where Ace to Five isn't a straight, lower value is better low
+static uint32_t evaluateDeuceToSevenLowHandNaive(Hand hand) noexcept
+{
+    const uint16_t wheelRanks = 0b1000000001111;
+    EvaluateResult result;
+    result.value = evaluateHoldem5CardsHand(hand);
+
+    if ((hand.suit(Suit::Clubs) | hand.suit(Suit::Diamonds) | hand.suit(Suit::Hearts) | hand.suit(Suit::Spades)) == wheelRanks) {
+        bool isFlush = result.details.handType == static_cast<unsigned>(HandType::StraightFulsh);
+        result.value = static_cast<uint32_t>(isFlush ? HandType::Flush : HandType::HighCard) << 28 | wheelRanks;
+    }
+
+    return result.value;
+}
+
+static bool isEightOrBetterLowNaive(const std::vector<Card>& cards) noexcept
+{
+    unsigned ranks = 0;
+
+    for (Card card : cards) {
+        ranks |= 1 << getAceLowRank(card);
+    }
+
+    return std::bitset<32>(ranks & 0xFF).count() >= 5;
+}
+
+static uint32_t evaluateOmahaEightOrBetterLowHandNaive(Hand holeCards, Hand board) noexcept
+{
+    std::vector<Card> hole = splitToCards(holeCards), boardCards = splitToCards(board);
+    uint32_t value = 0;
+
+    for (unsigned h1 = 0; h1 < hole.size(); h1++) {
+        for (unsigned h2 = h1 + 1; h2 < hole.size(); h2++) {
+            for (unsigned b1 = 0; b1 < boardCards.size(); b1++) {
+                for (unsigned b2 = b1 + 1; b2 < boardCards.size(); b2++) {
+                    for (unsigned b3 = b2 + 1; b3 < boardCards.size(); b3++) {
+                        std::vector<Card> cards = { hole[h1], hole[h2], boardCards[b1], boardCards[b2], boardCards[b3] };
+
+                        if (isEightOrBetterLowNaive(cards)) {
+                            value = std::max(value, evaluateAceToFiveLowHand(hole[h1] | hole[h2] | boardCards[b1] | boardCards[b2] | boardCards[b3], 5));
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    return value;
+}
+
+template<typename T>
+static int compare(const T& first, const T& second) noexcept
+{
+    return (first < second) ? -1 : ((second < first) ? 1 : 0);
+}
+
+void testLowballCorrectness() noexcept
+{
+    for (unsigned i = 0; i < 29999; i++) {
+        unsigned cardsCount = 5 + i % 3;
+        Hand first = getRandomHand(cardsCount);
+        Hand second = getRandomHand(cardsCount);
+
+        // Better low has greater value and lower reference key
+        if (compare(evaluateAceToFiveLowHand(first, cardsCount), evaluateAceToFiveLowHand(second, cardsCount)) !=
+            compare(getAceToFiveLowKeyNaive(second), getAceToFiveLowKeyNaive(first))) {
+            std::cout << "ERROR evaluating Ace to Five low hands " << std::bitset<64>(first) << " " << std::bitset<64>(second) << std::endl;
+            errorsCount++;
+        }
+
+        uint32_t eightOrBetterValue = isEightOrBetterLowNaive(splitToCards(first)) ? evaluateAceToFiveLowHand(first, cardsCount) : 0;
+        HiLoValues hiLoValues = evaluateHiLoHand(first, cardsCount);
+
+        if ((evaluateEightOrBetterLowHand(first) != eightOrBetterValue) || (hiLoValues.low != eightOrBetterValue) ||
+            (hiLoValues.high != evaluateHoldemHand(first, cardsCount))) {
+            std::cout << "ERROR evaluating Eight or Better low hand " << std::bitset<64>(first) << std::endl;
+            errorsCount++;
+        }
+
+        first = getRandomHand(5);
+        second = getRandomHand(5);
+
+        if (compare(evaluateDeuceToSevenLowHand(first), evaluateDeuceToSevenLowHand(second)) !=
+            compare(evaluateDeuceToSevenLowHandNaive(second), evaluateDeuceToSevenLowHandNaive(first))) {
+            std::cout << "ERROR evaluating Deuce to Seven low hands " << std::bitset<64>(first) << " " << std::bitset<64>(second) << std::endl;
+            errorsCount++;
+        }
+
+        unsigned holeCardsCount = 4 + i % 3;
+        Hand holeCards = getRandomHand(holeCardsCount);
+        Hand board = getRandomHand(3 + i % 3, holeCards);
+        uint32_t omahaLowValue = evaluateOmahaEightOrBetterLowHand(holeCards, board, holeCardsCount);
+        HiLoValues omahaHiLoValues = evaluateOmahaHiLoHand(holeCards, board, holeCardsCount);
+
+        if ((omahaLowValue != evaluateOmahaEightOrBetterLowHandNaive(holeCards, board)) || (omahaHiLoValues.low != omahaLowValue) ||
+            (omahaHiLoValues.high != evaluateOmahaHand(holeCards, board, holeCardsCount))) {
+            std::cout << "ERROR evaluating Omaha Eight or Better low hand " << std::bitset<64>(holeCards) << " board " << std::bitset<64>(board) << std::endl;
+            errorsCount++;
+        }
+    }
+}
+
+void testBoardCorrectness() noexcept
+{
+    std::vector<uint32_t> values(HoleCardsCombinationsCount);
+
+    for (unsigned i = 0; i < 999; i++) {
+        Hand board = getRandomHand(5);
+        BoardContext context = createBoardContext(board);
+
+        evaluateAllWithBoard(context, values.data());
+
+        for (unsigned index = 0; index < HoleCardsCombinationsCount; index++) {
+            Hand holeCards = getHoleCardsByIndex(index);
+
+            if (getHoleCardsIndex(holeCards) != index) {
+                std::cout << "ERROR indexing hole cards " << std::bitset<64>(holeCards) << std::endl;
+                errorsCount++;
+            }
+
+            uint32_t expectedValue = ((holeCards & board) == 0) ? evaluateHoldem7CardsHand(holeCards | board) : 0;
+
+            if ((values[index] != expectedValue) || ((expectedValue != 0) && (evaluateWithBoard(context, holeCards) != expectedValue))) {
+                std::cout << "ERROR evaluating hole cards " << std::bitset<64>(holeCards) << " with board " << std::bitset<64>(board) << std::endl;
+                errorsCount++;
+            }
+        }
+    }
+}
+
+// Reference Omaha evaluation: best of all 2 hole cards and 3 board cards combinations
+static uint32_t evaluateOmahaHandNaive(Hand holeCards, Hand board) noexcept
+{
+    std::vector<Card> hole, boardCards;
+    uint32_t value = 0;
+
+    for (unsigned i = 0; i < CardsCount; i++) {
+        if ((holeCards | createCard(i)) == holeCards) {
+            hole.push_back(createCard(i));
+        } else if ((board | createCard(i)) == board) {
+            boardCards.push_back(createCard(i));
+        }
+    }
+
+    for (unsigned h1 = 0; h1 < hole.size(); h1++) {
+        for (unsigned h2 = h1 + 1; h2 < hole.size(); h2++) {
+            for (unsigned b1 = 0; b1 < boardCards.size(); b1++) {
+                for (unsigned b2 = b1 + 1; b2 < boardCards.size(); b2++) {
+                    for (unsigned b3 = b2 + 1; b3 < boardCards.size(); b3++) {
+                        value = std::max(value, evaluateHoldem5CardsHand(hole[h1] | hole[h2] | boardCards[b1] | boardCards[b2] | boardCards[b3]));
+                    }
+                }
+            }
+        }
+    }
+
+    return value;
+}
+
+void testOmahaCorrectness() noexcept
+{
+    for (unsigned i = 0; i < 2999; i++) {
+        for (unsigned holeCardsCount = 4; holeCardsCount <= 6; holeCardsCount++) {
+            for (unsigned boardCardsCount = 3; boardCardsCount <= 5; boardCardsCount++) {
+                Hand holeCards = getRandomHand(holeCardsCount);
+                Hand board = getRandomHand(boardCardsCount, holeCards);
+
+                if (evaluateOmahaHand(holeCards, board, holeCardsCount) != evaluateOmahaHandNaive(holeCards, board)) {
+                    std::cout << "ERROR evaluating Omaha hand " << std::bitset<64>(holeCards) << " board " << std::bitset<64>(board) << std::endl;
+                    errorsCount++;
+                }
+            }
+        }
+    }
+}
+
+void testEvaluatorCorrectness() noexcept
+{
+    const unsigned handsCount = 99999;
+    std::vector<Hand> hands(handsCount);
+    std::vector<uint32_t> expectedValues(handsCount);
+
+    for (unsigned i = 0; i < handsCount; i++) {
+        hands[i] = getRandomHand(7);
+        expectedValues[i] = evaluateHoldemHand(hands[i], 7);
+    }
+
+    // Evaluator of thread must not be affected by other evaluators created and destroyed meanwhile
+    Evaluator threadEvaluator(createInternalTablesBuffer());
+    threadEvaluator.initializeEngine(EvaluatorEngine::PerfectHash);
+    unsigned threadErrorsCount = 0;
+
+    std::thread thread([&] {
+        std::vector<uint32_t> values(handsCount);
+
+        for (unsigned pass = 0; pass < 10; pass++) {
+            threadEvaluator.evaluateHoldem7CardsHands(hands.data(), values.data(), handsCount);
+
+            for (unsigned i = 0; i < handsCount; i++) {
+                if ((threadEvaluator.evaluateHoldem7CardsHand(hands[i]) != expectedValues[i]) || (values[i] != expectedValues[i])) {
+                    threadErrorsCount++;
+                }
+            }
+        }
+    });
+
+    for (unsigned pass = 0; pass < 10; pass++) {
+        Evaluator evaluator(createInternalTablesBuffer());
+        evaluator.initializeEngine((pass % 2 == 0) ? EvaluatorEngine::PerfectHash : EvaluatorEngine::Branching);
+
+        Evaluator movedEvaluator(std::move(evaluator));
+
+        for (unsigned i = 0; i < handsCount; i += 7) {
+            if ((movedEvaluator.evaluateHoldem7CardsHand(hands[i]) != expectedValues[i]) || (evaluator.evaluateHoldem7CardsHand(hands[i]) != expectedValues[i])) {
+                std::cout << "ERROR evaluating hand " << std::bitset<64>(hands[i]) << " by Evaluator object" << std::endl;
+                errorsCount++;
+            }
+        }
+
+        pokertools::initializeEvaluator();
+        pokertools::deinitializeEvaluator();
+    }
+
+    thread.join();
+
+    if (threadErrorsCount != 0) {
+        std::cout << "ERROR evaluating " << threadErrorsCount << " hands by Evaluator object of other thread" << std::endl;
+        errorsCount += threadErrorsCount;
+    }
+}
+
+void testIsomorphismCorrectness() noexcept
+{
+    Suit permutations[SuitsPermutationsCount][SuitsCount];
+    Suit permutation[SuitsCount] = { Suit::Clubs, Suit::Diamonds, Suit::Hearts, Suit::Spades };
+
+    for (auto& suits : permutations) {
+        std::copy_n(permutation, SuitsCount, suits);
+        std::next_permutation(permutation, permutation + SuitsCount);
+    }
+
+    // Canonical form must be the same for all permutations and weight must be the number of different permuted situations
+    for (unsigned i = 0; i < 29999; i++) {
+        Hand holeCards = getRandomHand(2);
+        Hand board = getRandomHand(3 + i % 3, holeCards);
+        CanonicalForm canonicalForm = canonicalize(holeCards, board);
+        std::vector<std::pair<uint64_t, uint64_t>> permutedSituations;
+
+        if ((permuteSuits(holeCards, canonicalForm.permutation) != canonicalForm.holeCards) || (permuteSuits(board, canonicalForm.permutation) != canonicalForm.board)) {
+            std::cout << "ERROR permutation of canonical form of hole cards " << std::bitset<64>(holeCards) << " board " << std::bitset<64>(board) << std::endl;
+            errorsCount++;
+        }
+
+        for (const auto& suits : permutations) {
+            Hand permutedHoleCards = permuteSuits(holeCards, suits);
+            Hand permutedBoard = permuteSuits(board, suits);
+            CanonicalForm permutedCanonicalForm = canonicalize(permutedHoleCards, permutedBoard);
+            permutedSituations.emplace_back(permutedHoleCards, permutedBoard);
+
+            if ((permutedCanonicalForm.holeCards != canonicalForm.holeCards) || (permutedCanonicalForm.board != canonicalForm.board) ||
+                (getCanonicalSituationIndex(permutedHoleCards, permutedBoard) != getCanonicalSituationIndex(holeCards, board))) {
+                std::cout << "ERROR canonical form of hole cards " << std::bitset<64>(permutedHoleCards) << " board " << std::bitset<64>(permutedBoard) << std::endl;
+                errorsCount++;
+            }
+        }
+
+        std::sort(permutedSituations.begin(), permutedSituations.end());
+
+        if (std::unique(permutedSituations.begin(), permutedSituations.end()) - permutedSituations.begin() != canonicalForm.weight) {
+            std::cout << "ERROR weight of hole cards " << std::bitset<64>(holeCards) << " board " << std::bitset<64>(board) << std::endl;
+            errorsCount++;
+        }
+    }
+
+    // Canonical boards of every street cover all boards
+    const unsigned canonicalBoardsCounts[] = { CanonicalFlopsCount, CanonicalTurnsCount, CanonicalRiversCount };
+    const unsigned boardsCounts[] = { 22100, 270725, 2598960 };
+
+    for (unsigned cardsCount = 3; cardsCount <= 5; cardsCount++) {
+        unsigned boardsCount = 0;
+
+        for (unsigned i = 0; i < canonicalBoardsCounts[cardsCount - 3]; i++) {
+            Hand board = getCanonicalBoard(i, cardsCount);
+            boardsCount += canonicalize(board).weight;
+
+            if ((getCanonicalBoardIndex(board) != i) || (canonicalize(board).board != board)) {
+                std::cout << "ERROR canonical board " << std::bitset<64>(board) << std::endl;
+                errorsCount++;
+            }
+        }
+
+        if (boardsCount != boardsCounts[cardsCount - 3]) {
+            std::cout << "ERROR canonical boards of " << cardsCount << " cards cover " << boardsCount << " boards" << std::endl;
+            errorsCount++;
+        }
+    }
+}
+
+static constexpr uint64_t countCombinations(Hand liveCards, unsigned cardsCount) noexcept
+{
+    uint64_t count = 0;
+
+    for (Hand combination : CardsCombinations(liveCards, cardsCount)) {
+        count += (countCards(combination) == cardsCount) ? 1 : 0;
+    }
+
+    return count;
+}
+
+static_assert(CardsCombinations(FullDeck, 5).size() == 2598960, "number of boards");
+static_assert(countCombinations(0b111 | (0b11 << 16) | (0b1ull << 48), 3) == 20, "combinations enumerated at compile time");
+static_assert(CardsCombinations(FullDeck, 2).rank(ace_spades | king_spades) == HoleCardsCombinationsCount - 1, "rank at compile time");
+
+void testCombinationsCorrectness() noexcept
+{
+    for (unsigned cardsCount = 0; cardsCount <= 4; cardsCount++) {
+        Hand deadCards = getRandomHand(cardsCount * 3);
+        Hand liveCards = FullDeck & ~static_cast<uint64_t>(deadCards);
+        CardsCombinations combinations(liveCards, cardsCount);
+        std::vector<Hand> enumerated;
+
+        for (Hand combination : combinations) {
+            if ((countCards(combination) != cardsCount) || ((combination & deadCards) != 0) ||
+                (combinations.rank(combination) != enumerated.size()) || (combinations.unrank(enumerated.size()) != combination)) {
+                std::cout << "ERROR combination " << enumerated.size() << " of " << cardsCount << " cards " << std::bitset<64>(combination) << std::endl;
+                errorsCount++;
+            }
+
+            enumerated.push_back(combination);
+        }
+
+        if (enumerated.size() != getBinomial(CardsCount - countCards(deadCards), cardsCount)) {
+            std::cout << "ERROR number of combinations of " << cardsCount << " cards " << enumerated.size() << std::endl;
+            errorsCount++;
+        }
+
+        std::vector<Hand> sorted(enumerated);
+        std::sort(sorted.begin(), sorted.end(), [] (Hand first, Hand second) { return static_cast<uint64_t>(first) < second; });
+
+        if (std::unique(sorted.begin(), sorted.end()) != sorted.end()) {
+            std::cout << "ERROR repeated combinations of " << cardsCount << " cards" << std::endl;
+            errorsCount++;
+        }
+
+        // Parts and halves concatenated in order must be the whole range
+        for (unsigned partsCount : { 1, 3, 7, 1000 }) {
+            std::vector<Hand> concatenated;
+
+            for (unsigned i = 0; i < partsCount; i++) {
+                for (Hand combination : combinations.getPart(i, partsCount)) {
+                    concatenated.push_back(combination);
+                }
+            }
+
+            if (concatenated != enumerated) {
+                std::cout << "ERROR " << partsCount << " parts of combinations of " << cardsCount << " cards" << std::endl;
+                errorsCount++;
+            }
+        }
+
+        CardsCombinations firstHalf(combinations);
+        CardsCombinations secondHalf = firstHalf.split();
+        std::vector<Hand> concatenated(firstHalf.begin(), firstHalf.end());
+        concatenated.insert(concatenated.end(), secondHalf.begin(), secondHalf.end());
+
+        if ((concatenated != enumerated) || (firstHalf.size() + secondHalf.size() != combinations.size())) {
+            std::cout << "ERROR halves of combinations of " << cardsCount << " cards" << std::endl;
+            errorsCount++;
+        }
+    }
+
+    // Parts of range whose size multiplied by number of parts overflows 64 bits, the first size % partsCount parts are larger
+    CardsCombinations largeCombinations(FullDeck, 26);
+    const unsigned largePartsCount = 4000000000u;
+    uint64_t smallPartSize = largeCombinations.size() / largePartsCount;
+    unsigned largePartsCountWithExtra = static_cast<unsigned>(largeCombinations.size() % largePartsCount);
+
+    for (unsigned i : { 0u, 1u, largePartsCountWithExtra - 1, largePartsCountWithExtra, largePartsCount - 1 }) {
+        CardsCombinations part = largeCombinations.getPart(i, largePartsCount);
+        uint64_t previousEndRank = (i == 0) ? 0 : largeCombinations.getPart(i - 1, largePartsCount).getEndRank();
+
+        if ((part.getBeginRank() != previousEndRank) || (part.size() != smallPartSize + ((i < largePartsCountWithExtra) ? 1 : 0)) ||
+            ((i == largePartsCount - 1) && (part.getEndRank() != largeCombinations.size()))) {
+            std::cout << "ERROR part " << i << " of " << largePartsCount << " parts of combinations of 26 cards" << std::endl;
+            errorsCount++;
+        }
+    }
+
+    // Ranks over full deck match hole cards indexes
+    for (unsigned i = 0; i < HoleCardsCombinationsCount; i++) {
+        if (CardsCombinations(FullDeck, 2).rank(getHoleCardsByIndex(i)) != i) {
+            std::cout << "ERROR rank of hole cards " << i << std::endl;
+            errorsCount++;
+        }
+    }
+}
+
+void testOrdinalsCorrectness() noexcept
+{
+    for (unsigned ordinal = 0; ordinal < HandValuesCount; ordinal++) {
+        uint32_t value = convertOrdinalToValue(ordinal);
+
+        if ((convertValueToOrdinal(value) != ordinal) || ((ordinal > 0) && (convertOrdinalToValue(ordinal - 1) >= value))) {
+            std::cout << "ERROR value " << std::bitset<32>(value) << " of ordinal " << ordinal << std::endl;
+            errorsCount++;
+        }
+    }
+
+    // Every 5 cards hand value has ordinal and every ordinal is value of some hand
+    std::vector<bool> isOrdinalFound(HandValuesCount, false);
+
+    for (Hand hand : CardsCombinations(FullDeck, 5)) {
+        uint32_t value = evaluateHoldem5CardsHand(hand);
+        unsigned ordinal = convertValueToOrdinal(value);
+
+        if ((ordinal >= HandValuesCount) || (convertOrdinalToValue(ordinal) != value)) {
+            std::cout << "ERROR ordinal of hand " << std::bitset<64>(hand) << std::endl;
+            errorsCount++;
+        } else {
+            isOrdinalFound[ordinal] = true;
+        }
+    }
+
+    if (std::count(isOrdinalFound.begin(), isOrdinalFound.end(), true) != HandValuesCount) {
+        std::cout << "ERROR ordinals without 5 cards hands" << std::endl;
+        errorsCount++;
+    }
+
+    std::vector<uint32_t> values(9999);
+    std::vector<uint16_t> ordinals(values.size());
+
+    for (uint32_t& value : values) {
+        value = evaluateHoldem7CardsHand(getRandomHand(7));
+    }
+
+    convertValuesToOrdinals(values.data(), ordinals.data(), values.size());
+
+    for (size_t i = 0; i < values.size(); i++) {
+        if (ordinals[i] != convertValueToOrdinal(values[i])) {
+            std::cout << "ERROR batch ordinal of value " << std::bitset<32>(values[i]) << std::endl;
+            errorsCount++;
+        }
+    }
+}
+
+void testIncrementalCorrectness()
+{
+    TemporaryFile temporaryFile("test-incremental-evaluator");
+    const std::string& fileName = temporaryFile.getName();
+    writeIncrementalEvaluatorFile(fileName, generateIncrementalEvaluatorTable());
+
+    {
+        IncrementalEvaluator evaluator(fileName);
+
+        for (unsigned i = 0; i < 1000000; i++) {
+            unsigned cardsCount = 5 + i % 3;
+            Hand hand = getRandomHand(cardsCount);
+
+            if (evaluator.evaluateHand(hand, cardsCount) != evaluateHoldemHand(hand, cardsCount)) {
+                std::cout << "ERROR incremental evaluation of " << std::bitset<64>(hand) << std::endl;
+                errorsCount++;
+            }
+        }
+
+        // Seventh card gives value directly, sixth card gives state with value
+        for (unsigned i = 0; i < 1000; i++) {
+            Hand holeCards = getRandomHand(2);
+            Hand flop = getRandomHand(3, holeCards);
+            Hand turn = getRandomHand(1, holeCards | flop);
+            uint32_t flopState = evaluator.addCards(evaluator.addCards(IncrementalEvaluator::InitialState, holeCards), flop);
+            uint32_t turnState = evaluator.addCards(flopState, turn);
+
+            for (unsigned cardNumber = 0; cardNumber < CardsCount; cardNumber++) {
+                Hand river = createCard(cardNumber);
+
+                if ((river & (holeCards | flop | turn)) == 0) {
+                    if ((evaluator.addCard(turnState, cardNumber) != evaluateHoldem7CardsHand(holeCards | flop | turn | river))
+                        || (evaluator.getValue(evaluator.addCard(flopState, cardNumber)) != evaluateHoldem6CardsHand(holeCards | flop | river))) {
+                        std::cout << "ERROR incremental evaluation of river " << std::bitset<64>(holeCards | flop | turn | river) << std::endl;
+                        errorsCount++;
+                    }
+                }
+            }
+        }
+
+        IncrementalEvaluator movedEvaluator(std::move(evaluator));
+        Hand hand = ace_spades | king_spades | queen_spades | jack_spades | 10_spades | 2_hearts | 3_clubs;
+
+        if (movedEvaluator.evaluateHand(hand, 7) != evaluateHoldem7CardsHand(hand)) {
+            std::cout << "ERROR moved incremental evaluator" << std::endl;
+            errorsCount++;
+        }
+    }
+
+    // Corrupted transition is detected by checksum
+    corruptPayload(fileName, sizeof(IncrementalEvaluatorFileHeader));
+
+    if (!throwsRuntimeError<IncrementalEvaluator>(fileName)) {
+        std::cout << "ERROR corrupted incremental evaluator file" << std::endl;
+        errorsCount++;
+    }
+
+    std::remove(fileName.c_str());
+
+    if (!throwsRuntimeError<IncrementalEvaluator>(fileName)) {
+        std::cout << "ERROR missing incremental evaluator file" << std::endl;
+        errorsCount++;
+    }
+}
+
 int main()
 {
-    pokertools::initializeEvaluator();
     testCorrectness();
+    test6CardsCorrectness();
+    testBatchCorrectness();
+
+    // Same with tables copied to allocated buffer
+    pokertools::initializeEvaluator();
+    testBatchCorrectness();
+    pokertools::deinitializeEvaluator();
+
+    // Same with perfect hash engine
+    pokertools::initializeEvaluatorEngine(EvaluatorEngine::PerfectHash);
+    testEngineCorrectness();
+    testBatchCorrectness();
+    pokertools::deinitializeEvaluator();
+
+    // Same with packed tables engine, both builtin and copied to huge pages
+    pokertools::initializeEvaluatorEngine(EvaluatorEngine::Packed);
+    testEngineCorrectness();
+    pokertools::initializeEvaluator<HugePagesAllocator<uint8_t>>();
+    testEngineCorrectness();
+    testBatchCorrectness();
+    pokertools::deinitializeEvaluator();
+
+    testOmahaCorrectness();
+    testShortDeckCorrectness();
+    testLowballCorrectness();
+    testBoardCorrectness();
+    testEvaluatorCorrectness();
+    testIsomorphismCorrectness();
+    testCombinationsCorrectness();
+    testOrdinalsCorrectness();
+    testIncrementalCorrectness();
+
     std::cout << "Test END" << std::endl;
+    return errorsCount == 0 ? 0 : 1;
 }
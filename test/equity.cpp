@@ -0,0 +1,913 @@
+/* pokertools - tools for poker related coding
+ * Copyright (C) 2016 Andriy Lysnevych
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+/**
+ * Tests equity calculations by comparing them with straightforward nested
+ * loops over all deals.
+ */
+
+#include <pokertools-cpp/equity.hpp>
+#include <pokertools-cpp/evaluators.hpp>
+#include <pokertools-cpp/preflop.hpp>
+#include <pokertools-cpp/equitycache.hpp>
+#include <pokertools-cpp/showdown.hpp>
+#include <pokertools-cpp/strength.hpp>
+#include <pokertools-cpp/abstraction.hpp>
+#include <pokertools-cpp/isomorphism.hpp>
+#include <pokertools-cpp/river.hpp>
+#include <pokertools-cpp/combinations.hpp>
+#include "common.hpp"
+
+#include <iostream>
+#include <fstream>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+#include <algorithm>
+
+using namespace pokertools;
+
+static unsigned errorsCount = 0;
+
+static void check(bool condition, const char* description) noexcept
+{
+    if (!condition) {
+        std::cout << "ERROR " << description << std::endl;
+        errorsCount++;
+    }
+}
+
+static bool isEqual(double first, double second) noexcept
+{
+    return std::fabs(first - second) < 1e-9;
+}
+
+// Reference implementation: hero against one unknown opponent, board missing up to 2 cards
+static EquityResult enumerateEquityNaive(Hand heroHoleCards, Hand board) noexcept
+{
+    EquityResult result{};
+    double share = 0;
+    unsigned missingCardsCount = 5 - countCards(board);
+
+    for (unsigned first = 0; first < CardsCount; first++) {
+        for (unsigned second = first + 1; second < CardsCount; second++) {
+            Hand opponentHoleCards = createCard(first) | createCard(second);
+
+            if ((opponentHoleCards & (heroHoleCards | board)) != 0) {
+                continue;
+            }
+
+            for (unsigned turn = 0; turn < CardsCount; turn++) {
+                for (unsigned river = turn + 1; river < CardsCount; river++) {
+                    Hand runout = (missingCardsCount == 2) ? (createCard(turn) | createCard(river)) :
+                                  (missingCardsCount == 1) ? Hand(createCard(river)) : Hand(0);
+
+                    if (((runout & (heroHoleCards | board | opponentHoleCards)) != 0) ||
+                        ((missingCardsCount == 1) && (turn != 0)) || ((missingCardsCount == 0) && ((turn != 0) || (river != 1)))) {
+                        continue;
+                    }
+
+                    uint32_t heroValue = evaluateHoldem7CardsHand(heroHoleCards | board | runout);
+                    uint32_t opponentValue = evaluateHoldem7CardsHand(opponentHoleCards | board | runout);
+
+                    if (heroValue > opponentValue) {
+                        result.winCount++;
+                        share += 1;
+                    } else if (heroValue == opponentValue) {
+                        result.tieCount++;
+                        share += 0.5;
+                    } else {
+                        result.loseCount++;
+                    }
+                }
+            }
+        }
+    }
+
+    result.equity = share / (result.winCount + result.tieCount + result.loseCount);
+    return result;
+}
+
+void testEnumerateEquity()
+{
+    Hand opponents[MaxOpponentsCount] = { UnknownHoleCards, UnknownHoleCards, UnknownHoleCards };
+
+    Hand flops[] = { ace_spades | 8_clubs | 9_clubs, 2_hearts | 7_hearts | king_hearts, 10_diamonds | 10_clubs | 10_spades };
+    Hand holeCards[] = { 10_spades | 8_diamonds, ace_hearts | ace_diamonds, 4_hearts | 5_hearts };
+
+    for (Hand flop : flops) {
+        for (Hand heroHoleCards : holeCards) {
+            if ((flop & heroHoleCards) != 0) {
+                continue;
+            }
+
+            EquityResult result = enumerateEquity(heroHoleCards, opponents, 1, flop);
+            EquityResult expected = enumerateEquityNaive(heroHoleCards, flop);
+
+            check((result.winCount == expected.winCount) && (result.tieCount == expected.tieCount) && (result.loseCount == expected.loseCount),
+                  "unknown opponent counts on flop");
+            check(isEqual(result.equity, expected.equity), "unknown opponent equity on flop");
+        }
+    }
+
+    // Equities of two known players are complementary
+    Hand aces = ace_clubs | ace_diamonds;
+    Hand kings = king_hearts | king_spades;
+    EquityResult acesResult = enumerateEquity(aces, &kings, 1, 0);
+    EquityResult kingsResult = enumerateEquity(kings, &aces, 1, 0);
+
+    check(acesResult.winCount + acesResult.tieCount + acesResult.loseCount == 1712304, "preflop runouts count");
+    check(acesResult.winCount == kingsResult.loseCount, "preflop complementary counts");
+    check(isEqual(acesResult.equity + kingsResult.equity, 1.0), "preflop complementary equity");
+    check((acesResult.equity > 0.81) && (acesResult.equity < 0.83), "aces against kings equity");
+
+    // Same hands for all players always split equally
+    Hand board = ace_spades | king_clubs | queen_diamonds | jack_hearts | 10_spades;
+    Hand players[] = { 2_clubs | 3_clubs, 2_hearts | 3_hearts };
+    EquityResult splitResult = enumerateEquity(2_diamonds | 3_diamonds, players, 2, board);
+
+    check((splitResult.tieCount == 1) && isEqual(splitResult.equity, 1.0 / 3), "three way split on river");
+
+    // Several unknown opponents
+    opponents[0] = 2_spades | 7_diamonds;
+    EquityResult multiwayResult = enumerateEquity(aces, opponents, 3, flops[1] | 3_spades);
+    check(multiwayResult.winCount + multiwayResult.tieCount + multiwayResult.loseCount == 44ull * (43 * 42 / 2) * (41 * 40 / 2) / 2, "multiway deals count");
+    check((multiwayResult.equity > 0) && (multiwayResult.equity < 1), "multiway equity range");
+
+    check(throws<std::invalid_argument>([&] { enumerateEquity(aces, &aces, 1, 0); }), "overlapping cards are rejected");
+}
+
+void testSimulateEquity()
+{
+    Hand heroHoleCards = ace_hearts | king_hearts;
+    Hand board = queen_hearts | 7_clubs | 2_hearts;
+    Hand opponents[] = { UnknownHoleCards, 10_spades | 10_diamonds };
+
+    MonteCarloOptions options;
+    options.maxTrialsCount = 200000;
+    options.seed = 42;
+
+    // Result depends only on seed
+    options.threadsCount = 1;
+    MonteCarloEquityResult singleThreadResult = simulateEquity(heroHoleCards, opponents, 2, board, 0, options);
+    options.threadsCount = 3;
+    MonteCarloEquityResult multiThreadResult = simulateEquity(heroHoleCards, opponents, 2, board, 0, options);
+
+    check(singleThreadResult.trialsCount == options.maxTrialsCount, "simulation trials count");
+    check((singleThreadResult.winCount == multiThreadResult.winCount) && (singleThreadResult.tieCount == multiThreadResult.tieCount) &&
+          (singleThreadResult.equity == multiThreadResult.equity), "simulation is reproducible with different threads count");
+
+    EquityResult exactResult = enumerateEquity(heroHoleCards, opponents, 2, board);
+    check(std::fabs(singleThreadResult.equity - exactResult.equity) < 5 * singleThreadResult.standardError, "simulation matches exact equity");
+
+    options.seed = 43;
+    MonteCarloEquityResult otherSeedResult = simulateEquity(heroHoleCards, opponents, 2, board, 0, options);
+    check(otherSeedResult.winCount != singleThreadResult.winCount, "different seeds give different samples");
+
+    options.maxTrialsCount = 100000000;
+    options.targetStandardError = 0.005;
+    MonteCarloEquityResult earlyStopResult = simulateEquity(heroHoleCards, opponents, 2, board, 0, options);
+    check((earlyStopResult.standardError <= 0.005) && (earlyStopResult.trialsCount < options.maxTrialsCount), "simulation stops early");
+}
+
+// Reference implementation: every matchup and runout is evaluated separately
+static double calculateRangeEquityNaive(const std::vector<WeightedHoleCards>& heroRange, const std::vector<WeightedHoleCards>& villainRange, Hand board,
+                                        Hand deadCards = 0)
+{
+    double winWeight = 0, totalWeight = 0;
+
+    for (const WeightedHoleCards& hero : heroRange) {
+        for (const WeightedHoleCards& villain : villainRange) {
+            if (((hero.holeCards & villain.holeCards) != 0) || (((hero.holeCards | villain.holeCards) & (board | deadCards)) != 0)) {
+                continue;
+            }
+
+            Hand opponent = villain.holeCards;
+            EquityResult result = enumerateEquity(hero.holeCards, &opponent, 1, board, deadCards);
+            uint64_t count = result.winCount + result.tieCount + result.loseCount;
+
+            winWeight += hero.weight * villain.weight * result.equity * count;
+            totalWeight += hero.weight * villain.weight * count;
+        }
+    }
+
+    return winWeight / totalWeight;
+}
+
+static std::vector<WeightedHoleCards> createRange(bool (*filter)(Rank, Rank, bool), double weight)
+{
+    std::vector<WeightedHoleCards> range;
+
+    for (unsigned first = 0; first < CardsCount; first++) {
+        for (unsigned second = first + 1; second < CardsCount; second++) {
+            Rank firstRank = static_cast<Rank>(1 << (first % RanksCount));
+            Rank secondRank = static_cast<Rank>(1 << (second % RanksCount));
+
+            if (filter(firstRank, secondRank, first / RanksCount == second / RanksCount)) {
+                range.push_back(WeightedHoleCards{ createCard(first) | createCard(second), weight });
+            }
+        }
+    }
+
+    return range;
+}
+
+void testRangeEquity()
+{
+    // Ranges are symmetric to suit permutations, board leaves 3 suits interchangeable
+    std::vector<WeightedHoleCards> pairs = createRange([] (Rank first, Rank second, bool) { return (first == second) && (first >= Rank::R10); }, 1.0);
+    std::vector<WeightedHoleCards> broadways = createRange([] (Rank first, Rank second, bool) {
+        return (first != second) && (first >= Rank::Queen) && (second >= Rank::Queen);
+    }, 0.5);
+    Hand flop = 2_clubs | 7_clubs | king_clubs;
+
+    RangeEquityResult result = calculateRangeEquity(pairs, broadways, flop, 0, 2);
+    check(std::fabs(result.equity - calculateRangeEquityNaive(pairs, broadways, flop)) < 1e-9, "symmetric ranges equity");
+
+    // Asymmetric ranges with overlapping combinations
+    std::vector<WeightedHoleCards> heroRange = { { ace_spades | ace_hearts, 1.0 }, { king_hearts | queen_hearts, 0.3 }, { 9_diamonds | 8_diamonds, 0.7 } };
+    std::vector<WeightedHoleCards> villainRange = { { ace_spades | ace_hearts, 0.2 }, { ace_spades | 10_spades, 1.0 }, { jack_hearts | jack_diamonds, 0.6 },
+                                                    { 2_hearts | 2_diamonds, 1.0 } };
+    Hand turnBoard = flop | 10_hearts;
+
+    result = calculateRangeEquity(heroRange, villainRange, turnBoard);
+    check(std::fabs(result.equity - calculateRangeEquityNaive(heroRange, villainRange, turnBoard)) < 1e-9, "asymmetric ranges equity");
+
+    Hand aces = ace_spades | ace_hearts;
+    Hand villainHand = 2_hearts | 2_diamonds;
+    check(std::fabs(result.equities[0] - calculateRangeEquityNaive({ heroRange[0] }, villainRange, turnBoard)) < 1e-9, "single combination equity");
+    check(std::fabs(calculateRangeEquity({ { aces, 1.0 } }, { { villainHand, 1.0 } }, 0).equity - enumerateEquity(aces, &villainHand, 1, 0).equity) < 1e-9,
+          "preflop combination against combination");
+
+    // Dead card removes combinations of both ranges
+    Hand deadCards = ace_hearts | 9_clubs;
+    result = calculateRangeEquity(heroRange, villainRange, turnBoard, deadCards);
+    check(std::fabs(result.equity - calculateRangeEquityNaive(heroRange, villainRange, turnBoard, deadCards)) < 1e-9, "ranges equity with dead cards");
+    check(result.equities[0] == 0, "dead combination equity");
+    check(std::fabs(result.equities[1] - calculateRangeEquityNaive({ heroRange[1] }, villainRange, turnBoard, deadCards)) < 1e-9,
+          "combination equity with dead cards");
+
+    result = calculateRangeEquity(pairs, broadways, flop, ace_spades, 2);
+    check(std::fabs(result.equity - calculateRangeEquityNaive(pairs, broadways, flop, ace_spades)) < 1e-9, "symmetric ranges equity with dead card");
+}
+
+void testPreflopEquityTable()
+{
+    unsigned startingHandsCombinationsCounts[StartingHandsCount] = {};
+
+    for (unsigned i = 0; i < HoleCardsCombinationsCount; i++) {
+        startingHandsCombinationsCounts[getStartingHandIndex(getHoleCardsByIndex(i))]++;
+    }
+
+    check(startingHandsCombinationsCounts[getStartingHandIndex(ace_spades | ace_hearts)] == 6, "pairs combinations count");
+    check(startingHandsCombinationsCounts[getStartingHandIndex(ace_spades | king_spades)] == 4, "suited hands combinations count");
+    check(startingHandsCombinationsCounts[getStartingHandIndex(ace_spades | king_hearts)] == 12, "offsuit hands combinations count");
+    check(getStartingHandIndex(ace_spades | king_spades) != getStartingHandIndex(ace_spades | king_hearts), "suited and offsuit hands indexes");
+
+    // Classes of few matchups are enumerated, 3c3d against 2hAh has canonical hero 2cAc from villain hole cards
+    std::vector<std::pair<Hand, Hand>> matchups = { { ace_spades | ace_hearts, king_diamonds | king_clubs },
+                                                    { 3_clubs | 3_diamonds, 2_hearts | ace_hearts },
+                                                    { 8_spades | 7_spades, ace_clubs | king_diamonds } };
+    std::vector<uint32_t> matchupsShares = calculatePreflopEquityShares(0, matchups);
+    bool isValidShare = true;
+
+    for (const std::pair<Hand, Hand>& matchup : matchups) {
+        for (bool isReversed : { false, true }) {
+            Hand hero = isReversed ? matchup.second : matchup.first;
+            Hand villain = isReversed ? matchup.first : matchup.second;
+            EquityResult result = enumerateEquity(hero, &villain, 1, 0);
+
+            isValidShare = isValidShare && (matchupsShares[getHoleCardsIndex(hero) * HoleCardsCombinationsCount + getHoleCardsIndex(villain)]
+                                            == 2 * result.winCount + result.tieCount);
+        }
+    }
+
+    check(isValidShare, "preflop matchups shares");
+    check(matchupsShares[getHoleCardsIndex(2_clubs | 2_diamonds) * HoleCardsCombinationsCount + getHoleCardsIndex(ace_spades | king_spades)] == 0,
+          "preflop share of matchup not in subset");
+
+    // Whole table takes too long to generate in tests, so file format is checked with synthetic shares
+    std::vector<uint32_t> shares(HoleCardsCombinationsCount * HoleCardsCombinationsCount, 0);
+
+    for (unsigned hero = 0; hero < HoleCardsCombinationsCount; hero++) {
+        for (unsigned villain = hero + 1; villain < HoleCardsCombinationsCount; villain++) {
+            if ((getHoleCardsByIndex(hero) & getHoleCardsByIndex(villain)) == 0) {
+                uint32_t share = (hero * 7919 + villain * 104729) % (PreflopMaxShare + 1);
+                shares[hero * HoleCardsCombinationsCount + villain] = share;
+                shares[villain * HoleCardsCombinationsCount + hero] = PreflopMaxShare - share;
+            }
+        }
+    }
+
+    TemporaryFile temporaryFile("test-preflop-equity");
+    const std::string& fileName = temporaryFile.getName();
+    writePreflopEquityFile(fileName, shares);
+
+    {
+        PreflopEquityTable table(fileName);
+        Hand aces = ace_spades | ace_hearts;
+        Hand deuces = 2_hearts | 2_diamonds;
+        uint32_t share = shares[getHoleCardsIndex(aces) * HoleCardsCombinationsCount + getHoleCardsIndex(deuces)];
+
+        check(table.getShare(aces, deuces) == share, "preflop table share");
+        check(isEqual(table.getEquity(aces, deuces), static_cast<double>(share) / PreflopMaxShare), "preflop table equity");
+        check(isEqual(table.getEquity(aces, deuces) + table.getEquity(deuces, aces), 1), "preflop table symmetric equity");
+
+        // Kings against queens average equity of all 6 * 6 combinations
+        double kingsEquity = 0;
+        Hand kings[] = { king_clubs | king_diamonds, king_clubs | king_hearts, king_clubs | king_spades,
+                         king_diamonds | king_hearts, king_diamonds | king_spades, king_hearts | king_spades };
+        Hand queens[] = { queen_clubs | queen_diamonds, queen_clubs | queen_hearts, queen_clubs | queen_spades,
+                          queen_diamonds | queen_hearts, queen_diamonds | queen_spades, queen_hearts | queen_spades };
+
+        for (Hand heroKings : kings) {
+            for (Hand villainQueens : queens) {
+                kingsEquity += table.getEquity(heroKings, villainQueens) / 36;
+            }
+        }
+
+        check(isEqual(table.getStartingHandsEquity(getStartingHandIndex(kings[0]), getStartingHandIndex(queens[0])), kingsEquity), "starting hands equity");
+
+        PreflopEquityTable movedTable(std::move(table));
+        check(movedTable.getShare(aces, deuces) == share, "moved preflop table share");
+    }
+
+    // Corrupted payload is detected only by checksum
+    corruptPayload(fileName, sizeof(PreflopEquityFileHeader));
+    check(throwsRuntimeError<PreflopEquityTable>(fileName), "corrupted preflop equity file");
+    check(!throwsRuntimeError<PreflopEquityTable>(fileName, false), "corrupted preflop equity file without checksum verification");
+
+    std::remove(fileName.c_str());
+    check(throwsRuntimeError<PreflopEquityTable>(fileName), "missing preflop equity file");
+}
+
+static bool isSameResult(const EquityResult& first, const EquityResult& second) noexcept
+{
+    return (first.winCount == second.winCount) && (first.tieCount == second.tieCount) && (first.loseCount == second.loseCount) && (first.equity == second.equity);
+}
+
+static bool isStatistics(const EquityCache& cache, uint64_t memoryHits, uint64_t fileHits, uint64_t misses) noexcept
+{
+    EquityCacheStatistics statistics = cache.getStatistics();
+    return (statistics.memoryHits == memoryHits) && (statistics.fileHits == fileHits) && (statistics.misses == misses);
+}
+
+void testEquityCache()
+{
+    TemporaryFile temporaryFile("test-equity-cache");
+    const std::string& fileName = temporaryFile.getName();
+
+    Hand unknownOpponents[2] = { UnknownHoleCards, UnknownHoleCards };
+    Hand turn = queen_spades | jack_hearts | 2_diamonds | 3_clubs;
+    Hand isomorphicTurn = queen_hearts | jack_spades | 2_clubs | 3_diamonds;
+    EquityResult expected = enumerateEquity(ace_spades | king_spades, unknownOpponents, 1, turn);
+
+    {
+        EquityCache cache(16, fileName);
+
+        check(isSameResult(cache.getEquity(ace_spades | king_spades, 1, turn), expected), "equity cache miss result");
+        check(isSameResult(cache.getEquity(king_hearts | ace_hearts, 1, isomorphicTurn), expected), "equity cache isomorphic situation result");
+        check(isStatistics(cache, 1, 0, 1), "equity cache statistics after isomorphic query");
+
+        cache.getEquity(ace_spades | king_spades, 2, queen_spades | jack_hearts | 2_diamonds | 3_clubs | 4_hearts);
+        check(isStatistics(cache, 1, 0, 2), "equity cache keys differ by opponents count and board");
+    }
+
+    // Other instance (e.g. worker process) finds results in file
+    {
+        EquityCache cache(16, fileName);
+
+        check(isSameResult(cache.getEquity(ace_clubs | king_clubs, 1, queen_clubs | jack_diamonds | 2_hearts | 3_spades), expected), "equity cache file result");
+        check(isStatistics(cache, 0, 1, 0), "equity cache statistics of file hit");
+        check(isSameResult(cache.getEquity(ace_spades | king_spades, 1, turn), expected), "equity cache memory result after file hit");
+        check(isStatistics(cache, 1, 1, 0), "equity cache statistics of memory hit after file hit");
+    }
+
+    // Torn record of crashed writer is skipped and following records stay readable
+    {
+        std::ofstream file(fileName, std::ios::binary | std::ios::app);
+        file.write("torn", 4);
+    }
+
+    Hand flop = 7_spades | 8_spades | 9_hearts;
+
+    {
+        EquityCache cache(16, fileName);
+        check(isSameResult(cache.getEquity(ace_diamonds | ace_clubs, 1, flop), enumerateEquity(ace_diamonds | ace_clubs, unknownOpponents, 1, flop)),
+              "equity cache flop result");
+    }
+
+    {
+        EquityCache cache(16, fileName);
+        cache.getEquity(ace_diamonds | ace_clubs, 1, flop);
+        cache.getEquity(ace_spades | king_spades, 1, turn);
+        check(isStatistics(cache, 0, 2, 0), "equity cache records after torn record");
+    }
+
+    // Least recently used result is evicted from memory
+    {
+        EquityCache cache(2, std::string(), 1);
+        Hand river = turn | 4_hearts;
+
+        cache.getEquity(ace_spades | king_spades, 1, river);
+        cache.getEquity(ace_spades | queen_hearts, 1, river);
+        cache.getEquity(ace_spades | king_spades, 1, river);
+        cache.getEquity(ace_spades | 5_hearts, 1, river);
+        check(isStatistics(cache, 1, 0, 3), "equity cache statistics before eviction");
+        cache.getEquity(ace_spades | king_spades, 1, river);
+        cache.getEquity(ace_spades | queen_hearts, 1, river);
+        check(isStatistics(cache, 2, 0, 4), "equity cache evicts least recently used result");
+
+        check(throws<std::invalid_argument>([&] { cache.getEquity(ace_spades | king_spades, 1, queen_spades | jack_hearts); }), "equity cache preflop query");
+    }
+
+    {
+        std::ofstream file(fileName, std::ios::binary | std::ios::trunc);
+        file << "not an equity cache file";
+    }
+
+    check(throws<std::runtime_error>([&] { EquityCache cache(16, fileName); }), "invalid equity cache file");
+}
+
+static bool isPayouts(Hand board, const std::vector<Hand>& holeCards, const std::vector<uint64_t>& contributions,
+                      const std::vector<uint64_t>& expectedPayouts, OddChipRule oddChipRule = OddChipRule::PlayersOrder)
+{
+    std::vector<uint64_t> payouts(holeCards.size());
+    resolveShowdown(board, holeCards.data(), contributions.data(), static_cast<unsigned>(holeCards.size()), payouts.data(), oddChipRule);
+    return payouts == expectedPayouts;
+}
+
+static void resolveShowdownOfEqualContributions(Hand board, const std::vector<Hand>& holeCards)
+{
+    std::vector<uint64_t> contributions(holeCards.size(), 100);
+    std::vector<uint64_t> payouts(holeCards.size());
+    resolveShowdown(board, holeCards.data(), contributions.data(), static_cast<unsigned>(holeCards.size()), payouts.data());
+}
+
+void testShowdown()
+{
+    Hand board = 2_clubs | 7_diamonds | 9_hearts | jack_spades | king_clubs;
+    Hand kings = king_spades | king_hearts;
+    Hand aces = ace_spades | ace_hearts;
+    Hand queens = queen_spades | queen_hearts;
+
+    check(isPayouts(board, { kings, aces }, { 100, 100 }, { 200, 0 }), "showdown single pot");
+    check(isPayouts(board, { kings, aces, queens, FoldedHoleCards }, { 100, 300, 300, 50 }, { 350, 400, 0, 0 }), "showdown side pot");
+    check(isPayouts(board, { kings, aces, queens }, { 300, 100, 200 }, { 600, 0, 0 }), "showdown best hand takes all pots");
+    check(isPayouts(board, { aces, kings }, { 500, 200 }, { 300, 400 }), "showdown returns uncalled chips");
+    check(isPayouts(board, { aces, kings, FoldedHoleCards }, { 100, 100, 300 }, { 0, 500, 0 }), "showdown chips of folded player above live players");
+    check(isPayouts(board, { FoldedHoleCards, aces, kings }, { 0, 0, 0 }, { 0, 0, 0 }), "showdown without chips");
+
+    // Straight on board ties all players
+    Hand straightBoard = ace_clubs | king_diamonds | queen_hearts | jack_spades | 10_clubs;
+    std::vector<Hand> tiedHoleCards = { FoldedHoleCards, 7_spades | 2_hearts, 4_spades | 5_spades, 7_diamonds | 3_hearts };
+    std::vector<uint64_t> tiedContributions = { 2, 100, 100, 100 };
+
+    check(isPayouts(straightBoard, tiedHoleCards, tiedContributions, { 0, 101, 101, 100 }), "showdown odd chips in players order");
+    check(isPayouts(straightBoard, tiedHoleCards, tiedContributions, { 0, 101, 100, 101 }, OddChipRule::HighestCard), "showdown odd chips by highest card");
+    check(isPayouts(straightBoard, { 7_spades | 2_hearts, 4_spades | 5_spades }, { 51, 50 }, { 51, 50 }), "showdown split pot with uncalled chip");
+
+    check(throws<std::invalid_argument>([&] { resolveShowdownOfEqualContributions(board, { aces, ace_spades | 2_hearts }); }), "showdown overlapping cards");
+    check(throws<std::invalid_argument>([&] { resolveShowdownOfEqualContributions(board, { ace_spades, kings }); }), "showdown hole cards count");
+    check(throws<std::invalid_argument>([&] { resolveShowdownOfEqualContributions(2_clubs | 7_diamonds | 9_hearts | jack_spades, { aces, kings }); }),
+          "showdown board cards count");
+    check(throws<std::invalid_argument>([&] { resolveShowdownOfEqualContributions(board, { FoldedHoleCards, FoldedHoleCards }); }),
+          "showdown without live players");
+    check(throws<std::invalid_argument>([&] { resolveShowdownOfEqualContributions(board, std::vector<Hand>(MaxShowdownPlayersCount + 1, FoldedHoleCards)); }),
+          "showdown players count");
+
+    // Batches match single showdowns for every instruction set, amounts are few to make ties of contributions
+    const unsigned playersCount = MaxShowdownPlayersCount;
+    const size_t dealsCount = 1000;
+    std::mt19937 random(12345);
+    std::vector<Hand> boards(dealsCount);
+    std::vector<Hand> holeCards(dealsCount * playersCount);
+    std::vector<uint64_t> contributions(dealsCount * playersCount);
+    std::vector<uint64_t> expectedPayouts(dealsCount * playersCount);
+
+    for (size_t deal = 0; deal < dealsCount; deal++) {
+        std::vector<unsigned> deck(CardsCount);
+
+        for (unsigned i = 0; i < CardsCount; i++) {
+            deck[i] = i;
+        }
+
+        std::shuffle(deck.begin(), deck.end(), random);
+        boards[deal] = createCard(deck[0]) | createCard(deck[1]) | createCard(deck[2]) | createCard(deck[3]) | createCard(deck[4]);
+
+        for (unsigned i = 0; i < playersCount; i++) {
+            size_t index = deal * playersCount + i;
+            holeCards[index] = (random() % 4 == 0) ? FoldedHoleCards : (createCard(deck[5 + 2 * i]) | createCard(deck[6 + 2 * i]));
+            contributions[index] = random() % 4 * 25 + random() % 2;
+        }
+
+        if (holeCards[deal * playersCount] == FoldedHoleCards) {
+            holeCards[deal * playersCount] = createCard(deck[5]) | createCard(deck[6]);
+        }
+
+        OddChipRule oddChipRule = (deal % 2 == 0) ? OddChipRule::PlayersOrder : OddChipRule::HighestCard;
+        resolveShowdown(boards[deal], &holeCards[deal * playersCount], &contributions[deal * playersCount], playersCount,
+                        &expectedPayouts[deal * playersCount], oddChipRule);
+
+        uint64_t contributionsSum = 0;
+        uint64_t payoutsSum = 0;
+
+        for (unsigned i = 0; i < playersCount; i++) {
+            contributionsSum += contributions[deal * playersCount + i];
+            payoutsSum += expectedPayouts[deal * playersCount + i];
+        }
+
+        check(payoutsSum == contributionsSum, "showdown payouts sum");
+    }
+
+    for (unsigned instructionSet = 0; instructionSet <= static_cast<unsigned>(getSupportedInstructionSet()); instructionSet++) {
+        for (OddChipRule oddChipRule : { OddChipRule::PlayersOrder, OddChipRule::HighestCard }) {
+            std::vector<uint64_t> payouts(dealsCount * playersCount);
+            resolveShowdowns(boards.data(), holeCards.data(), contributions.data(), playersCount, dealsCount, payouts.data(), oddChipRule,
+                             static_cast<InstructionSet>(instructionSet));
+
+            for (size_t deal = static_cast<size_t>(oddChipRule); deal < dealsCount; deal += 2) {
+                check(std::equal(payouts.begin() + deal * playersCount, payouts.begin() + (deal + 1) * playersCount,
+                                 expectedPayouts.begin() + deal * playersCount), "batch showdown payouts");
+            }
+        }
+    }
+
+    // Invalid deal of the last batch leaves payouts of earlier batches untouched
+    std::vector<uint64_t> payouts(dealsCount * playersCount, UINT64_MAX);
+    holeCards[(dealsCount - 1) * playersCount] = boards[dealsCount - 1] & (boards[dealsCount - 1] - 1);
+    bool isThrown = throws<std::invalid_argument>([&] {
+        resolveShowdowns(boards.data(), holeCards.data(), contributions.data(), playersCount, dealsCount, payouts.data());
+    });
+
+    check(isThrown && std::all_of(payouts.begin(), payouts.end(), [] (uint64_t payout) { return payout == UINT64_MAX; }), "batch showdown invalid deal");
+}
+
+// Reference implementation: every runout and opponent combination evaluated from scratch
+static HandStrengthResult calculateHandStrengthNaive(Hand holeCards, Hand board, const std::vector<WeightedHoleCards>& range, unsigned binsCount)
+{
+    HandStrengthResult result{};
+    unsigned cardsCount = countCards(holeCards | board);
+    double currentWinWeight = 0, currentTotalWeight = 0, runoutsCount = 0;
+    double weights[3][3] = {}; // By current and river outcomes: behind, tied, ahead
+
+    result.histogram.assign(binsCount, 0.0);
+
+    for (const WeightedHoleCards& opponent : range) {
+        if ((opponent.holeCards & (holeCards | board)) == 0) {
+            uint32_t heroValue = evaluateHoldemHand(holeCards | board, cardsCount);
+            uint32_t opponentValue = evaluateHoldemHand(opponent.holeCards | board, cardsCount);
+            currentWinWeight += opponent.weight * ((heroValue > opponentValue) ? 1.0 : (heroValue == opponentValue) ? 0.5 : 0.0);
+            currentTotalWeight += opponent.weight;
+        }
+    }
+
+    for (Hand runout : CardsCombinations(FullDeck ^ (holeCards | board), 5 - countCards(board))) {
+        Hand fullBoard = board | runout;
+        double winWeight = 0, totalWeight = 0;
+
+        for (const WeightedHoleCards& opponent : range) {
+            if ((opponent.holeCards & (holeCards | fullBoard)) == 0) {
+                uint32_t heroValue = evaluateHoldem7CardsHand(holeCards | fullBoard);
+                uint32_t opponentValue = evaluateHoldem7CardsHand(opponent.holeCards | fullBoard);
+                uint32_t heroCurrentValue = evaluateHoldemHand(holeCards | board, cardsCount);
+                uint32_t opponentCurrentValue = evaluateHoldemHand(opponent.holeCards | board, cardsCount);
+                unsigned outcome = (heroValue > opponentValue) ? 2 : (heroValue == opponentValue) ? 1 : 0;
+                unsigned currentOutcome = (heroCurrentValue > opponentCurrentValue) ? 2 : (heroCurrentValue == opponentCurrentValue) ? 1 : 0;
+
+                weights[currentOutcome][outcome] += opponent.weight;
+                winWeight += opponent.weight * outcome / 2;
+                totalWeight += opponent.weight;
+            }
+        }
+
+        if (totalWeight > 0) {
+            double strength = winWeight / totalWeight;
+            runoutsCount++;
+            result.expectedHandStrength += strength;
+            result.expectedHandStrengthSquared += strength * strength;
+            result.histogram[std::min(static_cast<unsigned>(strength * binsCount), binsCount - 1)]++;
+        }
+    }
+
+    result.handStrength = currentWinWeight / currentTotalWeight;
+    result.expectedHandStrength /= runoutsCount;
+    result.expectedHandStrengthSquared /= runoutsCount;
+
+    for (double& share : result.histogram) {
+        share /= runoutsCount;
+    }
+
+    double behind = weights[0][0] + weights[0][1] + weights[0][2];
+    double tied = weights[1][0] + weights[1][1] + weights[1][2];
+    double ahead = weights[2][0] + weights[2][1] + weights[2][2];
+    result.positivePotential = (behind + tied > 0) ? (weights[0][2] + weights[0][1] / 2 + weights[1][2] / 2) / (behind + tied / 2) : 0.0;
+    result.negativePotential = (ahead + tied > 0) ? (weights[2][0] + weights[2][1] / 2 + weights[1][0] / 2) / (ahead + tied / 2) : 0.0;
+
+    return result;
+}
+
+static bool isSameStrength(const HandStrengthResult& first, const HandStrengthResult& second) noexcept
+{
+    bool isSameHistogram = first.histogram.size() == second.histogram.size();
+
+    for (size_t i = 0; isSameHistogram && (i < first.histogram.size()); i++) {
+        isSameHistogram = isEqual(first.histogram[i], second.histogram[i]);
+    }
+
+    return isSameHistogram && isEqual(first.handStrength, second.handStrength) && isEqual(first.expectedHandStrength, second.expectedHandStrength)
+           && isEqual(first.expectedHandStrengthSquared, second.expectedHandStrengthSquared)
+           && isEqual(first.positivePotential, second.positivePotential) && isEqual(first.negativePotential, second.negativePotential);
+}
+
+void testHandStrength()
+{
+    std::vector<WeightedHoleCards> uniformRange;
+
+    for (unsigned i = 0; i < HoleCardsCombinationsCount; i++) {
+        uniformRange.push_back(WeightedHoleCards{ getHoleCardsByIndex(i), 1.0 });
+    }
+
+    // Royal flush can't be beaten or improved
+    HandStrengthResult nuts = calculateHandStrength(jack_spades | 10_spades, ace_spades | king_spades | queen_spades | 2_hearts | 3_diamonds, 10);
+    check(isEqual(nuts.handStrength, 1) && isEqual(nuts.expectedHandStrength, 1) && isEqual(nuts.expectedHandStrengthSquared, 1), "nuts strength");
+    check(isEqual(nuts.histogram[9], 1) && isEqual(nuts.positivePotential, 0) && isEqual(nuts.negativePotential, 0), "nuts distribution");
+
+    // Drawing hand against uniform range on turn, expected strength is equity when every runout has the same opponent combinations
+    Hand drawHoleCards = 8_hearts | 9_hearts;
+    Hand turn = 10_hearts | jack_hearts | 2_clubs | king_spades;
+    HandStrengthResult draw = calculateHandStrength(drawHoleCards, turn, 20);
+    Hand unknownOpponent = UnknownHoleCards;
+
+    check(isSameStrength(draw, calculateHandStrengthNaive(drawHoleCards, turn, uniformRange, 20)), "turn strength against uniform range");
+    check(isEqual(draw.expectedHandStrength, enumerateEquity(drawHoleCards, &unknownOpponent, 1, turn).equity), "expected strength is equity");
+    check(draw.positivePotential > 0.3, "positive potential of draw");
+    check(draw.expectedHandStrengthSquared > draw.expectedHandStrength * draw.expectedHandStrength, "squared strength of draw");
+
+    // Flop with symmetric suits evaluates only some runouts
+    Hand pairHoleCards = 5_clubs | 5_diamonds;
+    Hand flop = 5_hearts | 9_spades | king_spades;
+    check(isSameStrength(calculateHandStrength(pairHoleCards, flop, 8, 2), calculateHandStrengthNaive(pairHoleCards, flop, uniformRange, 8)),
+          "flop strength against uniform range");
+
+    // Narrow weighted range that is partially blocked by runouts
+    std::vector<WeightedHoleCards> range = {
+        { ace_spades | ace_hearts, 1.0 }, { ace_clubs | ace_diamonds, 0.5 }, { king_hearts | king_clubs, 1.0 }, { queen_hearts | jack_hearts, 0.25 },
+        { 6_spades | 7_spades, 1.0 }, { 9_hearts | 9_clubs, 0.75 }, { 2_clubs | 3_clubs, 1.0 }
+    };
+    HandStrengthResult rangeStrength = calculateHandStrength(pairHoleCards, flop, range, 8, 1);
+
+    check(isSameStrength(rangeStrength, calculateHandStrengthNaive(pairHoleCards, flop, range, 8)), "flop strength against weighted range");
+    check(isSameStrength(rangeStrength, calculateHandStrength(pairHoleCards, flop, range, 8, 3)), "strength with other number of threads");
+
+    check(throws<std::invalid_argument>([&] { calculateHandStrength(pairHoleCards, flop & ~Hand(5_hearts), 8); }), "preflop strength");
+    check(throws<std::invalid_argument>([&] { calculateHandStrength(pairHoleCards, flop, 0); }), "strength without bins");
+}
+
+void testAbstraction()
+{
+    const unsigned binsCount = 10;
+    const std::vector<unsigned> boardIndexes = { 0, 1000 };
+    StrengthDistributions distributions = calculateStrengthDistributions(4, binsCount, 2, boardIndexes);
+    StrengthDistributions oneThreadDistributions = calculateStrengthDistributions(4, binsCount, 1, boardIndexes);
+    size_t situationsCount = distributions.weights.size();
+
+    check(distributions.runoutsCount == 46, "abstraction runouts count");
+    check((distributions.situationIndexes.size() == situationsCount) && (distributions.histograms.size() == situationsCount * binsCount),
+          "abstraction distributions sizes");
+    check((distributions.situationIndexes == oneThreadDistributions.situationIndexes) && (distributions.weights == oneThreadDistributions.weights)
+          && (distributions.histograms == oneThreadDistributions.histograms), "abstraction distributions don't depend on threads");
+
+    bool isValidHistogram = true;
+
+    for (size_t i = 0; i < situationsCount; i++) {
+        unsigned runoutsCount = 0;
+
+        for (unsigned bin = 0; bin < binsCount; bin++) {
+            runoutsCount += distributions.histograms[i * binsCount + bin];
+        }
+
+        isValidHistogram = isValidHistogram && (runoutsCount == distributions.runoutsCount);
+    }
+
+    check(isValidHistogram, "abstraction histograms sum to runouts count");
+
+    // Canonical situations of every board cover all hole cards of all isomorphic boards
+    for (unsigned boardIndex : boardIndexes) {
+        Hand board = getCanonicalBoard(boardIndex, 4);
+        uint64_t weight = 0;
+
+        for (size_t i = 0; i < situationsCount; i++) {
+            if (distributions.situationIndexes[i] / HoleCardsCombinationsCount == boardIndex) {
+                weight += distributions.weights[i];
+            }
+        }
+
+        check(weight == 1128ull * canonicalize(board).weight, "abstraction board weight");
+    }
+
+    // Histogram matches strength distribution against uniform range
+    size_t situation = situationsCount / 3;
+    Hand board = getCanonicalBoard(distributions.situationIndexes[situation] / HoleCardsCombinationsCount, 4);
+    Hand holeCards = getHoleCardsByIndex(distributions.situationIndexes[situation] % HoleCardsCombinationsCount);
+    HandStrengthResult strength = calculateHandStrength(holeCards, board, binsCount, 1);
+    bool isSameHistogram = true;
+
+    for (unsigned bin = 0; bin < binsCount; bin++) {
+        isSameHistogram = isSameHistogram && isEqual(strength.histogram[bin] * distributions.runoutsCount, distributions.histograms[situation * binsCount + bin]);
+    }
+
+    check(isSameHistogram, "abstraction histogram");
+
+    const unsigned bucketsCount = 3;
+    std::vector<uint16_t> buckets = clusterStrengthDistributions(distributions, bucketsCount, 50, 7, 2);
+    check(buckets == clusterStrengthDistributions(distributions, bucketsCount, 50, 7, 1), "abstraction buckets don't depend on threads");
+
+    bool isValidBucket = true, isSameBucket = true;
+    std::vector<bool> isUsed(bucketsCount, false);
+
+    for (size_t i = 0; i < situationsCount; i++) {
+        isValidBucket = isValidBucket && (buckets[i] < bucketsCount);
+        isUsed[std::min<unsigned>(buckets[i], bucketsCount - 1)] = true;
+
+        for (size_t j = 0; j < i; j++) {
+            if (std::equal(&distributions.histograms[i * binsCount], &distributions.histograms[(i + 1) * binsCount], &distributions.histograms[j * binsCount])) {
+                isSameBucket = isSameBucket && (buckets[i] == buckets[j]);
+            }
+        }
+    }
+
+    check(isValidBucket && isSameBucket, "abstraction buckets");
+    check(std::find(isUsed.begin(), isUsed.end(), false) == isUsed.end(), "abstraction buckets aren't empty");
+
+    TemporaryFile temporaryFile("test-abstraction");
+    const std::string& fileName = temporaryFile.getName();
+    writeAbstractionFile(fileName, distributions, buckets, bucketsCount);
+
+    {
+        AbstractionTable table(fileName);
+        const Suit permutation[SuitsCount] = { Suit::Hearts, Suit::Clubs, Suit::Spades, Suit::Diamonds };
+        bool isValidLookup = true;
+
+        for (size_t i = 0; i < situationsCount; i += 7) {
+            Hand canonicalBoard = getCanonicalBoard(distributions.situationIndexes[i] / HoleCardsCombinationsCount, 4);
+            Hand canonicalHoleCards = getHoleCardsByIndex(distributions.situationIndexes[i] % HoleCardsCombinationsCount);
+
+            isValidLookup = isValidLookup && (table.getBucket(canonicalHoleCards, canonicalBoard) == buckets[i])
+                            && (table.getBucket(permuteSuits(canonicalHoleCards, permutation), permuteSuits(canonicalBoard, permutation)) == buckets[i]);
+        }
+
+        check((table.getBoardCardsCount() == 4) && (table.getBucketsCount() == bucketsCount), "abstraction table header");
+        check(isValidLookup, "abstraction table buckets");
+        check(table.getBucket(ace_spades | ace_hearts, getCanonicalBoard(1, 4)) == NoBucket, "abstraction table board without buckets");
+
+        check(throws<std::invalid_argument>([&] { table.getBucket(ace_spades | ace_hearts, 2_clubs | 7_diamonds | 9_hearts); }), "abstraction table street");
+    }
+
+    corruptPayload(fileName, sizeof(AbstractionFileHeader));
+    check(throwsRuntimeError<AbstractionTable>(fileName), "corrupted abstraction file");
+
+    std::remove(fileName.c_str());
+    check(throwsRuntimeError<AbstractionTable>(fileName), "missing abstraction file");
+}
+
+void testRiverSolver()
+{
+    // Polarized range against bluff catcher: bettor bluffs half of air and caller calls half of time
+    RiverSubgame subgame;
+    subgame.board = 2_clubs | 5_diamonds | 9_hearts | jack_clubs | king_spades;
+    subgame.ranges[0] = { { 9_clubs | 9_diamonds, 1 }, { 4_hearts | 3_hearts, 1 } };
+    subgame.ranges[1] = { { jack_diamonds | 10_hearts, 1 } };
+    subgame.pot = 100;
+    subgame.stack = 1000;
+    subgame.betSizes = { 1 };
+    subgame.maxRaisesCount = 0;
+    subgame.allowAllIn = false;
+
+    {
+        RiverSolver solver(subgame);
+        RiverSolverResult result = solver.solve(1000);
+        unsigned root = solver.getRootNode();
+        const std::vector<RiverAction>& actions = solver.getActions(root);
+
+        check((actions.size() == 2) && (actions[0].type == RiverActionType::Check) && (actions[1].type == RiverActionType::Bet)
+              && (actions[1].amount == 100), "river root actions");
+        check((result.iterationsCount == 1000) && (solver.getIterationsCount() == 1000), "river iterations count");
+        check(isEqual(result.exploitability, solver.calculateExploitability()) && (result.exploitability >= 0) && (result.exploitability < 0.1),
+              "river toy game exploitability");
+        check((std::fabs(solver.calculateExpectedValue(0) - 75) < 0.1) && isEqual(solver.calculateExpectedValue(0) + solver.calculateExpectedValue(1), 100),
+              "river toy game value");
+        check(solver.getStrategy(root, 9_clubs | 9_diamonds)[1] > 0.99, "river value bet");
+        check(std::fabs(solver.getStrategy(root, 4_hearts | 3_hearts)[1] - 0.5) < 0.02, "river bluff frequency");
+        check(std::fabs(solver.getStrategy(solver.getChild(root, 1), jack_diamonds | 10_hearts)[1] - 0.5) < 0.02, "river call frequency");
+
+        check(throws<std::invalid_argument>([&] { solver.getStrategy(root, jack_diamonds | 10_hearts); }), "river strategy of hole cards not in range");
+    }
+
+    // Without bets value of checked down ranges is equity by pairwise comparisons
+    std::mt19937_64 random(3);
+    subgame.betSizes.clear();
+    subgame.ranges[0].clear();
+    subgame.ranges[1].clear();
+
+    for (unsigned i = 0; i < HoleCardsCombinationsCount; i++) {
+        Hand holeCards = getHoleCardsByIndex(i);
+
+        if (random() % 4 == 0) {
+            subgame.ranges[0].push_back({ holeCards, 1.0 + random() % 3 });
+        }
+
+        if (random() % 4 == 0) {
+            subgame.ranges[1].push_back({ holeCards, 1.0 + random() % 5 });
+        }
+    }
+
+    {
+        double winWeight = 0, totalWeight = 0;
+
+        for (const WeightedHoleCards& first : subgame.ranges[0]) {
+            for (const WeightedHoleCards& second : subgame.ranges[1]) {
+                if (((first.holeCards | second.holeCards) & subgame.board) == 0 && ((first.holeCards & second.holeCards) == 0)) {
+                    uint32_t firstValue = evaluateHoldem7CardsHand(first.holeCards | subgame.board);
+                    uint32_t secondValue = evaluateHoldem7CardsHand(second.holeCards | subgame.board);
+                    double outcome = (firstValue > secondValue) ? 1.0 : (firstValue == secondValue) ? 0.5 : 0.0;
+                    winWeight += first.weight * second.weight * outcome;
+                    totalWeight += first.weight * second.weight;
+                }
+            }
+        }
+
+        RiverSolver solver(subgame);
+        solver.solve(1);
+
+        check(solver.getNodesCount() == 3, "river check down tree");
+        check(std::fabs(solver.calculateExpectedValue(0) - subgame.pot * winWeight / totalWeight) < 1e-9, "river showdown sweep");
+        check(std::fabs(solver.calculateExploitability()) < 1e-9, "river check down exploitability");
+    }
+
+    // Bets are capped by stack and all-in isn't repeated
+    subgame.stack = 150;
+    subgame.betSizes = { 0.5, 2 };
+    subgame.raiseSizes = { 1 };
+    subgame.maxRaisesCount = 1;
+    subgame.allowAllIn = true;
+
+    {
+        RiverSolver solver(subgame);
+        const std::vector<RiverAction>& actions = solver.getActions(solver.getRootNode());
+        unsigned bet = solver.getChild(solver.getRootNode(), 1);
+        const std::vector<RiverAction>& responses = solver.getActions(bet);
+
+        check((actions.size() == 3) && (actions[1].amount == 50) && (actions[2].amount == 150), "river bets capped by stack");
+        check((solver.getPlayer(bet) == 1) && (responses.size() == 3) && (responses[0].type == RiverActionType::Fold)
+              && (responses[1].type == RiverActionType::Call) && (responses[2].type == RiverActionType::Raise) && (responses[2].amount == 150),
+              "river raise to all-in");
+
+        RiverSolverResult result = solver.solve(100000, 0.01 * subgame.pot);
+        check((result.exploitability <= 0.01 * subgame.pot) && (result.iterationsCount < 100000), "river target exploitability");
+
+        unsigned iterationsCount = result.iterationsCount;
+        result = solver.solve(100000, 0, 0.05);
+        check((result.iterationsCount - iterationsCount < 100000) && (result.seconds < 1), "river time budget");
+    }
+
+    subgame.board = 2_clubs | 5_diamonds | 9_hearts | jack_clubs;
+    check(throws<std::invalid_argument>([&] { RiverSolver solver(subgame); }), "river solver turn board");
+    subgame.board = 2_clubs | 5_diamonds | 9_hearts | jack_clubs | king_spades;
+    subgame.ranges[1].push_back(subgame.ranges[1].front());
+    check(throws<std::invalid_argument>([&] { RiverSolver solver(subgame); }), "river solver repeated hole cards");
+    subgame.ranges[1].pop_back();
+    subgame.ranges[1] = { { 2_clubs | 3_clubs, 1 } };
+    check(throws<std::invalid_argument>([&] { RiverSolver solver(subgame); }), "river solver range on board");
+}
+
+int main()
+{
+    testEnumerateEquity();
+    testSimulateEquity();
+    testRangeEquity();
+    testPreflopEquityTable();
+    testEquityCache();
+    testShowdown();
+    testHandStrength();
+    testAbstraction();
+    testRiverSolver();
+    std::cout << "Test END" << std::endl;
+    return errorsCount == 0 ? 0 : 1;
+}
@@ -17,120 +17,748 @@
  */
 
 /**
- * Test performance of different hand evaluator implementations.
+ * Benchmarks of hand evaluators. Workloads are generated from fixed seed,
+ * every benchmark is warmed up and repeated, and median and 99th percentile
+ * of time per hand are reported. Usage:
+ *
+ *   test-performance [--quick] [--filter TEXT] [--repetitions N] [--seed N] [--json FILE]
+ *
+ * --quick runs short benchmarks without working sets beyond LLC (used by ctest),
+ * --filter runs only benchmarks whose name contains TEXT,
+ * --json writes results to FILE in machine-readable format.
+ *
+ * When built with POKERTOOLS_PERF_COUNTERS and counters are allowed by kernel,
+ * cycles, instructions, branch misses, L1D and DTLB read misses per hand are reported too.
  */
 
 #include <pokertools-cpp/evaluators.hpp>
+#include <pokertools-cpp/perfcounters.hpp>
+#include <pokertools-cpp/hugepages.hpp>
+#include <pokertools-cpp/incremental.hpp>
+#include <pokertools-cpp/showdown.hpp>
 
 #include <iostream>
-#include <random>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
 #include <chrono>
 #include <vector>
-#include <bitset>
+#include <string>
+#include <functional>
+#include <memory>
 #include <algorithm>
-#include <fstream>
+#include <cstring>
+#include <cmath>
 
 using namespace pokertools;
 
-static std::mt19937 randomEngine(std::random_device{}());
+struct Options {
+    bool quick = false;
+    std::string filter;
+    unsigned repetitionsCount = 15;
+    uint64_t seed = 0x5EED;
+    std::string jsonFileName;
+};
+
+// SplitMix64 gives the same sequence on every platform unlike standard distributions
+class Random {
+public:
+    explicit Random(uint64_t seed) noexcept : state(seed) {}
+
+    uint64_t next() noexcept
+    {
+        uint64_t result = (state += 0x9E3779B97F4A7C15);
+        result = (result ^ (result >> 30)) * 0xBF58476D1CE4E5B9;
+        result = (result ^ (result >> 27)) * 0x94D049BB133111EB;
+        return result ^ (result >> 31);
+    }
+
+    unsigned below(unsigned bound) noexcept
+    {
+        return static_cast<unsigned>(((next() >> 32) * bound) >> 32);
+    }
+
+private:
+    uint64_t state;
+};
 
-static Card getRandomCard() noexcept
+// Keeps value alive without storing it to memory, so evaluations can't be hoisted or removed
+template<typename T>
+static inline void doNotOptimize(const T& value) noexcept
 {
-    static std::uniform_int_distribution<unsigned> cardsUniformDistribution(0, CardsCount - 1);
-    return createCard(cardsUniformDistribution(randomEngine));
+    asm volatile("" : : "r,m"(value));
 }
 
-static Hand getRandomHand(unsigned cardsCount, Hand filter = 0) noexcept
+// Cards of ranks 2 to 5 are not present in Short Deck
+static const Hand ShortDeckExcludedCards = 0b0000000000001111000000000000111100000000000011110000000000001111;
+
+static Hand getRandomHand(Random& random, unsigned cardsCount, Hand usedCards = 0) noexcept
 {
     Hand hand = 0;
 
     while (cardsCount) {
-        Card card;
-
-        do {
-            card = getRandomCard();
-        } while (((hand | card) == hand) | ((filter | card) == filter));
+        Card card = createCard(random.below(CardsCount));
 
-        hand |= card;
-        cardsCount--;
+        if (((hand | card) != hand) && ((usedCards | card) != usedCards)) {
+            hand |= card;
+            cardsCount--;
+        }
     }
 
     return hand;
 }
 
-void testPerformance() noexcept
+static HandType getHandType(Hand hand) noexcept
 {
-    std::cout << "Testing performance" << std::endl;
+    EvaluateResult result;
+    result.value = evaluateHoldemHand(hand, 7);
+    return static_cast<HandType>(result.details.handType);
+}
+
+// Rare hand types are built directly, others are sampled from natural distribution
+static Hand getRandomHand(Random& random, HandType handType) noexcept
+{
+    switch (handType) {
+        case HandType::StraightFulsh: {
+            unsigned suit = random.below(SuitsCount);
+            unsigned highRank = 3 + random.below(10);
+            Hand hand = 0;
+
+            for (unsigned i = 0; i < 5; i++) {
+                hand |= createCard(suit * RanksCount + (highRank + RanksCount - i) % RanksCount);
+            }
+
+            return hand | getRandomHand(random, 2, hand);
+        }
+
+        case HandType::FourOfAKind: {
+            unsigned rank = random.below(RanksCount);
+            Hand hand = 0;
+
+            for (unsigned suit = 0; suit < SuitsCount; suit++) {
+                hand |= createCard(suit * RanksCount + rank);
+            }
+
+            return hand | getRandomHand(random, 3, hand);
+        }
+
+        default:
+            for (;;) {
+                Hand hand = getRandomHand(random, 7);
+
+                if (getHandType(hand) == handType) {
+                    return hand;
+                }
+            }
+    }
+}
+
+enum class WorkloadKind {
+    Holdem7Cards,
+    Holdem5Cards,
+    ShortDeck7Cards,
+    ShortDeck5Cards,
+    Omaha,  // Pairs of 4 hole cards and 5 cards board
+    Boards, // 5 cards boards
+    Holdem6Cards,
+    HoleCards, // Hole cards whose all boards are enumerated
+    Showdowns, // Boards of deals followed by hole cards of their players
+    Count      // Number of workload kinds, new kinds go before it
+};
+
+static constexpr unsigned ShowdownPlayersCount = 6;
+static const uint64_t ShowdownContributions[ShowdownPlayersCount] = { 100, 250, 250, 600, 1000, 1000 };
+
+struct Workload {
+    std::string name;
+    std::string workingSet;
+    std::vector<Hand> hands;
+};
+
+static const char* HandTypesNames[] = {
+    "high-card", "pair", "two-pair", "three-of-a-kind", "straight", "flush", "full-house", "four-of-a-kind", "straight-flush"
+};
+
+static std::vector<Hand> createHands(uint64_t seed, WorkloadKind kind, size_t handsCount) noexcept
+{
+    Random random(seed);
+    std::vector<Hand> hands(handsCount);
+
+    for (size_t i = 0; i < handsCount; i++) {
+        switch (kind) {
+            case WorkloadKind::Holdem7Cards:    hands[i] = getRandomHand(random, 7); break;
+            case WorkloadKind::Holdem5Cards:    hands[i] = getRandomHand(random, 5); break;
+            case WorkloadKind::Holdem6Cards:    hands[i] = getRandomHand(random, 6); break;
+            case WorkloadKind::HoleCards:       hands[i] = getRandomHand(random, 2); break;
+            case WorkloadKind::Showdowns: {
+                size_t dealsCount = handsCount / (ShowdownPlayersCount + 1);
+
+                if (i < dealsCount) {
+                    hands[i] = getRandomHand(random, 5);
+                } else {
+                    size_t deal = (i - dealsCount) / ShowdownPlayersCount;
+                    Hand usedCards = hands[deal];
+
+                    for (size_t player = dealsCount + deal * ShowdownPlayersCount; player < i; player++) {
+                        usedCards |= hands[player];
+                    }
+
+                    hands[i] = getRandomHand(random, 2, usedCards);
+                }
+                break;
+            }
+            case WorkloadKind::ShortDeck7Cards: hands[i] = getRandomHand(random, 7, ShortDeckExcludedCards); break;
+            case WorkloadKind::ShortDeck5Cards: hands[i] = getRandomHand(random, 5, ShortDeckExcludedCards); break;
+            case WorkloadKind::Boards:          hands[i] = getRandomHand(random, 5); break;
+            case WorkloadKind::Omaha:
+                hands[i] = getRandomHand(random, (i % 2 == 0) ? 4 : 5, (i % 2 == 0) ? Hand(0) : hands[i - 1]);
+                break;
+            case WorkloadKind::Count: break;
+        }
+    }
+
+    return hands;
+}
+
+static std::vector<Workload> createWorkloads(const Options& options, WorkloadKind kind) noexcept
+{
+    // Sizes of hands arrays that fit L1 and L2 caches and exceed LLC of common CPUs
+    const size_t l1HandsCount = 16 * 1024 / sizeof(Hand);
+    const size_t l2HandsCount = 256 * 1024 / sizeof(Hand);
+    const size_t memoryHandsCount = 64 * 1024 * 1024 / sizeof(Hand);
+    uint64_t seed = options.seed + static_cast<uint64_t>(kind);
+    std::vector<Workload> workloads;
 
-    std::vector<std::chrono::steady_clock::duration> testDurations;
-    std::vector<std::string> testNames;
+    if (kind == WorkloadKind::Boards) {
+        // Every board is evaluated with all hole cards, so few boards are enough
+        workloads.push_back(Workload{"natural", "l1", createHands(seed, kind, options.quick ? 16 : 256)});
+        return workloads;
+    }
 
-    const unsigned iterationsCount = 99999999;
-    const unsigned handsCount = 9999;
-    Hand hands[handsCount];
-    Hand hands5[handsCount];
-    unsigned result = 0;
+    if (kind == WorkloadKind::HoleCards) {
+        // Every hole cards take 2118760 boards
+        workloads.push_back(Workload{"natural", "boards", createHands(seed, kind, options.quick ? 1 : 4)});
+        return workloads;
+    }
 
-    for (unsigned i = 0; i < handsCount; i++) {
-        hands[i] = getRandomHand(7);
-        hands5[i] = getRandomHand(5);
+    if (kind == WorkloadKind::Showdowns) {
+        const size_t dealHandsCount = ShowdownPlayersCount + 1;
+        workloads.push_back(Workload{"natural", "l1", createHands(seed, kind, l1HandsCount / dealHandsCount * dealHandsCount)});
+        workloads.push_back(Workload{"natural", "l2", createHands(seed, kind, l2HandsCount / dealHandsCount * dealHandsCount)});
+        return workloads;
     }
 
-    std::chrono::steady_clock::time_point begin, end;
+    workloads.push_back(Workload{"natural", "l1", createHands(seed, kind, l1HandsCount)});
+    workloads.push_back(Workload{"natural", "l2", createHands(seed, kind, l2HandsCount)});
 
-    for (unsigned i = 0; i < iterationsCount; i++) {
-        result += evaluateHoldem7CardsHand(hands[i % handsCount]);
+    if (!options.quick) {
+        workloads.push_back(Workload{"natural", "memory", createHands(seed, kind, memoryHandsCount)});
     }
 
-    testNames.emplace_back("evaluateHoldemHand 5");
-    begin = std::chrono::steady_clock::now();
+    if (kind == WorkloadKind::Holdem7Cards) {
+        for (unsigned handType = 0; handType <= static_cast<unsigned>(HandType::StraightFulsh); handType++) {
+            Random random(seed + handType + 1);
+            std::vector<Hand> hands(l1HandsCount);
+
+            for (Hand& hand : hands) {
+                hand = getRandomHand(random, static_cast<HandType>(handType));
+            }
 
-    for (unsigned i = 0; i < iterationsCount; i++) {
-        result += evaluateHoldemHand(hands5[i % handsCount], 5);
+            workloads.push_back(Workload{HandTypesNames[handType], "l1", std::move(hands)});
+        }
     }
 
-    end = std::chrono::steady_clock::now();
-    testDurations.push_back(end - begin);
+    return workloads;
+}
+
+// Runs one pass over workload hands and returns number of evaluated hands
+using BenchmarkFunction = std::function<size_t(const std::vector<Hand>& hands)>;
+
+struct Benchmark {
+    std::string name;
+    WorkloadKind kind;
+    BenchmarkFunction function;
+    std::function<void()> setUp;
+    std::function<void()> tearDown;
+};
 
-    testNames.emplace_back("evaluateHoldemHand 7");
-    begin = std::chrono::steady_clock::now();
+template<typename Evaluator>
+static BenchmarkFunction createBenchmarkFunction(Evaluator evaluator)
+{
+    return [evaluator] (const std::vector<Hand>& hands) {
+        for (Hand hand : hands) {
+            uint32_t value = evaluator(hand);
+            doNotOptimize(value);
+        }
+
+        return hands.size();
+    };
+}
+
+static BenchmarkFunction createBatchBenchmarkFunction(void (*evaluator)(const Hand*, uint32_t*, size_t, InstructionSet), InstructionSet instructionSet)
+{
+    auto values = std::make_shared<std::vector<uint32_t>>();
 
-    for (unsigned i = 0; i < iterationsCount; i++) {
-        result += evaluateHoldemHand(hands[i % handsCount], 7);
+    return [evaluator, instructionSet, values] (const std::vector<Hand>& hands) {
+        values->resize(hands.size());
+        evaluator(hands.data(), values->data(), hands.size(), instructionSet);
+        doNotOptimize(values->back());
+
+        return hands.size();
+    };
+}
+
+static std::vector<Hand> getAllHoleCards()
+{
+    std::vector<Hand> allHoleCards(HoleCardsCombinationsCount);
+
+    for (unsigned i = 0; i < HoleCardsCombinationsCount; i++) {
+        allHoleCards[i] = getHoleCardsByIndex(i);
     }
 
-    end = std::chrono::steady_clock::now();
-    testDurations.push_back(end - begin);
+    return allHoleCards;
+}
+
+// Cards of deck without hole cards in increasing order
+static unsigned getDeckCards(Hand holeCards, Hand* cards, unsigned* cardsNumbers) noexcept
+{
+    unsigned cardsCount = 0;
 
-    testNames.emplace_back("evaluateHoldem5CardsHand");
-    begin = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < CardsCount; i++) {
+        Hand card = createCard(i);
 
-    for (unsigned i = 0; i < iterationsCount; i++) {
-        result += evaluateHoldem5CardsHand(hands5[i % handsCount]);
+        if ((holeCards & card) == 0) {
+            cards[cardsCount] = card;
+            cardsNumbers[cardsCount] = i;
+            cardsCount++;
+        }
     }
 
-    end = std::chrono::steady_clock::now();
-    testDurations.push_back(end - begin);
+    return cardsCount;
+}
 
-    testNames.emplace_back("evaluateHoldem7CardsHand");
-    begin = std::chrono::steady_clock::now();
+// Nested loops over all boards where outer loops keep their partial hands
+static size_t enumerateBoards(const std::vector<Hand>& allHoleCards)
+{
+    size_t handsCount = 0;
 
-    for (unsigned i = 0; i < iterationsCount; i++) {
-        result += evaluateHoldem7CardsHand(hands[i % handsCount]);
+    for (Hand holeCards : allHoleCards) {
+        Hand cards[CardsCount];
+        unsigned cardsNumbers[CardsCount];
+        unsigned cardsCount = getDeckCards(holeCards, cards, cardsNumbers);
+
+        for (unsigned b1 = 0; b1 < cardsCount; b1++) {
+            Hand hand1 = holeCards | cards[b1];
+            for (unsigned b2 = b1 + 1; b2 < cardsCount; b2++) {
+                Hand hand2 = hand1 | cards[b2];
+                for (unsigned b3 = b2 + 1; b3 < cardsCount; b3++) {
+                    Hand hand3 = hand2 | cards[b3];
+                    for (unsigned b4 = b3 + 1; b4 < cardsCount; b4++) {
+                        Hand hand4 = hand3 | cards[b4];
+                        for (unsigned b5 = b4 + 1; b5 < cardsCount; b5++) {
+                            uint32_t value = evaluateHoldem7CardsHand(hand4 | cards[b5]);
+                            doNotOptimize(value);
+                            handsCount++;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    return handsCount;
+}
+
+static std::unique_ptr<IncrementalEvaluator> incrementalEvaluator;
+
+static size_t enumerateBoardsIncrementally(const std::vector<Hand>& allHoleCards)
+{
+    const IncrementalEvaluator& evaluator = *incrementalEvaluator;
+    size_t handsCount = 0;
+
+    for (Hand holeCards : allHoleCards) {
+        Hand cards[CardsCount];
+        unsigned cardsNumbers[CardsCount];
+        unsigned cardsCount = getDeckCards(holeCards, cards, cardsNumbers);
+        uint32_t holeState = evaluator.addCards(IncrementalEvaluator::InitialState, holeCards);
+
+        for (unsigned b1 = 0; b1 < cardsCount; b1++) {
+            uint32_t state1 = evaluator.addCard(holeState, cardsNumbers[b1]);
+            for (unsigned b2 = b1 + 1; b2 < cardsCount; b2++) {
+                uint32_t state2 = evaluator.addCard(state1, cardsNumbers[b2]);
+                for (unsigned b3 = b2 + 1; b3 < cardsCount; b3++) {
+                    uint32_t state3 = evaluator.addCard(state2, cardsNumbers[b3]);
+                    for (unsigned b4 = b3 + 1; b4 < cardsCount; b4++) {
+                        uint32_t state4 = evaluator.addCard(state3, cardsNumbers[b4]);
+                        for (unsigned b5 = b4 + 1; b5 < cardsCount; b5++) {
+                            uint32_t value = evaluator.addCard(state4, cardsNumbers[b5]);
+                            doNotOptimize(value);
+                            handsCount++;
+                        }
+                    }
+                }
+            }
+        }
     }
 
-    end = std::chrono::steady_clock::now();
-    testDurations.push_back(end - begin);
+    return handsCount;
+}
+
+// Hands count is number of players hands in all deals
+static size_t resolveShowdownsOneByOne(const std::vector<Hand>& hands)
+{
+    size_t dealsCount = hands.size() / (ShowdownPlayersCount + 1);
+    const Hand* holeCards = hands.data() + dealsCount;
+    uint64_t payouts[ShowdownPlayersCount];
 
-    std::cout << result << std::endl;
-    for (unsigned i = 0; i < testDurations.size(); i++) {
-        std::cout << "Performance " << testNames[i] << " is " << (std::chrono::duration_cast<std::chrono::nanoseconds>(testDurations[i]).count() / iterationsCount) << " ns per hand. It is " <<
-                 iterationsCount * std::chrono::seconds(1) / testDurations[i] << " hands per second" << std::endl;
+    for (size_t deal = 0; deal < dealsCount; deal++) {
+        resolveShowdown(hands[deal], holeCards + deal * ShowdownPlayersCount, ShowdownContributions, ShowdownPlayersCount, payouts);
+        doNotOptimize(payouts[0]);
     }
+
+    return dealsCount * ShowdownPlayersCount;
 }
 
-int main()
+static BenchmarkFunction createShowdownsBenchmarkFunction(InstructionSet instructionSet)
 {
-    pokertools::initializeEvaluator();
-    testPerformance();
+    // Buffers are reused, so repeated passes over the same workload don't allocate
+    auto contributions = std::make_shared<std::vector<uint64_t>>();
+    auto payouts = std::make_shared<std::vector<uint64_t>>();
+
+    return [instructionSet, contributions, payouts] (const std::vector<Hand>& hands) {
+        size_t dealsCount = hands.size() / (ShowdownPlayersCount + 1);
+
+        if (contributions->size() != dealsCount * ShowdownPlayersCount) {
+            contributions->resize(dealsCount * ShowdownPlayersCount);
+            payouts->resize(contributions->size());
+
+            for (size_t i = 0; i < contributions->size(); i++) {
+                (*contributions)[i] = ShowdownContributions[i % ShowdownPlayersCount];
+            }
+        }
+
+        resolveShowdowns(hands.data(), hands.data() + dealsCount, contributions->data(), ShowdownPlayersCount, dealsCount, payouts->data(),
+                         OddChipRule::PlayersOrder, instructionSet);
+        doNotOptimize(payouts->back());
+
+        return dealsCount * ShowdownPlayersCount;
+    };
+}
+
+static std::vector<Benchmark> createBenchmarks()
+{
+    static const std::vector<Hand> allHoleCards = getAllHoleCards();
+
+    std::vector<Benchmark> benchmarks = {
+        { "evaluateHoldemHand 5", WorkloadKind::Holdem5Cards, createBenchmarkFunction([] (Hand hand) { return evaluateHoldemHand(hand, 5); }), nullptr, nullptr },
+        { "evaluateHoldem5CardsHand", WorkloadKind::Holdem5Cards, createBenchmarkFunction(evaluateHoldem5CardsHand), nullptr, nullptr },
+        { "evaluateHoldemHand 6", WorkloadKind::Holdem6Cards, createBenchmarkFunction([] (Hand hand) { return evaluateHoldemHand(hand, 6); }), nullptr, nullptr },
+        { "evaluateHoldem6CardsHand", WorkloadKind::Holdem6Cards, createBenchmarkFunction(evaluateHoldem6CardsHand), nullptr, nullptr },
+        { "evaluateHoldemHand 7", WorkloadKind::Holdem7Cards, createBenchmarkFunction([] (Hand hand) { return evaluateHoldemHand(hand, 7); }), nullptr, nullptr },
+        { "evaluateHoldem7CardsHand", WorkloadKind::Holdem7Cards, createBenchmarkFunction(evaluateHoldem7CardsHand), nullptr, nullptr },
+        { "evaluateHoldem7CardsHand PerfectHash", WorkloadKind::Holdem7Cards, createBenchmarkFunction(evaluateHoldem7CardsHand),
+            [] { initializeEvaluatorEngine(EvaluatorEngine::PerfectHash); }, [] { initializeEvaluatorEngine(EvaluatorEngine::Branching); } },
+        { "evaluateHoldem7CardsHand Packed", WorkloadKind::Holdem7Cards, createBenchmarkFunction(evaluateHoldem7CardsHand),
+            [] { initializeEvaluatorEngine(EvaluatorEngine::Packed); }, [] { initializeEvaluatorEngine(EvaluatorEngine::Branching); } },
+
+        // Tables copied to regular and huge pages memory show TLB impact
+        { "evaluateHoldem7CardsHand copied tables", WorkloadKind::Holdem7Cards, createBenchmarkFunction(evaluateHoldem7CardsHand),
+            [] { initializeEvaluator(); }, deinitializeEvaluator },
+        { "evaluateHoldem7CardsHand huge pages", WorkloadKind::Holdem7Cards, createBenchmarkFunction(evaluateHoldem7CardsHand),
+            [] { initializeEvaluator<HugePagesAllocator<uint8_t>>(); }, deinitializeEvaluator },
+        { "evaluateHoldem7CardsHand Packed huge pages", WorkloadKind::Holdem7Cards, createBenchmarkFunction(evaluateHoldem7CardsHand),
+            [] { initializeEvaluator<HugePagesAllocator<uint8_t>>(); initializeEvaluatorEngine(EvaluatorEngine::Packed); }, deinitializeEvaluator }
+    };
+
+    const char* instructionSetsNames[] = { "Scalar", "AVX2", "AVX-512" };
+
+    for (unsigned instructionSet = 0; instructionSet <= static_cast<unsigned>(getSupportedInstructionSet()); instructionSet++) {
+        benchmarks.push_back({ std::string("evaluateHoldem7CardsHands ") + instructionSetsNames[instructionSet], WorkloadKind::Holdem7Cards,
+                               createBatchBenchmarkFunction(evaluateHoldem7CardsHands, static_cast<InstructionSet>(instructionSet)), nullptr, nullptr });
+        benchmarks.push_back({ std::string("evaluateHoldem6CardsHands ") + instructionSetsNames[instructionSet], WorkloadKind::Holdem6Cards,
+                               createBatchBenchmarkFunction(evaluateHoldem6CardsHands, static_cast<InstructionSet>(instructionSet)), nullptr, nullptr });
+    }
+
+    benchmarks.push_back({ "resolveShowdown 6", WorkloadKind::Showdowns, resolveShowdownsOneByOne, nullptr, nullptr });
+
+    for (unsigned instructionSet = 0; instructionSet <= static_cast<unsigned>(getSupportedInstructionSet()); instructionSet++) {
+        benchmarks.push_back({ std::string("resolveShowdowns 6 ") + instructionSetsNames[instructionSet], WorkloadKind::Showdowns,
+                               createShowdownsBenchmarkFunction(static_cast<InstructionSet>(instructionSet)), nullptr, nullptr });
+    }
+
+    benchmarks.push_back({ "evaluateShortDeck5CardsHand", WorkloadKind::ShortDeck5Cards, createBenchmarkFunction(evaluateShortDeck5CardsHand), nullptr, nullptr });
+    benchmarks.push_back({ "evaluateShortDeck7CardsHand", WorkloadKind::ShortDeck7Cards, createBenchmarkFunction(evaluateShortDeck7CardsHand), nullptr, nullptr });
+    benchmarks.push_back({ "evaluateAceToFiveLowHand 7", WorkloadKind::Holdem7Cards,
+                           createBenchmarkFunction([] (Hand hand) { return evaluateAceToFiveLowHand(hand, 7); }), nullptr, nullptr });
+    benchmarks.push_back({ "evaluateHiLoHand 7", WorkloadKind::Holdem7Cards, createBenchmarkFunction([] (Hand hand) {
+                               HiLoValues values = evaluateHiLoHand(hand, 7);
+                               return values.high + values.low;
+                           }), nullptr, nullptr });
+
+    benchmarks.push_back({ "evaluateOmahaHand 4", WorkloadKind::Omaha, [] (const std::vector<Hand>& hands) {
+        for (size_t i = 0; i + 1 < hands.size(); i += 2) {
+            uint32_t value = evaluateOmahaHand(hands[i], hands[i + 1], 4);
+            doNotOptimize(value);
+        }
+
+        return hands.size() / 2;
+    }, nullptr, nullptr });
+
+    benchmarks.push_back({ "evaluateOmahaHiLoHand 4", WorkloadKind::Omaha, [] (const std::vector<Hand>& hands) {
+        for (size_t i = 0; i + 1 < hands.size(); i += 2) {
+            HiLoValues values = evaluateOmahaHiLoHand(hands[i], hands[i + 1], 4);
+            doNotOptimize(values.high);
+            doNotOptimize(values.low);
+        }
+
+        return hands.size() / 2;
+    }, nullptr, nullptr });
+
+    // All hole cards not intersecting with every board, only evaluated hands are counted
+    benchmarks.push_back({ "evaluateHoldem7CardsHand with board", WorkloadKind::Boards, [] (const std::vector<Hand>& boards) {
+        size_t handsCount = 0;
+
+        for (Hand board : boards) {
+            for (Hand holeCards : allHoleCards) {
+                if ((holeCards & board) == 0) {
+                    uint32_t value = evaluateHoldem7CardsHand(holeCards | board);
+                    doNotOptimize(value);
+                    handsCount++;
+                }
+            }
+        }
+
+        return handsCount;
+    }, nullptr, nullptr });
+
+    benchmarks.push_back({ "evaluateWithBoard", WorkloadKind::Boards, [] (const std::vector<Hand>& boards) {
+        size_t handsCount = 0;
+
+        for (Hand board : boards) {
+            BoardContext context = createBoardContext(board);
+
+            for (Hand holeCards : allHoleCards) {
+                if ((holeCards & board) == 0) {
+                    uint32_t value = evaluateWithBoard(context, holeCards);
+                    doNotOptimize(value);
+                    handsCount++;
+                }
+            }
+        }
+
+        return handsCount;
+    }, nullptr, nullptr });
+
+    benchmarks.push_back({ "evaluateAllWithBoard", WorkloadKind::Boards, [] (const std::vector<Hand>& boards) {
+        std::vector<uint32_t> values(HoleCardsCombinationsCount);
+
+        for (Hand board : boards) {
+            evaluateAllWithBoard(createBoardContext(board), values.data());
+            doNotOptimize(values.back());
+        }
+
+        // Hole cards intersecting with board get value 0 without evaluation
+        return boards.size() * (CardsCount - 5) * (CardsCount - 6) / 2;
+    }, nullptr, nullptr });
+
+    // Table is generated in memory, applications map the file written by pokertools-incremental-table
+    benchmarks.push_back({ "evaluateHoldem7CardsHand boards enumeration", WorkloadKind::HoleCards, enumerateBoards, nullptr, nullptr });
+    benchmarks.push_back({ "IncrementalEvaluator boards enumeration", WorkloadKind::HoleCards, enumerateBoardsIncrementally,
+        [] { incrementalEvaluator.reset(new IncrementalEvaluator(generateIncrementalEvaluatorTable())); }, [] { incrementalEvaluator.reset(); } });
+
+    return benchmarks;
+}
+
+struct BenchmarkResult {
+    std::string name;
+    std::string workload;
+    std::string workingSet;
+    size_t handsCount;
+    double medianNanoseconds;
+    double p99Nanoseconds;
+    double minNanoseconds;
+    double meanNanoseconds;
+    bool hasCounters;
+    PerfCountersValues counters; // Sum for all repetitions
+    double countedHandsCount;
+};
+
+// Nearest rank percentile of sorted values
+static double getPercentile(const std::vector<double>& sortedValues, double percentile) noexcept
+{
+    size_t rank = static_cast<size_t>(std::ceil(percentile / 100 * sortedValues.size()));
+    return sortedValues[std::max<size_t>(rank, 1) - 1];
+}
+
+static BenchmarkResult runBenchmark(const Options& options, const Benchmark& benchmark, const Workload& workload)
+{
+    const std::chrono::steady_clock::duration repetitionDuration = options.quick ? std::chrono::milliseconds(2) : std::chrono::milliseconds(50);
+
+    // Warmup for one repetition duration also finds number of passes per repetition
+    size_t handsPerPass = 0;
+    size_t passesCount = 0;
+    auto warmupBegin = std::chrono::steady_clock::now();
+
+    do {
+        handsPerPass = benchmark.function(workload.hands);
+        passesCount++;
+    } while (std::chrono::steady_clock::now() - warmupBegin < repetitionDuration);
+
+    std::vector<double> nanosecondsPerHand;
+    PerfCounters counters;
+    counters.start();
+
+    for (unsigned repetition = 0; repetition < options.repetitionsCount; repetition++) {
+        auto begin = std::chrono::steady_clock::now();
+
+        for (size_t pass = 0; pass < passesCount; pass++) {
+            benchmark.function(workload.hands);
+        }
+
+        auto end = std::chrono::steady_clock::now();
+        double nanoseconds = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count());
+        nanosecondsPerHand.push_back(nanoseconds / (passesCount * handsPerPass));
+    }
+
+    PerfCountersValues countersValues = counters.stop();
+    std::sort(nanosecondsPerHand.begin(), nanosecondsPerHand.end());
+
+    BenchmarkResult result;
+    result.hasCounters = counters.isAvailable();
+    result.counters = countersValues;
+    result.countedHandsCount = static_cast<double>(options.repetitionsCount) * passesCount * handsPerPass;
+    result.name = benchmark.name;
+    result.workload = workload.name;
+    result.workingSet = workload.workingSet;
+    result.handsCount = handsPerPass;
+    result.medianNanoseconds = getPercentile(nanosecondsPerHand, 50);
+    result.p99Nanoseconds = getPercentile(nanosecondsPerHand, 99);
+    result.minNanoseconds = nanosecondsPerHand.front();
+    result.meanNanoseconds = 0;
+
+    for (double value : nanosecondsPerHand) {
+        result.meanNanoseconds += value / nanosecondsPerHand.size();
+    }
+
+    return result;
+}
+
+static void writeJson(const Options& options, const std::vector<BenchmarkResult>& results)
+{
+    std::ofstream file(options.jsonFileName);
+    const char* instructionSetsNames[] = { "Scalar", "AVX2", "AVX-512" };
+
+    file << std::setprecision(6);
+    file << "{\n";
+    file << "  \"version\": 1,\n";
+    file << "  \"seed\": " << options.seed << ",\n";
+    file << "  \"repetitions\": " << options.repetitionsCount << ",\n";
+    file << "  \"quick\": " << (options.quick ? "true" : "false") << ",\n";
+    file << "  \"instructionSet\": \"" << instructionSetsNames[static_cast<unsigned>(getSupportedInstructionSet())] << "\",\n";
+    file << "  \"results\": [\n";
+
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchmarkResult& result = results[i];
+
+        file << "    {\"name\": \"" << result.name << "\", \"workload\": \"" << result.workload << "\", \"workingSet\": \"" << result.workingSet
+             << "\", \"hands\": " << result.handsCount << ", \"medianNs\": " << result.medianNanoseconds << ", \"p99Ns\": " << result.p99Nanoseconds
+             << ", \"minNs\": " << result.minNanoseconds << ", \"meanNs\": " << result.meanNanoseconds
+             << ", \"handsPerSecond\": " << static_cast<uint64_t>(1e9 / result.medianNanoseconds);
+
+        if (result.hasCounters) {
+            file << ", \"cyclesPerHand\": " << result.counters.cycles / result.countedHandsCount
+                 << ", \"instructionsPerHand\": " << result.counters.instructions / result.countedHandsCount
+                 << ", \"branchMissesPerHand\": " << result.counters.branchMisses / result.countedHandsCount
+                 << ", \"l1dReadMissesPerHand\": " << result.counters.l1dReadMisses / result.countedHandsCount
+                 << ", \"dtlbReadMissesPerHand\": " << result.counters.dtlbReadMisses / result.countedHandsCount;
+        }
+
+        file << "}" << ((i + 1 < results.size()) ? "," : "") << "\n";
+    }
+
+    file << "  ]\n";
+    file << "}\n";
+}
+
+static bool parseOptions(int argc, char** argv, Options& options)
+{
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+
+        if (std::strcmp(argv[i], "--quick") == 0) {
+            options.quick = true;
+            options.repetitionsCount = 3;
+        } else if ((std::strcmp(argv[i], "--filter") == 0) && hasValue) {
+            options.filter = argv[++i];
+        } else if ((std::strcmp(argv[i], "--repetitions") == 0) && hasValue) {
+            options.repetitionsCount = std::max(1, std::atoi(argv[++i]));
+        } else if ((std::strcmp(argv[i], "--seed") == 0) && hasValue) {
+            options.seed = std::strtoull(argv[++i], nullptr, 0);
+        } else if ((std::strcmp(argv[i], "--json") == 0) && hasValue) {
+            options.jsonFileName = argv[++i];
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--quick] [--filter TEXT] [--repetitions N] [--seed N] [--json FILE]" << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    Options options;
+
+    if (!parseOptions(argc, argv, options)) {
+        return 1;
+    }
+
+    std::cout << "Testing performance" << std::endl;
+
+    std::vector<Benchmark> benchmarks = createBenchmarks();
+    std::vector<BenchmarkResult> results;
+    std::vector<std::vector<Workload>> workloads(static_cast<unsigned>(WorkloadKind::Count));
+
+    for (const Benchmark& benchmark : benchmarks) {
+        if (benchmark.name.find(options.filter) == std::string::npos) {
+            continue;
+        }
+
+        std::vector<Workload>& kindWorkloads = workloads[static_cast<unsigned>(benchmark.kind)];
+
+        if (kindWorkloads.empty()) {
+            kindWorkloads = createWorkloads(options, benchmark.kind);
+        }
+
+        if (benchmark.setUp) {
+            benchmark.setUp();
+        }
+
+        for (const Workload& workload : kindWorkloads) {
+            results.push_back(runBenchmark(options, benchmark, workload));
+
+            const BenchmarkResult& result = results.back();
+            std::cout << "Performance " << std::left << std::setw(44) << result.name << std::setw(16) << result.workload << std::setw(7) << result.workingSet
+                      << std::right << std::fixed << std::setprecision(2) << " median " << std::setw(8) << result.medianNanoseconds
+                      << " ns, p99 " << std::setw(8) << result.p99Nanoseconds << " ns per hand" << std::endl;
+
+            if (result.hasCounters) {
+                std::cout << "    per hand: cycles " << result.counters.cycles / result.countedHandsCount
+                          << ", instructions " << result.counters.instructions / result.countedHandsCount
+                          << ", branch misses " << result.counters.branchMisses / result.countedHandsCount
+                          << ", L1D read misses " << result.counters.l1dReadMisses / result.countedHandsCount
+                          << ", DTLB read misses " << result.counters.dtlbReadMisses / result.countedHandsCount << std::endl;
+            }
+        }
+
+        if (benchmark.tearDown) {
+            benchmark.tearDown();
+        }
+    }
+
+    if (!options.jsonFileName.empty()) {
+        writeJson(options, results);
+    }
+
+    return 0;
 }
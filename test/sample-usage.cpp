@@ -18,10 +18,11 @@
 
 /**
  * Evaluates hand and finds strenght of your cards against random opponent
- * hand using sampling (Monte Carlo method).
+ * hand using sampling (Monte Carlo method) and exact enumeration.
  */
 
 #include <pokertools-cpp/evaluators.hpp>
+#include <pokertools-cpp/equity.hpp>
 
 #include <iostream>
 #include <random>
@@ -57,8 +58,6 @@ static Hand getRandomHand(unsigned cardsCount, Hand filter = 0) noexcept
 
 int main()
 {
-    pokertools::initializeEvaluator();
-
     //Hand communityCards =  0b0001110000000000000000000000000000000000000000000000000011000000;
     Hand communityCards = ace_spades | 8_clubs | 9_clubs | king_spades | queen_spades;
     Hand myHoleCards = 10_spades | 8_diamonds;
@@ -96,4 +95,17 @@ int main()
     std::cout << "win   " << (double) winCount / totalCount << "%" << std::endl;
     std::cout << "split " << (double) splitCount / totalCount << "%" << std::endl;
     std::cout << "loose " << (double) looseCount / totalCount << "%" << std::endl;
+
+    Hand opponentHoleCards = UnknownHoleCards;
+    EquityResult exactResult = enumerateEquity(myHoleCards, &opponentHoleCards, 1, communityCards);
+
+    std::cout << "exact equity " << exactResult.equity << " (win " << exactResult.winCount << ", split " << exactResult.tieCount
+              << ", loose " << exactResult.loseCount << ")" << std::endl;
+
+    MonteCarloOptions options;
+    options.targetStandardError = 0.001;
+    MonteCarloEquityResult simulatedResult = simulateEquity(myHoleCards, &opponentHoleCards, 1, communityCards, 0, options);
+
+    std::cout << "simulated equity " << simulatedResult.equity << " +- " << simulatedResult.standardError
+              << " (" << simulatedResult.trialsCount << " trials)" << std::endl;
 }
@@ -0,0 +1,87 @@
+/* pokertools - tools for poker related coding
+ * Copyright (C) 2016 Andriy Lysnevych
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+/**
+ * Builds abstraction file loaded by AbstractionTable. Usage:
+ *
+ *   pokertools-abstraction FILE flop|turn BUCKETS [--bins N] [--iterations N] [--seed N] [--threads N]
+ */
+
+#include <pokertools-cpp/abstraction.hpp>
+#include "common.hpp"
+
+#include <iostream>
+#include <cstring>
+#include <chrono>
+
+using namespace pokertools;
+
+static double getSeconds(std::chrono::steady_clock::time_point begin)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+}
+
+int main(int argc, char** argv)
+{
+    try {
+        unsigned binsCount = 30, iterationsCount = 50, threadsCount = 0;
+        uint64_t seed = 0;
+        bool isValid = (argc >= 4) && (argc % 2 == 0) && ((std::strcmp(argv[2], "flop") == 0) || (std::strcmp(argv[2], "turn") == 0));
+
+        for (int i = 4; isValid && (i < argc); i += 2) {
+            if (std::strcmp(argv[i], "--bins") == 0) {
+                binsCount = static_cast<unsigned>(std::stoul(argv[i + 1]));
+            } else if (std::strcmp(argv[i], "--iterations") == 0) {
+                iterationsCount = static_cast<unsigned>(std::stoul(argv[i + 1]));
+            } else if (std::strcmp(argv[i], "--seed") == 0) {
+                seed = std::stoull(argv[i + 1]);
+            } else if (std::strcmp(argv[i], "--threads") == 0) {
+                threadsCount = static_cast<unsigned>(std::stoul(argv[i + 1]));
+            } else {
+                isValid = false;
+            }
+        }
+
+        if (!isValid) {
+            std::cerr << "Usage: " << argv[0] << " FILE flop|turn BUCKETS [--bins N] [--iterations N] [--seed N] [--threads N]" << std::endl;
+            return 1;
+        }
+
+        unsigned boardCardsCount = (std::strcmp(argv[2], "flop") == 0) ? 3 : 4;
+        unsigned bucketsCount = static_cast<unsigned>(std::stoul(argv[3]));
+
+        auto begin = std::chrono::steady_clock::now();
+        StrengthDistributions distributions = calculateStrengthDistributions(boardCardsCount, binsCount, threadsCount);
+        std::cout << distributions.weights.size() << " distributions calculated in " << getSeconds(begin) << " s" << std::endl;
+
+        begin = std::chrono::steady_clock::now();
+        std::vector<uint16_t> buckets = clusterStrengthDistributions(distributions, bucketsCount, iterationsCount, seed, threadsCount);
+        std::cout << bucketsCount << " buckets clustered in " << getSeconds(begin) << " s" << std::endl;
+
+        begin = std::chrono::steady_clock::now();
+        writeAbstractionFile(argv[1], distributions, buckets, bucketsCount);
+
+        verifyWrittenFile<AbstractionTable>(argv[1]);
+        std::cout << "Abstraction file " << argv[1] << " written in " << getSeconds(begin) << " s" << std::endl;
+    } catch (const std::exception& exception) {
+        std::cerr << "ERROR " << exception.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
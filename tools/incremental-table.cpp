@@ -0,0 +1,54 @@
+/* pokertools - tools for poker related coding
+ * Copyright (C) 2016 Andriy Lysnevych
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+/**
+ * Generates incremental evaluator file loaded by IncrementalEvaluator. Usage:
+ *
+ *   pokertools-incremental-table FILE
+ */
+
+#include <pokertools-cpp/incremental.hpp>
+#include "common.hpp"
+
+#include <iostream>
+#include <chrono>
+
+using namespace pokertools;
+
+int main(int argc, char** argv)
+{
+    if (argc != 2) {
+        std::cerr << "Usage: " << argv[0] << " FILE" << std::endl;
+        return 1;
+    }
+
+    auto begin = std::chrono::steady_clock::now();
+
+    try {
+        writeIncrementalEvaluatorFile(argv[1], generateIncrementalEvaluatorTable());
+        verifyWrittenFile<IncrementalEvaluator>(argv[1]);
+    } catch (const std::exception& exception) {
+        std::cerr << "ERROR " << exception.what() << std::endl;
+        return 1;
+    }
+
+    auto seconds = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now() - begin).count();
+    std::cout << "Incremental evaluator file " << argv[1] << " generated in " << seconds << " s" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,56 @@
+/* pokertools - tools for poker related coding
+ * Copyright (C) 2016 Andriy Lysnevych
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+/**
+ * Generates preflop equity file loaded by PreflopEquityTable. Usage:
+ *
+ *   pokertools-preflop-equity FILE [--threads N]
+ */
+
+#include <pokertools-cpp/preflop.hpp>
+#include "common.hpp"
+
+#include <iostream>
+#include <cstring>
+#include <chrono>
+
+using namespace pokertools;
+
+int main(int argc, char** argv)
+{
+    if ((argc != 2) && !((argc == 4) && (std::strcmp(argv[2], "--threads") == 0))) {
+        std::cerr << "Usage: " << argv[0] << " FILE [--threads N]" << std::endl;
+        return 1;
+    }
+
+    auto begin = std::chrono::steady_clock::now();
+
+    try {
+        unsigned threadsCount = (argc == 4) ? static_cast<unsigned>(std::stoul(argv[3])) : 0;
+        writePreflopEquityFile(argv[1], calculatePreflopEquityShares(threadsCount));
+        verifyWrittenFile<PreflopEquityTable>(argv[1]);
+    } catch (const std::exception& exception) {
+        std::cerr << "ERROR " << exception.what() << std::endl;
+        return 1;
+    }
+
+    auto seconds = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now() - begin).count();
+    std::cout << "Preflop equity file " << argv[1] << " generated in " << seconds << " s" << std::endl;
+
+    return 0;
+}